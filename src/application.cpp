@@ -16,6 +16,7 @@
 #include "screensmodel.h"
 #include "slidesmodel.h"
 #include "slidesqtitem.h"
+#include "slidethumbnailprovider.h"
 
 #ifdef JACK_SUPPORT
 #include <jack/jack.h>
@@ -38,6 +39,9 @@
 #ifdef SAIL_SUPPORT
 #include <sail-common/config.h>
 #endif
+#include <layers/mpvinstancepool.h>
+#include <utils/pathresolver.h>
+#include "restclientpool.h"
 #include <layers/streammodel.h>
 #include "httpclientmodel.h"
 #include "wwsclientmodel.h"
@@ -142,6 +146,10 @@ Application::Application(int &argc, char **argv, const QString &applicationName)
     m_slidesModel(new SlidesModel(this)), 
     m_collection(new KActionCollection(this))
 {
+    // Created here, so its directory watcher is owned by this thread before
+    // the slide load pool resolves paths
+    PathResolver::instance();
+
     m_config = KSharedConfig::openConfig(QStringLiteral("C-Play/cplay.conf"));
     m_shortcuts = new KConfigGroup(m_config, QStringLiteral("Shortcuts"));
     m_schemes = KColorSchemeManager::instance();
@@ -205,6 +213,7 @@ Application::Application(int &argc, char **argv, const QString &applicationName)
     m_engine = new QQmlApplicationEngine(m_app);
     QObject::connect(m_engine, &QQmlApplicationEngine::quit, this, &Application::quitApp);
     QQmlEngine::setObjectOwnership(m_app, QQmlEngine::CppOwnership);
+    m_engine->addImageProvider(SlideThumbnailProvider::Id, new SlideThumbnailProvider());
 
     m_app->installEventFilter(m_appEventFilter.get());
     QObject::connect(m_appEventFilter.get(), &ApplicationEventFilter::applicationInteraction, this, &Application::applicationInteraction);
@@ -265,6 +274,8 @@ int Application::run() {
     QEventLoop loop;
     connect(&renderThread, &QThread::finished, &loop, &QEventLoop::quit);
     renderThread.render();
+    // Created here so it lives on the GUI thread, which receives the request results
+    RestClientPool::instance();
     int returnCode = m_app->exec();
     sgct::Log::Info("Qt Application exited");
     shutdownLayers();
@@ -273,6 +284,12 @@ int Application::run() {
     delete m_slidesModel;
     m_slidesModel = nullptr;
     loop.exec();
+    // Layers of the render thread hand back their mpv leases in its cleanup,
+    // so the pool goes once that thread has ended
+    renderThread.wait();
+    MpvInstancePool::destroy();
+    PathResolver::destroy();
+    RestClientPool::destroy();
     return returnCode;
 }
 
@@ -595,11 +612,15 @@ QString Application::getFileContent(const QString &file) {
 }
 
 QString Application::mimeType(QUrl url) {
-    QMimeDatabase db;
-    QMimeType type = db.mimeTypeForUrl(url);
+    QMimeType type = mimeDatabase().mimeTypeForUrl(url);
     return type.name();
 }
 
+const QMimeDatabase &Application::mimeDatabase() {
+    static const QMimeDatabase db;
+    return db;
+}
+
 bool Application::getFontPath(const std::string& inFontName, std::string& outPath) {
     const QString fontName = QString::fromStdString(inFontName);
     if (m_fontScanResult.familyToPath.contains(fontName)) {
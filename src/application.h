@@ -14,6 +14,7 @@
 #include <QUrl>
 #include <KSharedConfig>
 #include <QElapsedTimer>
+#include <mutex>
 
 class QAbstractItemModel;
 class QAction;
@@ -22,6 +23,7 @@ class QElapsedTimer;
 class QObject;
 class QQmlApplicationEngine;
 class QFontDatabase;
+class QMimeDatabase;
 class QThread;
 class Worker;
 class KAboutData;
@@ -142,6 +144,8 @@ public:
     Q_INVOKABLE static void hideCursor();
     Q_INVOKABLE static void showCursor();
     Q_INVOKABLE static QString mimeType(QUrl url);
+    // Shared by all threads, QMimeDatabase is thread-safe
+    static const QMimeDatabase &mimeDatabase();
 
     bool getFontPath(const std::string& inFontName, std::string& outPath);
     int getFadeDurationCurrentTime(bool restart);
@@ -369,8 +373,12 @@ public:
         bool takeScreenshot;
         std::string screenshotPath;
         bool captureBackBuffer;
+        bool profilerOn;
+        bool profilerOverlay;
+        bool profilerDumpTrace;
         bool mpvNeedSync;
         bool playerControllerNeedSync;
+        int64_t timelineClockMs;
     };
 
     struct ConfigurationVariables {
@@ -379,6 +387,8 @@ public:
         std::string confNodesOnly;
         std::string logLevel;
         std::string logFile;
+        int maxDecoders;
+        int maxIdleDecoders;
     };
 
     SyncHelper();
@@ -452,15 +462,25 @@ public:
         /*takeScreenshot*/ false,
         /*screenshotPath*/ "",
         /*captureBackBuffer*/ false,
+        /*profilerOn*/ false,
+        /*profilerOverlay*/ false,
+        /*profilerDumpTrace*/ false,
         /*mpvNeedSync*/ true,
-        /*playerControllerNeedSync*/ true };
+        /*playerControllerNeedSync*/ true,
+        /*timelineClockMs*/ 0 };
 
     ConfigurationVariables configuration = {
         /*confAll*/ "./data/mpv-conf/default/all.json",
         /*confMasterOnly*/ "./data/mpv-conf/default/master-only.json",
         /*confNodesOnly*/ "./data/mpv-conf/default/nodes-only.json",
         /*logLevel*/ "",
-        /*logFile*/ ""};
+        /*logFile*/ "",
+        /*maxDecoders*/ 0,
+        /*maxIdleDecoders*/ 4};
+
+    // Held by the master while encoding a sync frame. Changes made while holding
+    // it reach the nodes together, in the same sync packet.
+    std::mutex frameMutex;
 
 private:
     static SyncHelper *_instance;
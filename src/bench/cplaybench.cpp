@@ -0,0 +1,585 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+// cplay_bench: benchmarks of hot paths that run without a cluster or window.
+// Results are written as JSON, to compare runs across commits:
+//
+//   cplay_bench [--json results.json] [--filter name] [--label text]
+//               [--samples N] [--image file.png]
+//
+// Each benchmark is timed in a number of samples, and the median and fastest
+// sample are reported in ns per operation.
+//
+// Layer sync benchmarks are added with BUILD_CPLAY_BENCHMARK_LAYERS, and
+// LayersRenderer in a surfaceless EGL context with BUILD_CPLAY_BENCHMARK_EGL.
+
+#include <utils/timelinetrack.h>
+#ifdef WUFFS_SUPPORT
+#include <utils/wuffsimage.h>
+#endif
+#ifdef ZXING_SUPPORT
+#include <utils/qrcodereader.h>
+#include <sgct/opengl.h>
+#endif
+#ifdef NDI_SUPPORT
+#include <ndi/ofxNDI/ofxNDIutils.h>
+#endif
+#ifdef CPLAY_BENCH_LAYERS
+#include <layers/controllayer.h>
+#include <layers/textlayer.h>
+#include <QCoreApplication>
+#endif
+#ifdef CPLAY_BENCH_EGL
+#define EGL_NO_X11
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <layersrenderer.h>
+#include "gridsettings.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <cstring>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string jsonPath;
+    std::string filter;
+    std::string label;
+    std::string imagePath;
+    int samples = 7;
+};
+
+struct Result {
+    std::string name;
+    uint64_t opsPerSample = 0;
+    double medianNsPerOp = 0.0;
+    double minNsPerOp = 0.0;
+};
+
+// The bench does not link Qt, so strings in the JSON output are escaped here
+std::string jsonEscape(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20)
+                out += std::format("\\u{:04x}", static_cast<int>(c));
+            else
+                out += c;
+        }
+    }
+    return out;
+}
+
+// Keeps the optimizer from removing the measured work
+volatile float g_sink = 0.f;
+
+class Bench {
+public:
+    explicit Bench(const Options &options) : m_options(options) {}
+
+    // run() performs ops operations per call
+    void add(const std::string &name, uint64_t ops, const std::function<void()> &run) {
+        if (!m_options.filter.empty() && name.find(m_options.filter) == std::string::npos)
+            return;
+
+        run(); // Warm up caches and lazy state
+        std::vector<double> nsPerOp;
+        for (int s = 0; s < m_options.samples; s++) {
+            auto start = std::chrono::steady_clock::now();
+            run();
+            auto end = std::chrono::steady_clock::now();
+            double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            nsPerOp.push_back(ns / static_cast<double>(ops));
+        }
+        std::sort(nsPerOp.begin(), nsPerOp.end());
+
+        Result r;
+        r.name = name;
+        r.opsPerSample = ops;
+        r.medianNsPerOp = nsPerOp[nsPerOp.size() / 2];
+        r.minNsPerOp = nsPerOp.front();
+        std::cerr << std::format("{:<40} {:12.1f} ns/op (min {:.1f})\n", r.name, r.medianNsPerOp, r.minNsPerOp);
+        m_results.push_back(r);
+    }
+
+    std::string json() const {
+        std::string out = "{\n";
+        out += std::format("  \"label\": \"{}\",\n", jsonEscape(m_options.label));
+        out += std::format("  \"samples\": {},\n", m_options.samples);
+        out += "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < m_results.size(); i++) {
+            const Result &r = m_results[i];
+            out += std::format("    {{\"name\": \"{}\", \"ops\": {}, \"median_ns_per_op\": {:.3f}, \"min_ns_per_op\": {:.3f}}}{}\n",
+                               jsonEscape(r.name), r.opsPerSample, r.medianNsPerOp, r.minNsPerOp, i + 1 < m_results.size() ? "," : "");
+        }
+        out += "  ]\n}\n";
+        return out;
+    }
+
+private:
+    const Options &m_options;
+    std::vector<Result> m_results;
+};
+
+// Keyframes every 500 ms over a minute, alternating easings like a typical slide
+TimelineTrack makeTrack(TimelineEasing easing) {
+    TimelineTrack track;
+    for (int i = 0; i <= 120; i++) {
+        int t = i * 500;
+        float f = static_cast<float>(i);
+        track.alpha.append(t, (i % 2) ? 1.f : 0.25f, easing, glm::vec4(0.3f, 0.1f, 0.7f, 0.9f));
+        track.rotate.append(t, glm::vec3(f * 10.f, f * 25.f, 0.f), easing, glm::vec4(0.3f, 0.1f, 0.7f, 0.9f));
+        track.translate.append(t, glm::vec3(f, 0.f, -f), easing, glm::vec4(0.3f, 0.1f, 0.7f, 0.9f));
+    }
+    return track;
+}
+
+void addTimelineBenchmarks(Bench &bench) {
+    constexpr uint64_t Ops = 100000;
+    const std::pair<const char *, TimelineEasing> easings[] = {
+        {"linear", TimelineEasing::Linear},
+        {"bezier", TimelineEasing::EaseInOut},
+        {"catmullrom", TimelineEasing::CatmullRom}
+    };
+
+    for (const auto &[easingName, easing] : easings) {
+        auto track = std::make_shared<TimelineTrack>(makeTrack(easing));
+
+        // Playback at 60 fps, the segment cursor moves forward
+        bench.add(std::format("timeline_playback_{}", easingName), Ops, [track]() {
+            float sum = 0.f;
+            for (uint64_t i = 0; i < Ops; i++) {
+                int t = static_cast<int>((i * 16) % 60000);
+                sum += track->alpha.evaluate(t);
+                sum += track->evaluateRotate(t).y;
+                sum += track->translate.evaluate(t).x;
+            }
+            g_sink = sum;
+        });
+
+        // Random seeks, falls back to the binary search
+        std::vector<int> times(4096);
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> dist(0, 60000);
+        for (int &t : times)
+            t = dist(rng);
+        bench.add(std::format("timeline_seek_{}", easingName), Ops, [track, times]() {
+            float sum = 0.f;
+            for (uint64_t i = 0; i < Ops; i++) {
+                int t = times[i % times.size()];
+                sum += track->alpha.evaluate(t);
+                sum += track->evaluateRotate(t).y;
+                sum += track->translate.evaluate(t).x;
+            }
+            g_sink = sum;
+        });
+    }
+}
+
+#ifdef WUFFS_SUPPORT
+void addImageBenchmarks(Bench &bench, const Options &options) {
+    if (options.imagePath.empty()) {
+        std::cerr << "Skipping image_decode_wuffs, no --image given\n";
+        return;
+    }
+    std::string path = options.imagePath;
+    bench.add("image_decode_wuffs", 1, [path]() {
+        WuffsImage::Image image;
+        std::string error;
+        if (!WuffsImage::decodeRgbaFile(path, image, &error))
+            std::cerr << "Decode failed: " << error << "\n";
+        g_sink = static_cast<float>(image.width);
+    });
+}
+#endif
+
+#ifdef ZXING_SUPPORT
+void addQRBenchmarks(Bench &bench) {
+    // Frames without a code, the common case while scanning a stream
+    const std::pair<unsigned int, unsigned int> sizes[] = {{1280, 720}, {1920, 1080}};
+    for (const auto &[width, height] : sizes) {
+        auto pixels = std::make_shared<std::vector<unsigned char>>(static_cast<size_t>(width) * height * 4);
+        std::mt19937 rng(7);
+        for (size_t i = 0; i < pixels->size(); i++)
+            (*pixels)[i] = static_cast<unsigned char>((i % 4 == 3) ? 255 : (rng() & 0xFF));
+        auto reader = std::make_shared<QRCodeReader>();
+        bench.add(std::format("qr_scan_bgra_{}x{}", width, height), 1, [reader, pixels, w = width, h = height]() {
+            g_sink = static_cast<float>(reader->scan(pixels->data(), w, h, GL_BGRA).size());
+        });
+    }
+}
+#endif
+
+#ifdef NDI_SUPPORT
+// CPU conversions of NdiLayer::updateFrame for frames that are not BGRA/RGBA.
+// Plane sizes and strides as the NDI SDK delivers a 1080p frame.
+void addNDIBenchmarks(Bench &bench) {
+    constexpr unsigned int Width = 1920;
+    constexpr unsigned int Height = 1080;
+    auto rgba = std::make_shared<std::vector<unsigned char>>(static_cast<size_t>(Width) * Height * 4);
+    auto makeFrame = [](size_t bytes) {
+        auto frame = std::make_shared<std::vector<unsigned char>>(bytes);
+        std::mt19937 rng(3);
+        for (unsigned char &b : *frame)
+            b = static_cast<unsigned char>(rng() & 0xFF);
+        return frame;
+    };
+    const size_t pixels = static_cast<size_t>(Width) * Height;
+
+    auto uyvy = makeFrame(pixels * 2);
+    bench.add("ndi_uyvy_to_rgba_1080p", 1, [uyvy, rgba]() {
+        ofxNDIutils::YUV422_to_RGBA(uyvy->data(), rgba->data(), Width, Height, Width * 2);
+        g_sink = static_cast<float>((*rgba)[0]);
+    });
+
+    auto nv12 = makeFrame(pixels * 3 / 2);
+    bench.add("ndi_nv12_to_rgba_1080p", 1, [nv12, rgba]() {
+        ofxNDIutils::NV12_to_RGBA(nv12->data(), rgba->data(), Width, Height, Width);
+        g_sink = static_cast<float>((*rgba)[0]);
+    });
+
+    auto i420 = makeFrame(pixels * 3 / 2);
+    bench.add("ndi_i420_to_rgba_1080p", 1, [i420, rgba]() {
+        ofxNDIutils::I420_to_RGBA(i420->data(), rgba->data(), Width, Height, false);
+        g_sink = static_cast<float>((*rgba)[0]);
+    });
+
+    // 16 bit Y plane and interleaved UV plane
+    auto p216 = makeFrame(pixels * 4);
+    bench.add("ndi_p216_to_rgba_1080p", 1, [p216, rgba]() {
+        ofxNDIutils::P216_to_RGBA(p216->data(), rgba->data(), Width, Height, Width * 2);
+        g_sink = static_cast<float>((*rgba)[0]);
+    });
+
+    // P216 followed by a 16 bit alpha plane
+    auto pa16 = makeFrame(pixels * 6);
+    bench.add("ndi_pa16_to_rgba_1080p", 1, [pa16, rgba]() {
+        ofxNDIutils::PA16_to_RGBA(pa16->data(), rgba->data(), Width, Height, Width * 2);
+        g_sink = static_cast<float>((*rgba)[0]);
+    });
+}
+#endif
+
+#ifdef CPLAY_BENCH_LAYERS
+// Full and "always" syncs of layers that need no media file or decoder: a text
+// layer on a plane with a keyframe timeline, and a control layer.
+void addLayerSyncBenchmarks(Bench &bench) {
+    constexpr uint64_t Ops = 10000;
+
+    auto text = std::make_shared<TextLayer>();
+    text->setIsMaster(true);
+    text->setTitle("Lower third");
+    text->setText("Welcome to the dome\nTonight: the northern sky");
+    text->setFontSize(72);
+    text->setColor("#FFCC00", 1.f, 0.8f, 0.f);
+    text->setTextureSize(1920, 1080);
+    text->setPlaneSize(glm::vec2(400.f, 225.f), 1);
+    text->setTimeline(std::make_shared<const TimelineTrack>(makeTrack(TimelineEasing::EaseInOut)), TimelinePlayback());
+
+    auto control = std::make_shared<ControlLayer>();
+    control->setIsMaster(true);
+    control->setTitle("Next slide");
+    control->setOperation("slide_next");
+
+    struct LayerCase {
+        const char *name;
+        std::shared_ptr<BaseLayer> master;
+        std::shared_ptr<BaseLayer> node;
+    };
+    const LayerCase layers[] = {
+        {"text", text, std::make_shared<TextLayer>()},
+        {"control", control, std::make_shared<ControlLayer>()}
+    };
+
+    for (const LayerCase &layer : layers) {
+        auto data = std::make_shared<std::vector<std::byte>>();
+        bench.add(std::format("layer_encode_full_{}", layer.name), Ops, [master = layer.master, data]() {
+            for (uint64_t i = 0; i < Ops; i++) {
+                data->clear();
+                master->encodeFull(*data);
+            }
+            g_sink = static_cast<float>(data->size());
+        });
+
+        bench.add(std::format("layer_encode_always_{}", layer.name), Ops, [master = layer.master, data]() {
+            for (uint64_t i = 0; i < Ops; i++) {
+                data->clear();
+                master->encodeAlways(*data);
+            }
+            g_sink = static_cast<float>(data->size());
+        });
+
+        // Into a node side layer, which is not initialized, as on a node before the first frame
+        auto full = std::make_shared<std::vector<std::byte>>();
+        layer.master->encodeFull(*full);
+        bench.add(std::format("layer_decode_full_{}", layer.name), Ops, [node = layer.node, full]() {
+            unsigned int pos = 0;
+            for (uint64_t i = 0; i < Ops; i++) {
+                pos = 0;
+                node->decodeFull(*full, pos);
+            }
+            g_sink = static_cast<float>(pos);
+        });
+    }
+}
+#endif
+
+#ifdef CPLAY_BENCH_EGL
+// Layer with a generated texture, in place of a decoded video frame or image
+class GeneratedLayer : public BaseLayer {
+public:
+    GeneratedLayer(unsigned int texId, int width, int height) {
+        renderData.texId = texId;
+        renderData.width = width;
+        renderData.height = height;
+    }
+
+    bool ready() const override {
+        return true;
+    }
+
+    bool hasTexture() const override {
+        return true;
+    }
+};
+
+// OpenGL 4.1 core context without any surface, for headless machines
+class SurfacelessContext {
+public:
+    ~SurfacelessContext() {
+        if (m_display == EGL_NO_DISPLAY)
+            return;
+        eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (m_context != EGL_NO_CONTEXT)
+            eglDestroyContext(m_display, m_context);
+        eglTerminate(m_display);
+    }
+
+    bool create() {
+#ifdef EGL_MESA_platform_surfaceless
+        m_display = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+#endif
+        if (m_display == EGL_NO_DISPLAY)
+            m_display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (m_display == EGL_NO_DISPLAY || !eglInitialize(m_display, nullptr, nullptr)) {
+            m_display = EGL_NO_DISPLAY;
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API))
+            return false;
+
+        // Surface type 0 matches every config, the surfaceless platform has no window configs
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, 0,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+        };
+        EGLConfig config;
+        EGLint numConfigs = 0;
+        if (!eglChooseConfig(m_display, configAttribs, &config, 1, &numConfigs) || numConfigs < 1)
+            return false;
+
+        const EGLint contextAttribs[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 4,
+            EGL_CONTEXT_MINOR_VERSION, 1,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_NONE
+        };
+        m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, contextAttribs);
+        if (m_context == EGL_NO_CONTEXT || !eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context))
+            return false;
+
+        return gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress)) != 0;
+    }
+
+private:
+    EGLDisplay m_display = EGL_NO_DISPLAY;
+    EGLContext m_context = EGL_NO_CONTEXT;
+};
+
+sgct::mat4 toSgct(const glm::mat4 &m) {
+    sgct::mat4 result;
+    std::memcpy(result.values.data(), glm::value_ptr(m), sizeof(float) * 16);
+    return result;
+}
+
+// LayersRenderer::renderLayers of one 4K layer per grid mode, into a 2K cube
+// face as with fisheye output. GridMode::None is not covered, as it draws the
+// screen quad of an opened SGCT window.
+void addRenderBenchmarks(Bench &bench) {
+    constexpr uint64_t Ops = 100;
+    constexpr int TargetSize = 2048;
+    constexpr int SourceWidth = 3840;
+    constexpr int SourceHeight = 2160;
+
+    SurfacelessContext context;
+    if (!context.create()) {
+        std::cerr << "Skipping render_layers, no surfaceless EGL context\n";
+        return;
+    }
+
+    GLuint targetTex = 0, depthBuffer = 0, fbo = 0;
+    glGenTextures(1, &targetTex);
+    glBindTexture(GL_TEXTURE_2D, targetTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, TargetSize, TargetSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, TargetSize, TargetSize);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, targetTex, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    glViewport(0, 0, TargetSize, TargetSize);
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(SourceWidth) * SourceHeight * 4);
+    std::mt19937 rng(11);
+    for (unsigned char &p : pixels)
+        p = static_cast<unsigned char>(rng() & 0xFF);
+    GLuint sourceTex = 0;
+    glGenTextures(1, &sourceTex);
+    glBindTexture(GL_TEXTURE_2D, sourceTex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, SourceWidth, SourceHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    auto renderer = std::make_shared<LayersRenderer>();
+    renderer->initializeGL(GridSettings::surfaceRadius(), GridSettings::surfaceFov());
+
+    // RenderData refers to a window and viewport, the window is never opened
+    sgct::config::Window windowConfig;
+    windowConfig.size = sgct::ivec2{ TargetSize, TargetSize };
+    windowConfig.viewports.emplace_back();
+    auto window = std::make_shared<sgct::Window>(windowConfig);
+
+    // Looking towards the dome tilt, 90 degrees as one cube face
+    const glm::mat4 projection = glm::perspective(glm::radians(90.f), 1.f, 0.1f, 100.f);
+    const glm::mat4 view = glm::rotate(glm::mat4(1.f), glm::radians(-90.f), glm::vec3(1.f, 0.f, 0.f));
+    const glm::mat4 model = glm::mat4(1.f);
+    auto data = std::make_shared<sgct::RenderData>(*window, *window->viewports().front(), sgct::FrustumMode::Mono,
+        toSgct(model), toSgct(view), toSgct(projection), toSgct(projection * view * model), sgct::ivec2{ TargetSize, TargetSize });
+
+    const std::pair<const char *, BaseLayer::GridMode> gridModes[] = {
+        {"plane", BaseLayer::GridMode::Plane},
+        {"dome", BaseLayer::GridMode::Dome},
+        {"sphere_eqr", BaseLayer::GridMode::Sphere_EQR},
+        {"sphere_eac", BaseLayer::GridMode::Sphere_EAC}
+    };
+    for (const auto &[modeName, gridMode] : gridModes) {
+        auto layer = std::make_shared<GeneratedLayer>(sourceTex, SourceWidth, SourceHeight);
+        layer->setGridMode(gridMode);
+        layer->setPlaneDistance(500.0);
+        layer->setPlaneSize(glm::vec2(400.f, 225.f), 1);
+        renderer->clearLayers();
+        renderer->addLayer(layer);
+
+        // glFinish, so the GPU time is measured and not only the submission
+        bench.add(std::format("render_layers_{}", modeName), Ops, [renderer, window, data]() {
+            for (uint64_t i = 0; i < Ops; i++) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                renderer->renderLayers(*data, 0, 0.f);
+            }
+            glFinish();
+            g_sink = static_cast<float>(glGetError());
+        });
+    }
+
+    renderer->clearLayers();
+    renderer.reset();
+    glDeleteTextures(1, &sourceTex);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &depthBuffer);
+    glDeleteTextures(1, &targetTex);
+}
+#endif
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        }
+        else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        }
+        else if (arg == "--label" && hasValue) {
+            options.label = argv[++i];
+        }
+        else if (arg == "--image" && hasValue) {
+            options.imagePath = argv[++i];
+        }
+        else if (arg == "--samples" && hasValue) {
+            options.samples = std::max(1, std::stoi(argv[++i]));
+        }
+        else {
+            std::cerr << "Usage: cplay_bench [--json file] [--filter name] [--label text] [--samples N] [--image file]\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+#ifdef CPLAY_BENCH_LAYERS
+    // Settings read by the layers
+    QCoreApplication app(argc, argv);
+#endif
+
+    Bench bench(options);
+    addTimelineBenchmarks(bench);
+#ifdef WUFFS_SUPPORT
+    addImageBenchmarks(bench, options);
+#endif
+#ifdef ZXING_SUPPORT
+    addQRBenchmarks(bench);
+#endif
+#ifdef NDI_SUPPORT
+    addNDIBenchmarks(bench);
+#endif
+#ifdef CPLAY_BENCH_LAYERS
+    addLayerSyncBenchmarks(bench);
+#endif
+#ifdef CPLAY_BENCH_EGL
+    addRenderBenchmarks(bench);
+#endif
+
+    std::string json = bench.json();
+    if (options.jsonPath.empty()) {
+        std::cout << json;
+    }
+    else {
+        std::ofstream out(options.jsonPath, std::ofstream::out | std::ofstream::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Could not write " << options.jsonPath << "\n";
+            return EXIT_FAILURE;
+        }
+        out << json;
+    }
+    return EXIT_SUCCESS;
+}
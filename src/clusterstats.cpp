@@ -0,0 +1,177 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "clusterstats.h"
+#include <QJsonArray>
+#include <sgct/sgct.h>
+#include <utils/syncpayload.h>
+#include <algorithm>
+
+// A node without a report for this long is shown as stale
+static constexpr int64_t StaleReportMs = 2000;
+
+ClusterStats &ClusterStats::instance() {
+    static ClusterStats stats;
+    return stats;
+}
+
+void ClusterStats::recordEncode(uint64_t frame, const EncodeSizes &sizes, double encodeMs) {
+    EncodeFrame f;
+    f.frame = frame;
+    f.time = std::chrono::steady_clock::now();
+    f.sizes = sizes;
+    f.encodeMs = encodeMs;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_encodeFrames.size() < EncodeWindow) {
+        m_encodeFrames.push_back(f);
+    }
+    else {
+        m_encodeFrames[m_nextEncodeFrame] = f;
+        m_nextEncodeFrame = (m_nextEncodeFrame + 1) % EncodeWindow;
+    }
+    m_totalBytes += sizes.sent;
+    m_lastFrame = frame;
+}
+
+void ClusterStats::recordNodeReport(int clientIndex, const void *data, int length, uint64_t masterFrame) {
+    if (!data || length <= 0)
+        return;
+
+    const std::byte *bytes = static_cast<const std::byte *>(data);
+    std::vector<std::byte> report(bytes, bytes + length);
+    unsigned int pos = 0;
+    int nodeId = -1;
+    uint64_t frame = 0;
+    float decodeAvg = 0.f, decodeMax = 0.f, applyAvg = 0.f, applyMax = 0.f;
+    constexpr size_t ReportSize = sizeof(nodeId) + sizeof(frame) + 4 * sizeof(float);
+    if (report.size() < ReportSize)
+        return;
+    sgct::deserializeObject(report, pos, nodeId);
+    sgct::deserializeObject(report, pos, frame);
+    sgct::deserializeObject(report, pos, decodeAvg);
+    sgct::deserializeObject(report, pos, decodeMax);
+    sgct::deserializeObject(report, pos, applyAvg);
+    sgct::deserializeObject(report, pos, applyMax);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    NodeStats &node = m_nodes[clientIndex];
+    node.nodeId = nodeId;
+    node.connected = true;
+    node.hasReport = true;
+    node.frame = frame;
+    node.lagFrames = static_cast<int64_t>(masterFrame) - static_cast<int64_t>(frame);
+    node.decodeAvgMs = decodeAvg;
+    node.decodeMaxMs = decodeMax;
+    node.applyAvgMs = applyAvg;
+    node.applyMaxMs = applyMax;
+    node.reportTime = std::chrono::steady_clock::now();
+}
+
+void ClusterStats::setNodeConnected(int clientIndex, bool connected) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_nodes[clientIndex].connected = connected;
+}
+
+QJsonObject ClusterStats::toJson() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto now = std::chrono::steady_clock::now();
+
+    QJsonObject sync;
+    size_t frames = m_encodeFrames.size();
+    if (frames > 0) {
+        double globals = 0.0, layerFull = 0.0, layerAlways = 0.0, sent = 0.0, encodeMs = 0.0;
+        size_t maxBytes = 0;
+        double maxEncodeMs = 0.0;
+        auto first = m_encodeFrames.front().time;
+        auto last = first;
+        for (const EncodeFrame &f : m_encodeFrames) {
+            globals += static_cast<double>(f.sizes.globals);
+            layerFull += static_cast<double>(f.sizes.layerFull);
+            layerAlways += static_cast<double>(f.sizes.layerAlways);
+            sent += static_cast<double>(f.sizes.sent);
+            encodeMs += f.encodeMs;
+            maxBytes = std::max(maxBytes, f.sizes.globals + f.sizes.layerFull + f.sizes.layerAlways);
+            maxEncodeMs = std::max(maxEncodeMs, f.encodeMs);
+            first = std::min(first, f.time);
+            last = std::max(last, f.time);
+        }
+        const double n = static_cast<double>(frames);
+        const double total = globals + layerFull + layerAlways;
+        std::chrono::duration<double> span = last - first;
+
+        sync[QStringLiteral("frames")] = static_cast<qint64>(frames);
+        sync[QStringLiteral("bytes_per_frame_avg")] = total / n;
+        sync[QStringLiteral("bytes_per_frame_max")] = static_cast<qint64>(maxBytes);
+        // Frames in the window are span long, plus one frame interval
+        sync[QStringLiteral("bytes_per_second")] = (frames > 1 && span.count() > 0.0) ? total * (n - 1.0) / n / span.count() : 0.0;
+        sync[QStringLiteral("globals_bytes_avg")] = globals / n;
+        sync[QStringLiteral("layer_full_bytes_avg")] = layerFull / n;
+        sync[QStringLiteral("layer_always_bytes_avg")] = layerAlways / n;
+        sync[QStringLiteral("sent_bytes_per_frame_avg")] = sent / n;
+        sync[QStringLiteral("encode_ms_avg")] = encodeMs / n;
+        sync[QStringLiteral("encode_ms_max")] = maxEncodeMs;
+    }
+    sync[QStringLiteral("total_bytes")] = static_cast<qint64>(m_totalBytes);
+    sync[QStringLiteral("compression")] = SyncPayload::compressionAvailable() ? QStringLiteral("zstd") : QStringLiteral("none");
+
+    QJsonArray nodes;
+    for (const auto &[clientIndex, node] : m_nodes) {
+        QJsonObject n;
+        n[QStringLiteral("client")] = clientIndex;
+        n[QStringLiteral("node")] = node.nodeId;
+        n[QStringLiteral("connected")] = node.connected;
+        if (node.hasReport) {
+            int64_t ageMs = std::chrono::duration_cast<std::chrono::milliseconds>(now - node.reportTime).count();
+            n[QStringLiteral("frame")] = static_cast<qint64>(node.frame);
+            n[QStringLiteral("lag_frames")] = static_cast<qint64>(node.lagFrames);
+            n[QStringLiteral("decode_ms_avg")] = node.decodeAvgMs;
+            n[QStringLiteral("decode_ms_max")] = node.decodeMaxMs;
+            n[QStringLiteral("apply_ms_avg")] = node.applyAvgMs;
+            n[QStringLiteral("apply_ms_max")] = node.applyMaxMs;
+            n[QStringLiteral("report_age_ms")] = static_cast<qint64>(ageMs);
+            n[QStringLiteral("stale")] = ageMs > StaleReportMs;
+        }
+        nodes.append(n);
+    }
+
+    QJsonObject stats;
+    stats[QStringLiteral("frame")] = static_cast<qint64>(m_lastFrame);
+    stats[QStringLiteral("sync")] = sync;
+    stats[QStringLiteral("nodes")] = nodes;
+    return stats;
+}
+
+void ClusterStats::addNodeTime(NodePhase phase, double ms) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    PhaseTime &t = (phase == Decode) ? m_decode : m_apply;
+    t.sumMs += ms;
+    t.maxMs = std::max(t.maxMs, ms);
+    t.count++;
+}
+
+bool ClusterStats::takeNodeReport(uint64_t frame, int nodeId, std::vector<std::byte> &data) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (frame < m_lastReportFrame + NodeReportInterval)
+        return false;
+    m_lastReportFrame = frame;
+
+    auto average = [](const PhaseTime &t) {
+        return t.count > 0 ? static_cast<float>(t.sumMs / t.count) : 0.f;
+    };
+    data.clear();
+    sgct::serializeObject(data, nodeId);
+    sgct::serializeObject(data, frame);
+    sgct::serializeObject(data, average(m_decode));
+    sgct::serializeObject(data, static_cast<float>(m_decode.maxMs));
+    sgct::serializeObject(data, average(m_apply));
+    sgct::serializeObject(data, static_cast<float>(m_apply.maxMs));
+
+    m_decode = PhaseTime();
+    m_apply = PhaseTime();
+    return true;
+}
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef CLUSTERSTATS_H
+#define CLUSTERSTATS_H
+
+#include <QJsonObject>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Sync bandwidth and node health, served on /cluster_stats and in the Cluster settings page.
+//
+// The master records the size of every encoded sync payload, split into global
+// variables (including the layer framing), full layer syncs and "always" layer
+// syncs, and the size actually sent after compression. Nodes take the decode
+// and postSyncPreDraw (apply) times from their FrameProfiler scopes, and send a
+// report to the master every NodeReportInterval frames over the SGCT data
+// transfer connection. That connection only exists when the nodes have a
+// "dataTransferPort" in the cluster configuration.
+class ClusterStats {
+public:
+    static constexpr int NodeReportPackageId = 4701;
+    static constexpr uint64_t NodeReportInterval = 30;
+    // Frames kept for the master averages
+    static constexpr size_t EncodeWindow = 120;
+
+    struct EncodeSizes {
+        size_t globals = 0;
+        size_t layerFull = 0;
+        size_t layerAlways = 0;
+        // Frame size on the wire, after framing and compression
+        size_t sent = 0;
+    };
+
+    enum NodePhase {
+        Decode,
+        Apply
+    };
+
+    static ClusterStats &instance();
+
+    // Master
+    void recordEncode(uint64_t frame, const EncodeSizes &sizes, double encodeMs);
+    void recordNodeReport(int clientIndex, const void *data, int length, uint64_t masterFrame);
+    void setNodeConnected(int clientIndex, bool connected);
+    QJsonObject toJson() const;
+
+    // Node
+    void addNodeTime(NodePhase phase, double ms);
+    // Fills data with a report every NodeReportInterval frames
+    bool takeNodeReport(uint64_t frame, int nodeId, std::vector<std::byte> &data);
+
+private:
+    ClusterStats() = default;
+
+    struct EncodeFrame {
+        uint64_t frame = 0;
+        std::chrono::steady_clock::time_point time;
+        EncodeSizes sizes;
+        double encodeMs = 0.0;
+    };
+
+    struct NodeStats {
+        int nodeId = -1;
+        bool connected = false;
+        bool hasReport = false;
+        uint64_t frame = 0;
+        int64_t lagFrames = 0;
+        float decodeAvgMs = 0.f;
+        float decodeMaxMs = 0.f;
+        float applyAvgMs = 0.f;
+        float applyMaxMs = 0.f;
+        std::chrono::steady_clock::time_point reportTime;
+    };
+
+    struct PhaseTime {
+        double sumMs = 0.0;
+        double maxMs = 0.0;
+        uint32_t count = 0;
+    };
+
+    mutable std::mutex m_mutex;
+
+    std::vector<EncodeFrame> m_encodeFrames;
+    size_t m_nextEncodeFrame = 0;
+    uint64_t m_totalBytes = 0;
+    uint64_t m_lastFrame = 0;
+    std::map<int, NodeStats> m_nodes;
+
+    PhaseTime m_decode;
+    PhaseTime m_apply;
+    uint64_t m_lastReportFrame = 0;
+};
+
+#endif // CLUSTERSTATS_H
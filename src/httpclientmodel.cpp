@@ -6,6 +6,7 @@
  */
 
 #include "httpclientmodel.h"
+#include "restclientpool.h"
 #ifdef OPENSSL_SUPPORT
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #endif
@@ -15,15 +16,43 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QPointer>
 
 #pragma warning(disable : 4996)
 
 // --- HttpRequestWorker implementation ---
 
+// Most setups talk to a handful of devices, so this is plenty
+static constexpr size_t MaxKeepAliveClients = 32;
+
 HttpRequestWorker::HttpRequestWorker(QObject *parent)
     : QObject(parent) {
 }
 
+HttpRequestWorker::~HttpRequestWorker() {
+}
+
+httplib::Client &HttpRequestWorker::client(const std::string &hostPort) {
+    auto it = m_clients.find(hostPort);
+    if (it != m_clients.end()) {
+        return *it->second;
+    }
+
+    if (m_clients.size() >= MaxKeepAliveClients) {
+        m_clients.clear();
+    }
+
+    auto cli = std::make_unique<httplib::Client>(hostPort);
+    cli->set_keep_alive(true);
+    cli->set_follow_location(true);
+    cli->set_address_family(AF_INET);
+    cli->set_default_headers({
+        {"User-Agent", "C-Play/2.3"},
+        {"Accept", "*/*"}
+    });
+    return *m_clients.emplace(hostPort, std::move(cli)).first->second;
+}
+
 void HttpRequestWorker::doRequest(const QString &url, int method,
                                   const QString &parameters, bool ignoreStatus) {
     int statusCode = 0;
@@ -70,17 +99,10 @@ void HttpRequestWorker::doRequest(const QString &url, int method,
             }
         }
 
-        httplib::Client cli(hostPort);
+        httplib::Client &cli = client(hostPort);
         cli.set_connection_timeout(3, 0);
         cli.set_read_timeout(5, 0);
         cli.set_write_timeout(5, 0);
-        cli.set_keep_alive(true);
-        cli.set_follow_location(true);
-        cli.set_address_family(AF_INET);
-        cli.set_default_headers({
-            {"User-Agent", "C-Play/2.3"},
-            {"Accept", "*/*"}
-        });
 
         // Build httplib::Params from the parameters string.
         // Parameters are stored as a JSON array: [{"name":"key","value":"val"}, ...]
@@ -212,19 +234,9 @@ void HttpRequestWorker::doRequest(const QString &url, int method,
 
 HttpClientModel::HttpClientModel(QObject *parent)
     : QAbstractListModel(parent) {
-    m_worker = new HttpRequestWorker();
-    m_worker->moveToThread(&m_workerThread);
-
-    connect(&m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
-    connect(this, &HttpClientModel::startRequest, m_worker, &HttpRequestWorker::doRequest);
-    connect(m_worker, &HttpRequestWorker::requestFinished, this, &HttpClientModel::onRequestFinished);
-
-    m_workerThread.start();
 }
 
 HttpClientModel::~HttpClientModel() {
-    m_workerThread.quit();
-    m_workerThread.wait();
 }
 
 int HttpClientModel::rowCount(const QModelIndex &parent) const {
@@ -342,7 +354,12 @@ void HttpClientModel::sendRequest(const QString &url, int method,
                                   bool ignoreStatus) {
     m_requestInProgress = true;
     Q_EMIT requestInProgressChanged();
-    Q_EMIT startRequest(url, method, parameters, ignoreStatus);
+    QPointer<HttpClientModel> model(this);
+    RestClientPool::instance().sendHttpRequest(url, method, parameters, ignoreStatus,
+        [model](int statusCode, const QString &responseBody, const QString &error) {
+            if (model)
+                model->onRequestFinished(statusCode, responseBody, error);
+        });
 }
 
 void HttpClientModel::onRequestFinished(int statusCode, const QString &responseBody, const QString &error) {
@@ -11,12 +11,20 @@
 #include <QAbstractListModel>
 #include <QThread>
 #include <QtQml/qqmlregistration.h>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace httplib {
+class Client;
+}
 
 class HttpRequestWorker : public QObject {
     Q_OBJECT
 
 public:
     explicit HttpRequestWorker(QObject *parent = nullptr);
+    ~HttpRequestWorker();
 
 public Q_SLOTS:
     void doRequest(const QString &url, int method,
@@ -24,6 +32,11 @@ public Q_SLOTS:
 
 Q_SIGNALS:
     void requestFinished(int statusCode, const QString &responseBody, const QString &error);
+
+private:
+    // Clients are kept per scheme://host:port, so keep-alive connections are reused between requests
+    httplib::Client &client(const std::string &hostPort);
+    std::map<std::string, std::unique_ptr<httplib::Client>> m_clients;
 };
 
 class HttpClientModel : public QAbstractListModel {
@@ -90,8 +103,6 @@ Q_SIGNALS:
     void commandsListChanged();
     void responseChanged();
     void requestInProgressChanged();
-    void startRequest(const QString &url, int method,
-                      const QString &parameters, bool ignoreStatus);
 
 private Q_SLOTS:
     void onRequestFinished(int statusCode, const QString &responseBody, const QString &error);
@@ -109,9 +120,6 @@ private:
     int m_lastStatusCode = 0;
     QString m_lastError;
     bool m_requestInProgress = false;
-
-    QThread m_workerThread;
-    HttpRequestWorker *m_worker = nullptr;
 };
 
 #endif // HTTPCLIENTMODEL_H
@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "httpservermetrics.h"
+#include <format>
+
+void HttpServerMetrics::record(const std::string &method, const std::string &route, int status, double seconds) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    RouteMetrics &metrics = m_routes[std::make_pair(route, method)];
+    metrics.countPerStatus[status]++;
+    metrics.count++;
+    metrics.sumSeconds += seconds;
+    for (size_t i = 0; i < BucketBounds.size(); i++) {
+        if (seconds <= BucketBounds[i])
+            metrics.buckets[i]++;
+    }
+}
+
+std::string HttpServerMetrics::toPrometheus() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string out;
+
+    out += "# HELP cplay_http_requests_total Number of HTTP requests handled.\n";
+    out += "# TYPE cplay_http_requests_total counter\n";
+    for (const auto &[key, metrics] : m_routes) {
+        for (const auto &[status, count] : metrics.countPerStatus) {
+            out += std::format("cplay_http_requests_total{{route=\"{}\",method=\"{}\",status=\"{}\"}} {}\n", key.first, key.second, status, count);
+        }
+    }
+
+    out += "# HELP cplay_http_request_duration_seconds Time spent handling HTTP requests.\n";
+    out += "# TYPE cplay_http_request_duration_seconds histogram\n";
+    for (const auto &[key, metrics] : m_routes) {
+        std::string labels = std::format("route=\"{}\",method=\"{}\"", key.first, key.second);
+        for (size_t i = 0; i < BucketBounds.size(); i++) {
+            out += std::format("cplay_http_request_duration_seconds_bucket{{{},le=\"{}\"}} {}\n", labels, BucketBounds[i], metrics.buckets[i]);
+        }
+        out += std::format("cplay_http_request_duration_seconds_bucket{{{},le=\"+Inf\"}} {}\n", labels, metrics.count);
+        out += std::format("cplay_http_request_duration_seconds_sum{{{}}} {}\n", labels, metrics.sumSeconds);
+        out += std::format("cplay_http_request_duration_seconds_count{{{}}} {}\n", labels, metrics.count);
+    }
+    return out;
+}
@@ -0,0 +1,37 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef HTTPSERVERMETRICS_H
+#define HTTPSERVERMETRICS_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+// Request counts and latencies per route, exposed in Prometheus text format on /metrics.
+class HttpServerMetrics {
+public:
+    void record(const std::string &method, const std::string &route, int status, double seconds);
+    std::string toPrometheus() const;
+
+private:
+    static constexpr std::array<double, 11> BucketBounds = { 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0 };
+
+    struct RouteMetrics {
+        std::map<int, uint64_t> countPerStatus;
+        std::array<uint64_t, BucketBounds.size()> buckets = {};
+        uint64_t count = 0;
+        double sumSeconds = 0.0;
+    };
+
+    mutable std::mutex m_mutex;
+    std::map<std::pair<std::string, std::string>, RouteMetrics> m_routes;
+};
+
+#endif // HTTPSERVERMETRICS_H
@@ -0,0 +1,420 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "httpserverstate.h"
+#include "mpvobject.h"
+#include "slidesmodel.h"
+#include "layersmodel.h"
+#include "layers/baselayer.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <algorithm>
+#include <format>
+
+// Cached lists per presentation or media. Requests with unusual charsPerItem
+// values are formatted on demand instead of growing the cache forever.
+static constexpr size_t MaxCachedTexts = 256;
+
+// Lists in the media text cache. The presentation cache is keyed by slide index.
+enum MediaList {
+    PlaylistList,
+    SectionsList,
+    AudioTracksList,
+    AudioTracksNoPrefixList
+};
+
+// Pads or shortens title, so title and suffix together are charsPerItem wide
+static std::string fitItem(std::string title, const std::string &suffix, size_t charsPerItem) {
+    size_t countChars = title.size() + suffix.size();
+    if (countChars < charsPerItem) {
+        title.insert(title.end(), charsPerItem - countChars, ' ');
+    }
+    else if (charsPerItem > 4) {
+        title.erase(title.end() - std::min(title.size(), countChars - charsPerItem + 4), title.end());
+        title.insert(title.end(), 3, '.');
+        title.insert(title.end(), 1, ' ');
+    }
+    return title + suffix;
+}
+
+static std::string formatItemList(const std::vector<std::string> &titles, size_t charsPerItem) {
+    std::string fullItemList = "";
+    for (size_t i = 0; i < titles.size(); i++) {
+        fullItemList += fitItem(std::to_string(i + 1) + ". " + titles[i], "", charsPerItem);
+        if (i < titles.size() - 1)
+            fullItemList += "\n";
+    }
+    return fullItemList;
+}
+
+static std::string formatItemList(const std::vector<std::pair<std::string, std::string>> &items, size_t charsPerItem) {
+    std::string fullItemList = "";
+    for (size_t i = 0; i < items.size(); i++) {
+        fullItemList += fitItem(std::to_string(i + 1) + ". " + items[i].first, items[i].second, charsPerItem);
+        if (i < items.size() - 1)
+            fullItemList += "\n";
+    }
+    return fullItemList;
+}
+
+static HttpServerState::Layer captureLayer(BaseLayer *layer) {
+    HttpServerState::Layer l;
+    if (!layer)
+        return l;
+
+    l.title = layer->title();
+    l.volume = layer->volume();
+    l.visibility = static_cast<int>(layer->alpha() * 100.f);
+    l.planeAzimuth = layer->planeAzimuth();
+    l.planeElevation = layer->planeElevation();
+    l.planeRoll = layer->planeRoll();
+    l.planeDistance = layer->planeDistance();
+    l.planeHorizontal = layer->planeHorizontal();
+    l.planeVertical = layer->planeVertical();
+    if (layer->hasSubLayers()) {
+        for (const auto &sub : layer->getSubLayers()) {
+            if (sub)
+                l.subLayers.push_back(captureLayer(sub.get()));
+        }
+    }
+    return l;
+}
+
+static bool sameLayer(const HttpServerState::Layer &l, BaseLayer *layer) {
+    if (!layer)
+        return l.title.empty() && l.subLayers.empty();
+
+    if (l.volume != layer->volume()
+        || l.visibility != static_cast<int>(layer->alpha() * 100.f)
+        || l.planeAzimuth != layer->planeAzimuth()
+        || l.planeElevation != layer->planeElevation()
+        || l.planeRoll != layer->planeRoll()
+        || l.planeDistance != layer->planeDistance()
+        || l.planeHorizontal != layer->planeHorizontal()
+        || l.planeVertical != layer->planeVertical()
+        || l.title != layer->title()) {
+        return false;
+    }
+
+    size_t subIdx = 0;
+    if (layer->hasSubLayers()) {
+        for (const auto &sub : layer->getSubLayers()) {
+            if (!sub)
+                continue;
+            if (subIdx >= l.subLayers.size() || !sameLayer(l.subLayers[subIdx], sub.get()))
+                return false;
+            subIdx++;
+        }
+    }
+    return subIdx == l.subLayers.size();
+}
+
+// The previous layers when nothing changed, so unchanged slides are not copied every capture
+static std::shared_ptr<const HttpServerState::Layers> captureLayers(LayersModel *lm, const std::shared_ptr<const HttpServerState::Layers> &previous) {
+    if (!lm)
+        return std::make_shared<const HttpServerState::Layers>();
+
+    int numLayers = lm->numberOfLayers();
+    if (previous && previous->size() == static_cast<size_t>(numLayers)) {
+        bool same = true;
+        for (int i = 0; i < numLayers && same; i++) {
+            same = sameLayer((*previous)[i], lm->layer(i));
+        }
+        if (same)
+            return previous;
+    }
+
+    auto layers = std::make_shared<HttpServerState::Layers>();
+    for (int i = 0; i < numLayers; i++) {
+        layers->push_back(captureLayer(lm->layer(i)));
+    }
+    return layers;
+}
+
+static std::vector<std::string> layerTitles(const HttpServerState::Layers *layers) {
+    std::vector<std::string> titles;
+    if (!layers)
+        return titles;
+
+    for (const HttpServerState::Layer &layer : *layers) {
+        titles.push_back(layer.title);
+    }
+    return titles;
+}
+
+static QJsonArray layersState(LayersModel *lm) {
+    QJsonArray layers;
+    if (!lm)
+        return layers;
+
+    for (int i = 0; i < lm->numberOfLayers(); i++) {
+        BaseLayer *layer = lm->layer(i);
+        if (!layer)
+            continue;
+        QJsonObject l;
+        l.insert(QStringLiteral("title"), QString::fromStdString(layer->title()));
+        l.insert(QStringLiteral("visibility"), static_cast<int>(layer->alpha() * 100.f));
+        l.insert(QStringLiteral("volume"), layer->volume());
+        l.insert(QStringLiteral("status"), lm->layerStatus(i));
+        layers.append(l);
+    }
+    return layers;
+}
+
+std::string HttpServerState::TextCache::text(int list, size_t charsPerItem, const std::function<std::string()> &format) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto key = std::make_pair(list, charsPerItem);
+    auto it = m_texts.find(key);
+    if (it != m_texts.end()) {
+        return it->second;
+    }
+    std::string text = format();
+    if (m_texts.size() < MaxCachedTexts) {
+        m_texts.emplace(key, text);
+    }
+    return text;
+}
+
+bool HttpServerState::Presentation::sameTitles(const Presentation &other) const {
+    return slideNames == other.slideNames
+        && slideLayerTitles == other.slideLayerTitles
+        && masterLayerTitles == other.masterLayerTitles;
+}
+
+int HttpServerState::Presentation::slideIndex(const std::string &name) const {
+    std::string nameLowCase = QString::fromStdString(name).toLower().toStdString();
+    if (nameLowCase == "master") {
+        return -1;
+    }
+    for (size_t i = 0; i < m_slideNamesLowCase.size(); i++) {
+        if (m_slideNamesLowCase[i] == nameLowCase) {
+            return static_cast<int>(i);
+        }
+    }
+    return -2;
+}
+
+std::string HttpServerState::Presentation::slidesText(size_t charsPerItem) const {
+    return layersText(-2, charsPerItem);
+}
+
+std::string HttpServerState::Presentation::layersText(int slideIdx, size_t charsPerItem) const {
+    // slideIdx -2 is the slide list itself
+    const std::vector<std::string> *titles = nullptr;
+    if (slideIdx == -2)
+        titles = &slideNames;
+    else if (slideIdx == -1)
+        titles = &masterLayerTitles;
+    else if (slideIdx >= 0 && slideIdx < static_cast<int>(slideLayerTitles.size()))
+        titles = &slideLayerTitles[slideIdx];
+    else
+        return "";
+
+    return m_texts.text(slideIdx, charsPerItem, [titles, charsPerItem] {
+        return formatItemList(*titles, charsPerItem);
+    });
+}
+
+std::string HttpServerState::Media::playlistText(size_t charsPerItem) const {
+    return m_texts.text(PlaylistList, charsPerItem, [this, charsPerItem] {
+        return formatItemList(playlistItems, charsPerItem);
+    });
+}
+
+std::string HttpServerState::Media::sectionsText(size_t charsPerItem) const {
+    return m_texts.text(SectionsList, charsPerItem, [this, charsPerItem] {
+        return formatItemList(sectionItems, charsPerItem);
+    });
+}
+
+std::string HttpServerState::Media::audioTracksText(bool removeLoadedFilePrefix, size_t charsPerItem) const {
+    int list = removeLoadedFilePrefix ? AudioTracksNoPrefixList : AudioTracksList;
+    return m_texts.text(list, charsPerItem, [this, removeLoadedFilePrefix, charsPerItem] {
+        std::string fullItemList = "";
+        for (size_t i = 0; i < audioTracks.size(); i++) {
+            std::string title = audioTracks[i];
+            if (removeLoadedFilePrefix) {
+                size_t maxLen = std::min(loadedFileName.size(), title.size());
+                size_t mc = 0;
+                while (mc < maxLen && loadedFileName[mc] == title[mc])
+                    mc++;
+                title.erase(0, mc);
+            }
+            std::replace(title.begin(), title.end(), '_', ' ');
+
+            fullItemList += fitItem(title, "", charsPerItem);
+            if (i < audioTracks.size() - 1)
+                fullItemList += "\n";
+        }
+        return fullItemList;
+    });
+}
+
+std::string HttpServerState::etag(const std::string &content) {
+    return std::format("\"{:016x}\"", std::hash<std::string>{}(content));
+}
+
+const HttpServerState::Layers *HttpServerState::layers(int slideIdx) const {
+    if (slideIdx == -1)
+        return masterLayers.get();
+    if (slideIdx >= 0 && slideIdx < static_cast<int>(slideLayers.size()))
+        return slideLayers[slideIdx].get();
+    return nullptr;
+}
+
+bool HttpServerState::sameValues(const HttpServerState &other) const {
+    return stateObject == other.stateObject
+        && hasMpv == other.hasMpv
+        && hasSlidesModel == other.hasSlidesModel
+        && speed == other.speed
+        && autoPlay == other.autoPlay
+        && syncVolumeVisibilityFading == other.syncVolumeVisibilityFading
+        && stereoMode == other.stereoMode
+        && gridMode == other.gridMode
+        && eofMode == other.eofMode
+        && sectionStartTime == other.sectionStartTime
+        && sectionEndTime == other.sectionEndTime
+        && sectionEndMode == other.sectionEndMode
+        && presentation == other.presentation
+        && media == other.media
+        && slideLayers == other.slideLayers
+        && masterLayers == other.masterLayers;
+}
+
+std::shared_ptr<const HttpServerState> HttpServerState::capture(MpvObject *mpv, SlidesModel *sm, const std::shared_ptr<const HttpServerState> &previous,
+                                                                bool titlesChanged, bool mediaChanged) {
+    auto state = std::make_shared<HttpServerState>();
+
+    QJsonObject stateObject;
+    if (mpv) {
+        state->hasMpv = true;
+        state->position = mpv->position();
+        state->remaining = mpv->remaining();
+        state->duration = mpv->duration();
+        state->speed = mpv->speed();
+        state->volume = mpv->volume();
+        state->visibility = mpv->visibility();
+        state->autoPlay = mpv->autoPlay();
+        state->syncVolumeVisibilityFading = mpv->syncVolumeVisibilityFading();
+        state->stereoMode = mpv->stereoscopicMode();
+        state->gridMode = mpv->gridToMapOn();
+        state->eofMode = mpv->eofMode();
+        state->mediaTitle = mpv->mediaTitle().toStdString();
+        state->playingInPlaylist = mpv->getPlayListModel()->getPlayingVideo();
+
+        PlaySectionsModel *sections = mpv->getPlaySectionsModel();
+        state->playingInSections = sections->getPlayingSection();
+        if (state->playingInSections >= 0) {
+            state->sectionStartTime = sections->sectionStartTime(state->playingInSections);
+            state->sectionEndTime = sections->sectionEndTime(state->playingInSections);
+            state->sectionEndMode = sections->sectionEOSMode(state->playingInSections);
+        }
+
+        if (mediaChanged || !previous || !previous->media) {
+            auto media = std::make_shared<Media>();
+            media->playlistItems = mpv->getPlayListModel()->getListItems();
+            media->sectionItems = sections->getSectionItems();
+            media->audioTracks = mpv->audioTracksModel()->getShortTitles();
+            media->loadedFileName = mpv->getProperty(QStringLiteral("filename")).toString().toStdString();
+            media->audioId = mpv->audioId();
+
+            QJsonObject playlist;
+            mpv->getPlayListModel()->asJSON(playlist);
+            media->playlistJson = QJsonDocument(playlist).toJson(QJsonDocument::Compact).toStdString();
+            QJsonObject playfile;
+            if (sections->currentEditItem())
+                sections->currentEditItem()->asJSON(playfile);
+            media->playfileJson = QJsonDocument(playfile).toJson(QJsonDocument::Compact).toStdString();
+            media->playlistETag = etag(media->playlistJson);
+            media->playfileETag = etag(media->playfileJson);
+            state->media = media;
+        }
+        else {
+            state->media = previous->media;
+        }
+
+        stateObject.insert(QStringLiteral("position"), state->position);
+        stateObject.insert(QStringLiteral("remaining"), state->remaining);
+        stateObject.insert(QStringLiteral("duration"), state->duration);
+        stateObject.insert(QStringLiteral("pause"), mpv->pause());
+        stateObject.insert(QStringLiteral("volume"), state->volume);
+        stateObject.insert(QStringLiteral("visibility"), state->visibility);
+        stateObject.insert(QStringLiteral("media_title"), mpv->mediaTitle());
+        stateObject.insert(QStringLiteral("playing_in_playlist"), state->playingInPlaylist);
+        stateObject.insert(QStringLiteral("playing_in_sections"), state->playingInSections);
+    }
+    if (sm) {
+        state->hasSlidesModel = true;
+        state->playingInSlides = sm->selectedSlideIdx();
+        LayersModel *selected = sm->selectedSlide();
+        state->slideName = selected ? selected->getLayersName().toStdString() : "";
+
+        // Layer values are compared with the previous capture, and only copied when changed
+        std::shared_ptr<const Presentation> previousPresentation = previous ? previous->presentation : nullptr;
+        for (int i = 0; i < sm->numberOfSlides(); i++) {
+            std::shared_ptr<const Layers> previousLayers;
+            if (previous && i < static_cast<int>(previous->slideLayers.size()))
+                previousLayers = previous->slideLayers[i];
+            state->slideLayers.push_back(captureLayers(sm->slide(i), previousLayers));
+
+            // Layer titles are not edited through the slides model, so check them as well
+            if (state->slideLayers[i] != previousLayers && previousPresentation
+                && (i >= static_cast<int>(previousPresentation->slideLayerTitles.size())
+                    || previousPresentation->slideLayerTitles[i] != layerTitles(state->slideLayers[i].get()))) {
+                titlesChanged = true;
+            }
+        }
+        state->masterLayers = captureLayers(sm->masterSlide(), previous ? previous->masterLayers : nullptr);
+        if (previousPresentation && state->masterLayers != previous->masterLayers
+            && previousPresentation->masterLayerTitles != layerTitles(state->masterLayers.get())) {
+            titlesChanged = true;
+        }
+
+        if (titlesChanged || !previousPresentation) {
+            auto presentation = std::make_shared<Presentation>();
+            for (int i = 0; i < sm->numberOfSlides(); i++) {
+                LayersModel *lm = sm->slide(i);
+                QString name = lm ? lm->getLayersName() : QStringLiteral("");
+                presentation->slideNames.push_back(name.toStdString());
+                presentation->m_slideNamesLowCase.push_back(name.toLower().toStdString());
+                presentation->slideLayerTitles.push_back(layerTitles(state->slideLayers[i].get()));
+            }
+            presentation->masterLayerTitles = layerTitles(state->masterLayers.get());
+            std::string names;
+            for (const std::string &name : presentation->slideNames) {
+                names += name;
+                names += '\n';
+            }
+            presentation->slidesETag = std::format("{:016x}", std::hash<std::string>{}(names));
+
+            // Keep the previous presentation (and its formatted lists) while the titles are the same
+            if (previousPresentation && previousPresentation->sameTitles(*presentation))
+                state->presentation = previousPresentation;
+            else
+                state->presentation = presentation;
+        }
+        else {
+            state->presentation = previousPresentation;
+        }
+
+        stateObject.insert(QStringLiteral("playing_in_slides"), state->playingInSlides);
+        stateObject.insert(QStringLiteral("triggered_slide"), sm->triggeredSlideIdx());
+        stateObject.insert(QStringLiteral("slide_name"), QString::fromStdString(state->slideName));
+        stateObject.insert(QStringLiteral("master_layers"), layersState(sm->masterSlide()));
+        stateObject.insert(QStringLiteral("slide_layers"), layersState(selected));
+    }
+    state->stateObject = stateObject;
+
+    if (previous && previous->sameValues(*state)) {
+        return previous;
+    }
+
+    state->version = previous ? previous->version + 1 : 1;
+    state->stateJson = QJsonDocument(stateObject).toJson(QJsonDocument::Compact).toStdString();
+    return state;
+}
@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef HTTPSERVERSTATE_H
+#define HTTPSERVERSTATE_H
+
+#include <QJsonObject>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class MpvObject;
+class SlidesModel;
+
+// Immutable copy of the state served by the HTTP read endpoints. A new state is
+// captured on the GUI thread and published by swapping a shared pointer, so the
+// HTTP thread never has to touch MpvObject or SlidesModel to answer a GET.
+class HttpServerState {
+public:
+    // Formatted lists by list and charsPerItem, shared by the HTTP worker threads
+    class TextCache {
+    public:
+        std::string text(int list, size_t charsPerItem, const std::function<std::string()> &format) const;
+
+    private:
+        mutable std::mutex m_mutex;
+        mutable std::map<std::pair<int, size_t>, std::string> m_texts;
+    };
+
+    // Slide and layer titles. Rebuilt when the slides model signals a change, and
+    // shared by the states in between, so the formatted lists are only built once.
+    class Presentation {
+    public:
+        std::vector<std::string> slideNames;
+        std::vector<std::vector<std::string>> slideLayerTitles;
+        std::vector<std::string> masterLayerTitles;
+        // Hash of the slide names, combined with charsPerItem into the /slides ETag
+        std::string slidesETag;
+
+        bool sameTitles(const Presentation &other) const;
+
+        // Index of slide with name (case insensitive), -1 for master, -2 when not found
+        int slideIndex(const std::string &name) const;
+
+        std::string slidesText(size_t charsPerItem = 0) const;
+        std::string layersText(int slideIdx, size_t charsPerItem = 0) const;
+
+    private:
+        std::vector<std::string> m_slideNamesLowCase;
+        TextCache m_texts;
+
+        friend class HttpServerState;
+    };
+
+    // Playlist, sections and audio tracks of the media player. Rebuilt when one of
+    // their models signals a change, and shared by the states in between.
+    class Media {
+    public:
+        std::vector<std::pair<std::string, std::string>> playlistItems; // Title and duration
+        std::vector<std::pair<std::string, std::string>> sectionItems;
+        std::vector<std::string> audioTracks;
+        std::string loadedFileName;
+        int audioId = 0;
+        std::string playlistJson;
+        std::string playfileJson;
+        std::string playlistETag;
+        std::string playfileETag;
+
+        std::string playlistText(size_t charsPerItem) const;
+        std::string sectionsText(size_t charsPerItem) const;
+        std::string audioTracksText(bool removeLoadedFilePrefix, size_t charsPerItem) const;
+
+    private:
+        TextCache m_texts;
+    };
+
+    // Values served by the layer endpoints
+    struct Layer {
+        std::string title;
+        int volume = 0;
+        int visibility = 0;
+        double planeAzimuth = 0.0;
+        double planeElevation = 0.0;
+        double planeRoll = 0.0;
+        double planeDistance = 0.0;
+        double planeHorizontal = 0.0;
+        double planeVertical = 0.0;
+        std::vector<Layer> subLayers;
+    };
+    using Layers = std::vector<Layer>;
+
+    // titlesChanged and mediaChanged tell that the slides or media models signalled a
+    // change since the previous capture. Otherwise their parts are taken from previous.
+    static std::shared_ptr<const HttpServerState> capture(MpvObject *mpv, SlidesModel *sm, const std::shared_ptr<const HttpServerState> &previous,
+                                                          bool titlesChanged, bool mediaChanged);
+
+    // Layers of slide, -1 for master. Null when there is no such slide.
+    const Layers *layers(int slideIdx) const;
+
+    // Quoted hash of content, for the ETag header
+    static std::string etag(const std::string &content);
+
+    uint64_t version = 0;
+    bool hasMpv = false;
+    bool hasSlidesModel = false;
+
+    double position = 0.0;
+    double remaining = 0.0;
+    double duration = 0.0;
+    double speed = 1.0;
+    int volume = 0;
+    int visibility = 0;
+    bool autoPlay = false;
+    bool syncVolumeVisibilityFading = false;
+    int stereoMode = 0;
+    int gridMode = 0;
+    int eofMode = 0;
+    std::string mediaTitle;
+    int playingInPlaylist = -1;
+    int playingInSections = -1;
+    double sectionStartTime = 0.0;
+    double sectionEndTime = 0.0;
+    int sectionEndMode = 0;
+    int playingInSlides = -1;
+    std::string slideName;
+
+    std::shared_ptr<const Presentation> presentation;
+    std::shared_ptr<const Media> media;
+    // Same order as the slides, and shared with the previous state while unchanged
+    std::vector<std::shared_ptr<const Layers>> slideLayers;
+    std::shared_ptr<const Layers> masterLayers;
+
+    // Same content as the /subscribe state event, and pre-serialized for /state
+    QJsonObject stateObject;
+    std::string stateJson;
+
+private:
+    bool sameValues(const HttpServerState &other) const;
+};
+
+#endif // HTTPSERVERSTATE_H
@@ -6,6 +6,8 @@
  */
 
 #include "httpserverthread.h"
+#include "application.h"
+#include "clusterstats.h"
 #include "mpvobject.h"
 #include "playbacksettings.h"
 #include "playercontroller.h"
@@ -13,12 +15,24 @@
 #include "layersmodel.h"
 #include "layers/baselayer.h"
 
+#include <QAbstractItemModel>
 #include <QFile>
+#include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QTimer>
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <functional>
+#include <memory>
+#include <vector>
 
 #pragma warning(disable : 4996)
 
+// The state is no longer captured when nobody asked for it for this long
+static constexpr auto StateIdleTimeout = std::chrono::seconds(2);
+
 std::string formatTime(double timeInSeconds, std::string format = "hh:mm:ss/zz") {
     QTime t(0, 0, 0);
     QString formatQ = QString::fromStdString(format);
@@ -31,10 +45,18 @@ HttpServerThread::HttpServerThread(QObject *parent)
         m_mpv(nullptr),
         m_slidesModel(nullptr),
         runServer(false),
-        portServer(7007) {
+        portServer(7007),
+        m_stateTimer(new QTimer(this)),
+        m_state(std::make_shared<const HttpServerState>()),
+        m_streamTimer(new QTimer(this)) {
+    m_stateTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_stateTimer, &QTimer::timeout, this, &HttpServerThread::publishState);
+    connect(m_streamTimer, &QTimer::timeout, this, &HttpServerThread::publishStreamState);
 }
 
 HttpServerThread::~HttpServerThread() {
+    stopStreams();
+
     mutex.lock();
     abort = true;
     condition.wakeOne();
@@ -73,7 +95,60 @@ void HttpServerThread::setupHttpServer() {
         return;
     }
 
+    if (httpServerConf.contains(QStringLiteral("worker_threads"))) {
+        m_workerThreads = std::max(0, httpServerConf.value(QStringLiteral("worker_threads")).toInt());
+    }
+
+    if (httpServerConf.contains(QStringLiteral("keep_alive_max_count"))) {
+        m_keepAliveMaxCount = std::max(1, httpServerConf.value(QStringLiteral("keep_alive_max_count")).toInt());
+    }
+
+    if (httpServerConf.contains(QStringLiteral("keep_alive_timeout"))) {
+        m_keepAliveTimeout = std::max(1, httpServerConf.value(QStringLiteral("keep_alive_timeout")).toInt());
+    }
+
+    if (httpServerConf.contains(QStringLiteral("state_rate"))) {
+        m_stateRate = std::max(1, httpServerConf.value(QStringLiteral("state_rate")).toInt());
+    }
+
+    if (httpServerConf.contains(QStringLiteral("stream_rate"))) {
+        m_streamRate = std::max(1, httpServerConf.value(QStringLiteral("stream_rate")).toInt());
+    }
+
+    if (httpServerConf.contains(QStringLiteral("max_subscribers"))) {
+        m_maxSubscribers = std::max(0, httpServerConf.value(QStringLiteral("max_subscribers")).toInt());
+    }
+
     if (runServerStr == QStringLiteral("yes")) {
+        // 0 worker threads means the cpp-httplib default. Every /subscribe client holds a thread
+        // for as long as it is connected, so reserve one per allowed subscriber on top of the workers.
+        size_t requestThreads = m_workerThreads > 0 ? static_cast<size_t>(m_workerThreads) : static_cast<size_t>(CPPHTTPLIB_THREAD_POOL_COUNT);
+        svr.new_task_queue = [threads = requestThreads + static_cast<size_t>(m_maxSubscribers)] {
+            return new httplib::ThreadPool(threads);
+        };
+        svr.set_keep_alive_max_count(static_cast<size_t>(m_keepAliveMaxCount));
+        svr.set_keep_alive_timeout(static_cast<time_t>(m_keepAliveTimeout));
+
+        // Request metrics. Each request is handled from start to end on one worker thread.
+        static thread_local std::chrono::steady_clock::time_point requestStart;
+        svr.set_pre_routing_handler([](const httplib::Request &, httplib::Response &) {
+            requestStart = std::chrono::steady_clock::now();
+            return httplib::Server::HandlerResponse::Unhandled;
+        });
+        svr.set_logger([this](const httplib::Request &req, const httplib::Response &res) {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - requestStart;
+            // Don't let unknown paths grow the number of routes
+            std::string route = res.status == 404 ? "other" : req.path;
+            m_metrics.record(req.method, route, res.status, elapsed.count());
+        });
+        svr.Get("/metrics", [this](const httplib::Request &, httplib::Response &res) {
+            res.set_content(m_metrics.toPrometheus(), "text/plain; version=0.0.4");
+        });
+        // Sync payload sizes of the master, and decode/apply times reported by the nodes
+        svr.Get("/cluster_stats", [](const httplib::Request &, httplib::Response &res) {
+            res.set_content(QJsonDocument(ClusterStats::instance().toJson()).toJson(QJsonDocument::Compact).toStdString(), "application/json");
+        });
+
         svr.Get("/status", [](const httplib::Request &, httplib::Response &res) {
             res.set_content("OK", "text/plain");
         });
@@ -81,6 +156,27 @@ void HttpServerThread::setupHttpServer() {
             res.set_content("OK", "text/plain");
         });
 
+        // Server-Sent Events stream of state changes, as an alternative to polling
+        svr.Get("/subscribe", [this](const httplib::Request &, httplib::Response &res) {
+            // Beyond the cap subscribers would take threads meant for regular requests
+            if (m_streamSubscribers.fetch_add(1) >= m_maxSubscribers) {
+                m_streamSubscribers--;
+                res.status = 503;
+                res.set_content("Too many subscribers", "text/plain");
+                return;
+            }
+            QMetaObject::invokeMethod(this, &HttpServerThread::wakeState, Qt::QueuedConnection);
+            auto lastVersion = std::make_shared<uint64_t>(0);
+            res.set_header("Cache-Control", "no-cache");
+            res.set_chunked_content_provider("text/event-stream",
+                [this, lastVersion](size_t, httplib::DataSink &sink) {
+                    return writeStreamEvent(*lastVersion, sink);
+                },
+                [this](bool) {
+                    m_streamSubscribers--;
+                });
+        });
+
         svr.Post("/quit", [this](const httplib::Request&, httplib::Response& res) {
             res.set_content("Quitting C-Play", "text/plain");
             Q_EMIT quitCPlay();
@@ -107,11 +203,12 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto positionGetHandler = [this](const httplib::Request &req, httplib::Response &res) {
-            if (m_mpv) {
+            auto state = this->state();
+            if (state->hasMpv) {
                 if (req.has_param("format")) {
-                    res.set_content(formatTime(m_mpv->position(), req.get_param_value("format")), "text/plain");
+                    res.set_content(formatTime(state->position, req.get_param_value("format")), "text/plain");
                 } else {
-                    res.set_content(std::to_string(m_mpv->position()), "text/plain");
+                    res.set_content(std::to_string(state->position), "text/plain");
                 }
             } else {
                 res.set_content("0", "text/plain");
@@ -130,11 +227,12 @@ void HttpServerThread::setupHttpServer() {
                 int timeInSec = 0;
                 if (stringToInt(req.get_param_value("time"), timeInSec)) {
                     Q_EMIT seekInMedia(timeInSec);
-                    if (m_mpv) {
+                    auto state = this->state();
+                    if (state->hasMpv) {
                         if (req.has_param("format")) {
-                            res.set_content(formatTime(m_mpv->position() + timeInSec, req.get_param_value("format")), "text/plain");
+                            res.set_content(formatTime(state->position + timeInSec, req.get_param_value("format")), "text/plain");
                         } else {
-                            res.set_content(std::to_string(m_mpv->position() + timeInSec), "text/plain");
+                            res.set_content(std::to_string(state->position + timeInSec), "text/plain");
                         }
                     } else {
                         res.set_content("Seeking " + req.get_param_value("time") + " s", "text/plain");
@@ -148,11 +246,12 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto remainingHandler = [this](const httplib::Request &req, httplib::Response &res) {
-            if (m_mpv) {
+            auto state = this->state();
+            if (state->hasMpv) {
                 if (req.has_param("format")) {
-                    res.set_content(formatTime(m_mpv->remaining(), req.get_param_value("format")), "text/plain");
+                    res.set_content(formatTime(state->remaining, req.get_param_value("format")), "text/plain");
                 } else {
-                    res.set_content(std::to_string(m_mpv->remaining()), "text/plain");
+                    res.set_content(std::to_string(state->remaining), "text/plain");
                 }
             } else {
                 res.set_content("0", "text/plain");
@@ -162,11 +261,12 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/remaining", remainingHandler);
 
         auto durationHandler = [this](const httplib::Request &req, httplib::Response &res) {
-            if (m_mpv) {
+            auto state = this->state();
+            if (state->hasMpv) {
                 if (req.has_param("format")) {
-                    res.set_content(formatTime(m_mpv->duration(), req.get_param_value("format")), "text/plain");
+                    res.set_content(formatTime(state->duration, req.get_param_value("format")), "text/plain");
                 } else {
-                    res.set_content(std::to_string(m_mpv->duration()), "text/plain");
+                    res.set_content(std::to_string(state->duration), "text/plain");
                 }
             } else {
                 res.set_content("0", "text/plain");
@@ -176,8 +276,9 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/duration", durationHandler);
 
         auto autoPlayGetHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                if (m_mpv->autoPlay()) {
+            auto state = this->state();
+            if (state->hasMpv) {
+                if (state->autoPlay) {
                     res.set_content("1", "text/plain");
                 } else {
                     res.set_content("0", "text/plain");
@@ -209,8 +310,9 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto speedGetHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(std::to_string(m_mpv->speed()), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(std::to_string(state->speed), "text/plain");
             } else {
                 res.set_content("1", "text/plain");
             }
@@ -224,8 +326,9 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto volumeGetHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(std::to_string(m_mpv->volume()), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(std::to_string(state->volume), "text/plain");
             } else {
                 res.set_content("0", "text/plain");
             }
@@ -270,8 +373,9 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto syncImageVolumeFadeGetHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(std::to_string(m_mpv->syncVolumeVisibilityFading()), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(std::to_string(state->syncVolumeVisibilityFading), "text/plain");
             } else {
                 res.set_content("0", "text/plain");
             }
@@ -288,8 +392,9 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto visibilityHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(std::to_string(m_mpv->visibility()), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(std::to_string(state->visibility), "text/plain");
             } else {
                 res.set_content("0", "text/plain");
             }
@@ -298,8 +403,9 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/visibility", visibilityHandler);
 
         auto stereoModeHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(std::to_string(m_mpv->stereoscopicMode()), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(std::to_string(state->stereoMode), "text/plain");
             } else {
                 res.set_content("0", "text/plain");
             }
@@ -308,8 +414,9 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/stereo_mode", stereoModeHandler);
 
         auto gridModeHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(std::to_string(m_mpv->gridToMapOn()), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(std::to_string(state->gridMode), "text/plain");
             } else {
                 res.set_content("0", "text/plain");
             }
@@ -430,8 +537,9 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/foreground_image_grid_mode", foregroundImageGridModeHandler);
 
         auto eofModeHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(std::to_string(m_mpv->eofMode()), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(std::to_string(state->eofMode), "text/plain");
             } else {
                 res.set_content("0", "text/plain");
             }
@@ -440,8 +548,9 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/eof_mode", eofModeHandler);
 
         auto loopModeHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(std::to_string(m_mpv->eofMode()), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(std::to_string(state->eofMode), "text/plain");
             } else {
                 res.set_content("0", "text/plain");
             }
@@ -466,8 +575,9 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto mediaTitleHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                res.set_content(m_mpv->mediaTitle().toStdString(), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                res.set_content(state->mediaTitle, "text/plain");
             } else {
                 res.set_content("", "text/plain");
             }
@@ -558,14 +668,13 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto sectionStartTimeHandler = [this](const httplib::Request &req, httplib::Response &res) {
-            if (m_mpv) {
-                int playingIndex = m_mpv->getPlaySectionsModel()->getPlayingSection();
-                if (playingIndex >= 0) {
-                    double startTime = m_mpv->getPlaySectionsModel()->sectionStartTime(playingIndex);
+            auto state = this->state();
+            if (state->hasMpv) {
+                if (state->playingInSections >= 0) {
                     if (req.has_param("format")) {
-                        res.set_content(formatTime(startTime, req.get_param_value("format")), "text/plain");
+                        res.set_content(formatTime(state->sectionStartTime, req.get_param_value("format")), "text/plain");
                     } else {
-                        res.set_content(std::to_string(startTime), "text/plain");
+                        res.set_content(std::to_string(state->sectionStartTime), "text/plain");
                     }
                 } else {
                     res.set_content("0", "text/plain");
@@ -578,14 +687,13 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/section_start_time", sectionStartTimeHandler);
 
         auto sectionEndTimeHandler = [this](const httplib::Request &req, httplib::Response &res) {
-            if (m_mpv) {
-                int playingIndex = m_mpv->getPlaySectionsModel()->getPlayingSection();
-                if (playingIndex >= 0) {
-                    double endTime = m_mpv->getPlaySectionsModel()->sectionEndTime(playingIndex);
+            auto state = this->state();
+            if (state->hasMpv) {
+                if (state->playingInSections >= 0) {
                     if (req.has_param("format")) {
-                        res.set_content(formatTime(endTime, req.get_param_value("format")), "text/plain");
+                        res.set_content(formatTime(state->sectionEndTime, req.get_param_value("format")), "text/plain");
                     } else {
-                        res.set_content(std::to_string(endTime), "text/plain");
+                        res.set_content(std::to_string(state->sectionEndTime), "text/plain");
                     }
                 } else {
                     res.set_content("0", "text/plain");
@@ -598,11 +706,10 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/section_end_time", sectionEndTimeHandler);
 
         auto sectionEndModeHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                int playingIndex = m_mpv->getPlaySectionsModel()->getPlayingSection();
-                if (playingIndex >= 0) {
-                    int endMode = m_mpv->getPlaySectionsModel()->sectionEOSMode(playingIndex);
-                    res.set_content(std::to_string(endMode), "text/plain");
+            auto state = this->state();
+            if (state->hasMpv) {
+                if (state->playingInSections >= 0) {
+                    res.set_content(std::to_string(state->sectionEndMode), "text/plain");
                 } else {
                     res.set_content("0", "text/plain");
                 }
@@ -613,15 +720,10 @@ void HttpServerThread::setupHttpServer() {
         svr.Get("/section_end_mode", sectionEndModeHandler);
         svr.Post("/section_end_mode", sectionEndModeHandler);
 
-        auto playfileJsonHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                QJsonDocument doc;
-                QJsonObject obj = doc.object();
-                if (m_mpv->getPlaySectionsModel()->currentEditItem()) {
-                    m_mpv->getPlaySectionsModel()->currentEditItem()->asJSON(obj);
-                }
-                doc.setObject(obj);
-                res.set_content(doc.toJson(QJsonDocument::Compact).toStdString(), "application/json");
+        auto playfileJsonHandler = [this](const httplib::Request &req, httplib::Response &res) {
+            auto state = this->state();
+            if (state->media) {
+                setContentWithETag(req, res, state->media->playfileETag, [&state] { return state->media->playfileJson; }, "application/json");
             } else {
                 res.set_content("Could not retrieve playlist", "text/plain");
             }
@@ -629,13 +731,10 @@ void HttpServerThread::setupHttpServer() {
         svr.Get("/playfile_json", playfileJsonHandler);
         svr.Post("/playfile_json", playfileJsonHandler);
 
-        auto playlistJsonHandler = [this](const httplib::Request &, httplib::Response &res) {
-            if (m_mpv) {
-                QJsonDocument doc;
-                QJsonObject obj = doc.object();
-                m_mpv->getPlayListModel()->asJSON(obj);
-                doc.setObject(obj);
-                res.set_content(doc.toJson(QJsonDocument::Compact).toStdString(), "application/json");
+        auto playlistJsonHandler = [this](const httplib::Request &req, httplib::Response &res) {
+            auto state = this->state();
+            if (state->media) {
+                setContentWithETag(req, res, state->media->playlistETag, [&state] { return state->media->playlistJson; }, "application/json");
             } else {
                 res.set_content("Could not retrieve playlist", "text/plain");
             }
@@ -790,18 +889,7 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto slideNameHandler = [this](const httplib::Request&, httplib::Response& res) {
-            if (m_slidesModel) {
-                LayersModel* layer = m_slidesModel->selectedSlide();
-                if (layer) {
-                    res.set_content(layer->getLayersName().toStdString(), "text/plain");
-                }
-                else {
-                    res.set_content("", "text/plain");
-                }
-            }
-            else {
-                res.set_content("", "text/plain");
-            }
+            res.set_content(state()->slideName, "text/plain");
         };
         svr.Get("/slide_name", slideNameHandler);
         svr.Post("/slide_name", slideNameHandler);
@@ -817,11 +905,17 @@ void HttpServerThread::setupHttpServer() {
         });
 
         auto slidesHandler = [this](const httplib::Request& req, httplib::Response& res) {
-            std::string charsPerItem = "";
-            if (req.has_param("charsPerItem")) {
-                charsPerItem = req.get_param_value("charsPerItem");
-            }
-            res.set_content(getSlideItems(charsPerItem), "text/plain");
+            auto state = this->state();
+            if (!state->hasSlidesModel) {
+                res.set_content("", "text/plain");
+                return;
+            }
+            int charsPerItem = 0;
+            if (req.has_param("charsPerItem") && !stringToInt(req.get_param_value("charsPerItem"), charsPerItem))
+                charsPerItem = 0;
+            size_t chars = static_cast<size_t>(std::max(0, charsPerItem));
+            std::string etag = std::format("\"{}-{}\"", state->presentation->slidesETag, chars);
+            setContentWithETag(req, res, etag, [&state, chars] { return state->presentation->slidesText(chars); }, "text/plain");
         };
         svr.Get("/slides", slidesHandler);
         svr.Post("/slides", slidesHandler);
@@ -879,100 +973,67 @@ void HttpServerThread::setupHttpServer() {
         svr.Post("/layers", layersHandler);
 
         auto layerVolumeGetHandler = [this](const httplib::Request& req, httplib::Response& res) {
-            LayersModel* layerModel = nullptr;
-            int layerIdx = -1;
-            BaseLayer* layer = nullptr;
-            res.set_content(getLayerFromRequest(req, layerModel, layerIdx, layer), "text/plain");
+            auto state = this->state();
+            const HttpServerState::Layer* layer = nullptr;
+            res.set_content(getLayerFromState(req, *state, layer), "text/plain");
             if (layer) {
-                res.set_content(std::to_string(layer->volume()), "text/plain");
+                res.set_content(std::to_string(layer->volume), "text/plain");
             }
         };
         svr.Get("/layer_volume", layerVolumeGetHandler);
         svr.Post("/layer_volume", [this](const httplib::Request& req, httplib::Response& res) {
-            LayersModel* layerModel = nullptr;
-            int layerIdx = -1;
-            BaseLayer* layer = nullptr;
-            res.set_content(getLayerFromRequest(req, layerModel, layerIdx, layer), "text/plain");
-            if (layer) {
-                if (req.has_param("level")) {
-                    int volumeLevel = 0;
-                    if (stringToInt(req.get_param_value("level"), volumeLevel)) {
-                        if (volumeLevel >= 0 && volumeLevel <= 100) {
-                            layer->setVolume(volumeLevel);
-                            if (layerModel) layerModel->updateLayer(layerIdx);
-                        }
-                    }
-                }
-                res.set_content(std::to_string(layer->volume()), "text/plain");
-            }
+            res.set_content(SetLayerVolumeFromRequest(req), "text/plain");
         });
 
         auto layerVisibilityGetHandler = [this](const httplib::Request& req, httplib::Response& res) {
-            LayersModel* layerModel = nullptr;
-            int layerIdx = -1;
-            BaseLayer* layer = nullptr;
-            res.set_content(getLayerFromRequest(req, layerModel, layerIdx, layer), "text/plain");
+            auto state = this->state();
+            const HttpServerState::Layer* layer = nullptr;
+            res.set_content(getLayerFromState(req, *state, layer), "text/plain");
             if (layer) {
-                res.set_content(std::to_string(static_cast<int>(layer->alpha()*100.f)), "text/plain");
+                res.set_content(std::to_string(layer->visibility), "text/plain");
             }
         };
         svr.Get("/layer_visibility", layerVisibilityGetHandler);
         svr.Post("/layer_visibility", [this](const httplib::Request& req, httplib::Response& res) {
-            LayersModel* layerModel = nullptr;
-            int layerIdx = -1;
-            BaseLayer* layer = nullptr;
-            res.set_content(getLayerFromRequest(req, layerModel, layerIdx, layer), "text/plain");
-            if (layer) {
-                if (req.has_param("value")) {
-                    int value = 0;
-                    if (stringToInt(req.get_param_value("value"), value)) {
-                        if (value >= 0 && value <= 100) {
-                            layer->setAlpha(static_cast<float>(value) * 0.01f);
-                            if (layerModel) layerModel->updateLayer(layerIdx);
-                        }
-                    }
-                }
-                res.set_content(std::to_string(static_cast<int>(layer->alpha()*100.f)), "text/plain");
-            }
+            res.set_content(SetLayerVisibilityFromRequest(req), "text/plain");
         });
 
         auto layerPlaneGetHandler = [this](const httplib::Request& req, httplib::Response& res) {
-            LayersModel* layerModel = nullptr;
-            int layerIdx = -1;
-            BaseLayer* layer = nullptr;
-            res.set_content(getLayerFromRequest(req, layerModel, layerIdx, layer), "text/plain");
+            auto state = this->state();
+            const HttpServerState::Layer* layer = nullptr;
+            res.set_content(getLayerFromState(req, *state, layer), "text/plain");
             if (layer) {
                     std::string returnString = "";
                     // Guard against unsigned underflow when fewer than 2 params provided
                     size_t countParams = req.params.size() > 2 ? req.params.size() - 2 : 0;
                     size_t count = 0;
                     if (req.has_param("azimuth")) {
-                        returnString += std::to_string(static_cast<int>(layer->planeAzimuth()));
+                        returnString += std::to_string(static_cast<int>(layer->planeAzimuth));
                         count++;
                         if (count < countParams) returnString += "\n";
                     }
                     if (req.has_param("elevation")) {
-                        returnString += std::to_string(static_cast<int>(layer->planeElevation()));
+                        returnString += std::to_string(static_cast<int>(layer->planeElevation));
                         count++;
                         if (count < countParams) returnString += "\n";
                     }
                     if (req.has_param("roll")) {
-                        returnString += std::to_string(static_cast<int>(layer->planeRoll()));
+                        returnString += std::to_string(static_cast<int>(layer->planeRoll));
                         count++;
                         if (count < countParams) returnString += "\n";
                     }
                     if (req.has_param("distance")) {
-                        returnString += std::to_string(static_cast<int>(layer->planeDistance()));
+                        returnString += std::to_string(static_cast<int>(layer->planeDistance));
                         count++;
                         if (count < countParams) returnString += "\n";
                     }
                     if (req.has_param("horizontal")) {
-                        returnString += std::to_string(static_cast<int>(layer->planeHorizontal()));
+                        returnString += std::to_string(static_cast<int>(layer->planeHorizontal));
                         count++;
                         if (count < countParams) returnString += "\n";
                     }
                     if (req.has_param("vertical")) {
-                        returnString += std::to_string(static_cast<int>(layer->planeVertical()));
+                        returnString += std::to_string(static_cast<int>(layer->planeVertical));
                         count++;
                         if (count < countParams) returnString += "\n";
                     }
@@ -981,89 +1042,29 @@ void HttpServerThread::setupHttpServer() {
         };
         svr.Get("/layer_plane", layerPlaneGetHandler);
         svr.Post("/layer_plane", [this](const httplib::Request& req, httplib::Response& res) {
-            LayersModel* layerModel = nullptr;
-            int layerIdx = -1;
-            BaseLayer* layer = nullptr;
-            res.set_content(getLayerFromRequest(req, layerModel, layerIdx, layer), "text/plain");
-            if (layer) {
-                    bool updateLayer = false;
-                    std::string returnString = "";
-                    // Guard against unsigned underflow when fewer than 2 params provided
-                    size_t countParams = req.params.size() > 2 ? req.params.size() - 2 : 0;
-                    size_t count = 0;
-                    if (req.has_param("azimuth")) {
-                        int value = 0;
-                        if (stringToInt(req.get_param_value("azimuth"), value)) {
-                            layer->setPlaneAzimuth(static_cast<double>(value));
-                            updateLayer = true;
-                        }
-                        returnString += std::to_string(static_cast<int>(layer->planeAzimuth()));
-                        count++;
-                        if (count < countParams)
-                            returnString += "\n";
-                    }
-                    if (req.has_param("elevation")) {
-                        int value = 0;
-                        if (stringToInt(req.get_param_value("elevation"), value)) {
-                            layer->setPlaneElevation(static_cast<double>(value));
-                            updateLayer = true;
-                        }
-                        returnString += std::to_string(static_cast<int>(layer->planeElevation()));
-                        count++;
-                        if (count < countParams)
-                            returnString += "\n";
-                    }
-                    if (req.has_param("roll")) {
-                        int value = 0;
-                        if (stringToInt(req.get_param_value("roll"), value)) {
-                            layer->setPlaneRoll(static_cast<double>(value));
-                            updateLayer = true;
-                        }
-                        returnString += std::to_string(static_cast<int>(layer->planeRoll()));
-                        count++;
-                        if (count < countParams)
-                            returnString += "\n";
-                    }
-                    if (req.has_param("distance")) {
-                        int value = 0;
-                        if (stringToInt(req.get_param_value("distance"), value)) {
-                            layer->setPlaneDistance(static_cast<double>(value));
-                            updateLayer = true;
-                        }
-                        returnString += std::to_string(static_cast<int>(layer->planeDistance()));
-                        count++;
-                        if (count < countParams)
-                            returnString += "\n";
-                    }
-                    if (req.has_param("horizontal")) {
-                        int value = 0;
-                        if (stringToInt(req.get_param_value("horizontal"), value)) {
-                            layer->setPlaneHorizontal(static_cast<double>(value));
-                            updateLayer = true;
-                        }
-                        returnString += std::to_string(static_cast<int>(layer->planeHorizontal()));
-                        count++;
-                        if (count < countParams)
-                            returnString += "\n";
-                    }
-                    if (req.has_param("vertical")) {
-                        int value = 0;
-                        if (stringToInt(req.get_param_value("vertical"), value)) {
-                            layer->setPlaneVertical(static_cast<double>(value));
-                            updateLayer = true;
-                        }
-                        returnString += std::to_string(static_cast<int>(layer->planeVertical()));
-                        count++;
-                        if (count < countParams)
-                            returnString += "\n";
-                    }
-                    if (updateLayer) {
-                        if (layerModel) layerModel->updateLayer(layerIdx);
-                    }
-                    res.set_content(returnString, "text/plain");
-            }
+            res.set_content(SetLayerPlaneFromRequest(req), "text/plain");
+        });
+
+        svr.Post("/batch", [this](const httplib::Request& req, httplib::Response& res) {
+            QJsonParseError parseError;
+            QJsonDocument batchDoc = QJsonDocument::fromJson(QByteArray::fromStdString(req.body), &parseError);
+            if (parseError.error != QJsonParseError::NoError || !batchDoc.isArray()) {
+                res.status = 400;
+                res.set_content("Body must be a JSON array of operations", "text/plain");
+                return;
+            }
+            QJsonObject response;
+            res.status = runBatch(batchDoc.array(), response);
+            res.set_content(QJsonDocument(response).toJson(QJsonDocument::Compact).toStdString(), "application/json");
+        });
+
+        svr.Get("/state", [this](const httplib::Request &, httplib::Response &res) {
+            res.set_content(state()->stateJson, "application/json");
         });
 
+        publishState();
+        m_streamTimer->start(1000 / m_streamRate);
+
         runServer = true;
         return;
     }
@@ -1073,6 +1074,8 @@ void HttpServerThread::setupHttpServer() {
 }
 
 void HttpServerThread::terminate() {
+    stopStreams();
+
     mutex.lock();
     abort = true;
     mutex.unlock();
@@ -1092,6 +1095,118 @@ void HttpServerThread::run() {
     }
 }
 
+void HttpServerThread::publishState() {
+    m_state.store(HttpServerState::capture(m_mpv, m_slidesModel, m_state.load(), m_titlesChanged, m_mediaChanged));
+    m_titlesChanged = false;
+    m_mediaChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(m_captureMutex);
+        m_captureCount++;
+    }
+    m_captureCondition.notify_all();
+
+    // Nothing to capture for when there are no subscribers and no recent requests
+    std::chrono::steady_clock::duration idle = std::chrono::steady_clock::now().time_since_epoch()
+                                               - std::chrono::steady_clock::duration(m_lastStateRequest.load());
+    if (m_stateActive && m_streamSubscribers == 0 && idle > StateIdleTimeout) {
+        m_stateActive = false;
+        m_stateTimer->stop();
+    }
+}
+
+void HttpServerThread::wakeState() {
+    if (!m_stateActive) {
+        m_stateActive = true;
+        m_stateTimer->start(1000 / m_stateRate);
+    }
+    publishState();
+}
+
+std::shared_ptr<const HttpServerState> HttpServerThread::state() {
+    m_lastStateRequest = std::chrono::steady_clock::now().time_since_epoch().count();
+    if (!m_stateActive) {
+        // The published state may be old, wait for the GUI thread to capture a new one
+        std::unique_lock<std::mutex> lock(m_captureMutex);
+        uint64_t captureCount = m_captureCount;
+        QMetaObject::invokeMethod(this, &HttpServerThread::wakeState, Qt::QueuedConnection);
+        m_captureCondition.wait_for(lock, std::chrono::seconds(1), [this, captureCount] {
+            return m_captureCount != captureCount;
+        });
+    }
+    return m_state.load();
+}
+
+void HttpServerThread::connectModelChanges(QAbstractItemModel *model, bool &changed) {
+    if (!model)
+        return;
+    auto setChanged = [&changed]() {
+        changed = true;
+    };
+    connect(model, &QAbstractItemModel::modelReset, this, setChanged);
+    connect(model, &QAbstractItemModel::layoutChanged, this, setChanged);
+    connect(model, &QAbstractItemModel::rowsInserted, this, setChanged);
+    connect(model, &QAbstractItemModel::rowsRemoved, this, setChanged);
+    connect(model, &QAbstractItemModel::rowsMoved, this, setChanged);
+    connect(model, &QAbstractItemModel::dataChanged, this, setChanged);
+}
+
+void HttpServerThread::publishStreamState() {
+    if (m_streamSubscribers == 0)
+        return;
+
+    auto current = m_state.load();
+    const QJsonObject &state = current->stateObject;
+    QJsonObject delta;
+    for (auto it = state.constBegin(); it != state.constEnd(); ++it) {
+        if (m_streamState.value(it.key()) != it.value())
+            delta.insert(it.key(), it.value());
+    }
+    if (delta.isEmpty())
+        return;
+    m_streamState = state;
+
+    const std::string &stateData = current->stateJson;
+    std::string deltaData = QJsonDocument(delta).toJson(QJsonDocument::Compact).toStdString();
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_streamVersion++;
+        std::string id = std::to_string(m_streamVersion);
+        m_streamFullEvent = "id: " + id + "\nevent: state\ndata: " + stateData + "\n\n";
+        m_streamDeltaEvent = "id: " + id + "\nevent: delta\ndata: " + deltaData + "\n\n";
+    }
+    m_streamCondition.notify_all();
+}
+
+bool HttpServerThread::writeStreamEvent(uint64_t &lastVersion, httplib::DataSink &sink) {
+    std::string event;
+    {
+        std::unique_lock<std::mutex> lock(m_streamMutex);
+        // Send a comment now and then when nothing changes, so closed connections are detected
+        bool changed = m_streamCondition.wait_for(lock, std::chrono::seconds(15), [this, &lastVersion] {
+            return m_streamStopping || m_streamVersion != lastVersion;
+        });
+        if (m_streamStopping)
+            return false;
+
+        if (!changed)
+            event = ": keep-alive\n\n";
+        else if (lastVersion != 0 && lastVersion + 1 == m_streamVersion)
+            event = m_streamDeltaEvent;
+        else // New subscriber, or one that missed an update
+            event = m_streamFullEvent;
+        lastVersion = m_streamVersion;
+    }
+    return sink.write(event.data(), event.size());
+}
+
+void HttpServerThread::stopStreams() {
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        m_streamStopping = true;
+    }
+    m_streamCondition.notify_all();
+}
+
 bool HttpServerThread::stringToInt(std::string str, int &parsedInt) {
     if (!str.empty()) {
         try {
@@ -1120,6 +1235,16 @@ bool HttpServerThread::stringToDouble(std::string str, double &parsedDouble) {
     return false;
 }
 
+void HttpServerThread::setContentWithETag(const httplib::Request &req, httplib::Response &res, const std::string &etag,
+                                          const std::function<std::string()> &content, const std::string &contentType) {
+    res.set_header("ETag", etag);
+    if (req.get_header_value("If-None-Match") == etag) {
+        res.status = 304;
+        return;
+    }
+    res.set_content(content(), contentType);
+}
+
 void HttpServerThread::setPositionFromStr(std::string positionTimeStr) {
     double pos = 0;
     if (stringToDouble(positionTimeStr, pos)) {
@@ -1168,112 +1293,99 @@ void HttpServerThread::setSyncImageFadingFromStr(std::string valueStr) {
 }
 
 const std::string HttpServerThread::getAudioTracksItems(std::string charsPerItemStr, std::string removeLoadedFilePrefixStr) {
-    if (m_mpv) {
+    auto state = this->state();
+    if (state->media) {
         int removeLoadedFilePrefix = 0;
-        std::string prefixToRemove = "";
-        if (stringToInt(removeLoadedFilePrefixStr, removeLoadedFilePrefix)) {
-            if (removeLoadedFilePrefix == 1)
-                prefixToRemove = m_mpv->getProperty(QStringLiteral("filename")).toString().toStdString();
-        }
-        int charsPerItem = 0;
-        if (stringToInt(charsPerItemStr, charsPerItem))
-            return m_mpv->audioTracksModel()->getListAsFormattedString(prefixToRemove, charsPerItem);
-        else
-            return m_mpv->audioTracksModel()->getListAsFormattedString(prefixToRemove);
+        bool removePrefix = stringToInt(removeLoadedFilePrefixStr, removeLoadedFilePrefix) && removeLoadedFilePrefix == 1;
+        int charsPerItem = 40;
+        stringToInt(charsPerItemStr, charsPerItem);
+        return state->media->audioTracksText(removePrefix, std::max(0, charsPerItem));
     } else
         return "";
 }
 
 const std::string HttpServerThread::getPlayListItems(std::string charsPerItemStr) {
-    if (m_mpv) {
-        int charsPerItem = 0;
-        if (stringToInt(charsPerItemStr, charsPerItem))
-            return m_mpv->getPlayListModel()->getListAsFormattedString(charsPerItem);
-        else
-            return m_mpv->getPlayListModel()->getListAsFormattedString();
+    auto state = this->state();
+    if (state->media) {
+        int charsPerItem = 40;
+        stringToInt(charsPerItemStr, charsPerItem);
+        return state->media->playlistText(std::max(0, charsPerItem));
     } else
         return "";
 }
 
 const std::string HttpServerThread::getSectionsItems(std::string charsPerItemStr) {
-    if (m_mpv) {
-        int charsPerItem = 0;
-        if (stringToInt(charsPerItemStr, charsPerItem))
-            return m_mpv->getPlaySectionsModel()->getSectionsAsFormattedString(charsPerItem);
-        else
-            return m_mpv->getPlaySectionsModel()->getSectionsAsFormattedString();
+    auto state = this->state();
+    if (state->media) {
+        int charsPerItem = 40;
+        stringToInt(charsPerItemStr, charsPerItem);
+        return state->media->sectionsText(std::max(0, charsPerItem));
     } else
         return "";
 }
 
-const std::string HttpServerThread::getSlideItems(std::string charsPerItemStr) {
-    if (m_slidesModel) {
-        int charsPerItem = 0;
-        if (stringToInt(charsPerItemStr, charsPerItem))
-            return m_slidesModel->getSlidesAsFormattedString(charsPerItem);
-        else
-            return m_slidesModel->getSlidesAsFormattedString();
-    }
-    else
-        return "";
-}
-
 const std::string HttpServerThread::getLayerItems(std::string slideName, std::string charsPerItemStr) {
-    if (m_slidesModel && !slideName.empty()) {
-        LayersModel* lm = m_slidesModel->slide(slideName);
-        if (!lm) {
+    auto state = this->state();
+    if (state->hasSlidesModel && !slideName.empty()) {
+        int slideIdx = state->presentation->slideIndex(slideName);
+        if (slideIdx < -1) {
             return "Could not find slide with name : " + slideName;
         }
         int charsPerItem = 0;
         if (stringToInt(charsPerItemStr, charsPerItem))
-            return lm->getLayersAsFormattedString(charsPerItem);
+            return state->presentation->layersText(slideIdx, std::max(0, charsPerItem));
         else
-            return lm->getLayersAsFormattedString();
+            return state->presentation->layersText(slideIdx);
     }
     else
         return "";
 }
 
 const std::string HttpServerThread::getLayerItems(int slideIdx, std::string charsPerItemStr) {
-    if (m_slidesModel) {
-        LayersModel* lm = m_slidesModel->slide(slideIdx);
-        if (!lm) {
+    auto state = this->state();
+    if (state->hasSlidesModel) {
+        // -1 is the master slide
+        if (slideIdx < -1 || slideIdx >= static_cast<int>(state->presentation->slideNames.size())) {
             return "Could not find slide with idx : " + std::to_string(slideIdx);
         }
         int charsPerItem = 0;
         if (stringToInt(charsPerItemStr, charsPerItem))
-            return lm->getLayersAsFormattedString(charsPerItem);
+            return state->presentation->layersText(slideIdx, std::max(0, charsPerItem));
         else
-            return lm->getLayersAsFormattedString();
+            return state->presentation->layersText(slideIdx);
     }
     else
         return "";
 }
 
 const std::string HttpServerThread::getPlaylingItemIndexFromAudioTracks() {
-    if (m_mpv) {
-        return std::to_string(m_mpv->audioId() - 1);
+    auto state = this->state();
+    if (state->media) {
+        return std::to_string(state->media->audioId - 1);
     }
     return "-1";
 }
 
 const std::string HttpServerThread::getPlaylingItemIndexFromPlaylist() {
-    if (m_mpv) {
-        return std::to_string(m_mpv->getPlayListModel()->getPlayingVideo());
+    auto state = this->state();
+    if (state->hasMpv) {
+        return std::to_string(state->playingInPlaylist);
     }
     return "-1";
 }
 
 const std::string HttpServerThread::getPlaylingItemIndexFromSections() {
-    if (m_mpv) {
-        return std::to_string(m_mpv->getPlaySectionsModel()->getPlayingSection());
+    auto state = this->state();
+    if (state->hasMpv) {
+        return std::to_string(state->playingInSections);
     }
     return "-1";
 }
 
 const std::string HttpServerThread::getPlaylingItemIndexFromSlides() {
-    if (m_slidesModel) {
-        return std::to_string(m_slidesModel->selectedSlideIdx());
+    auto state = this->state();
+    if (state->hasSlidesModel) {
+        return std::to_string(state->playingInSlides);
     }
     return "-1";
 }
@@ -1497,11 +1609,434 @@ const std::string HttpServerThread::getLayerFromRequest(const httplib::Request&
     }
 }
 
+const std::string HttpServerThread::getLayerFromState(const httplib::Request& req, const HttpServerState& state, const HttpServerState::Layer*& resolvedLayer) {
+    resolvedLayer = nullptr;
+    if (!state.hasSlidesModel) {
+        return "No slides model found";
+    }
+
+    const HttpServerState::Layers* layers = nullptr;
+    if (req.has_param("layer_title")) {
+        layers = state.layers(-1);
+        if (req.has_param("slide_name")) {
+            std::string slideNameStr = req.get_param_value("slide_name");
+            layers = state.layers(state.presentation->slideIndex(slideNameStr));
+            if (!layers) {
+                return "Could not find slide with name : " + slideNameStr;
+            }
+        }
+        if (layers) {
+            // Returning first with correct title
+            std::string layerTitleStr = req.get_param_value("layer_title");
+            QString titleLowCase = QString::fromStdString(layerTitleStr).toLower();
+            for (const HttpServerState::Layer& layer : *layers) {
+                if (QString::fromStdString(layer.title).toLower() == titleLowCase) {
+                    resolvedLayer = &layer;
+                    break;
+                }
+            }
+            if (!resolvedLayer) {
+                return "Could not find layer with title: " + layerTitleStr;
+            }
+        }
+        else {
+            return "Master slide missing";
+        }
+    }
+    else if (req.has_param("layer_idx")) {
+        layers = state.layers(-1);
+        if (req.has_param("slide_idx")) {
+            std::string slideIdx = req.get_param_value("slide_idx");
+            int index;
+            if (stringToInt(slideIdx, index)) {
+                layers = state.layers(index);
+                if (!layers) {
+                    return "Could not find slide with idx : " + slideIdx;
+                }
+            }
+            else {
+                return "Could not interpret slide_idx as integer.";
+            }
+        }
+
+        if (layers) {
+            std::string layerIdxStr = req.get_param_value("layer_idx");
+            int layerIdx = -1;
+            if (stringToInt(layerIdxStr, layerIdx)) {
+                if (layerIdx < 0 || layerIdx >= static_cast<int>(layers->size())) {
+                    return "Could not find layer with idx : " + layerIdxStr;
+                }
+                resolvedLayer = &(*layers)[layerIdx];
+            }
+            else {
+                return "Could not interpret layer_idx as integer.";
+            }
+        }
+        else {
+            return "Master slide missing";
+        }
+    }
+    else {
+        return "Missing layer title or index parameter";
+    }
+
+    // Resolve sublayer if requested
+    if (!resolvedLayer->subLayers.empty()) {
+        const auto& subLayers = resolvedLayer->subLayers;
+        if (req.has_param("sub_layer_title")) {
+            std::string subTitle = req.get_param_value("sub_layer_title");
+            bool found = false;
+            for (const auto& sub : subLayers) {
+                if (sub.title == subTitle) {
+                    resolvedLayer = &sub;
+                    found = true;
+                    break;
+                }
+            }
+            if (!found) {
+                return "Could not find sub-layer with title: " + subTitle;
+            }
+        }
+        else if (req.has_param("sub_layer_idx")) {
+            int subIdx = -1;
+            std::string subIdxStr = req.get_param_value("sub_layer_idx");
+            if (stringToInt(subIdxStr, subIdx)) {
+                if (subIdx >= 0 && subIdx < static_cast<int>(subLayers.size())) {
+                    resolvedLayer = &subLayers[subIdx];
+                }
+                else {
+                    return "Sub-layer index out of bounds: " + subIdxStr;
+                }
+            }
+            else {
+                return "Could not interpret sub_layer_idx as integer.";
+            }
+        }
+    }
+    else if (req.has_param("sub_layer_title") || req.has_param("sub_layer_idx")) {
+        return "Layer has no sub-layers";
+    }
+
+    return "Found layer: " + resolvedLayer->title;
+}
+
+const std::string HttpServerThread::SetLayerVolumeFromRequest(const httplib::Request& req) {
+    LayersModel* layerModel = nullptr;
+    int layerIdx = -1;
+    BaseLayer* layer = nullptr;
+    std::string message = getLayerFromRequest(req, layerModel, layerIdx, layer);
+    if (!layer) {
+        return message;
+    }
+    if (req.has_param("level")) {
+        int volumeLevel = 0;
+        if (stringToInt(req.get_param_value("level"), volumeLevel)) {
+            if (volumeLevel >= 0 && volumeLevel <= 100) {
+                layer->setVolume(volumeLevel);
+                if (layerModel) layerModel->updateLayer(layerIdx);
+            }
+        }
+    }
+    return std::to_string(layer->volume());
+}
+
+const std::string HttpServerThread::SetLayerVisibilityFromRequest(const httplib::Request& req) {
+    LayersModel* layerModel = nullptr;
+    int layerIdx = -1;
+    BaseLayer* layer = nullptr;
+    std::string message = getLayerFromRequest(req, layerModel, layerIdx, layer);
+    if (!layer) {
+        return message;
+    }
+    if (req.has_param("value")) {
+        int value = 0;
+        if (stringToInt(req.get_param_value("value"), value)) {
+            if (value >= 0 && value <= 100) {
+                layer->setAlpha(static_cast<float>(value) * 0.01f);
+                if (layerModel) layerModel->updateLayer(layerIdx);
+            }
+        }
+    }
+    return std::to_string(static_cast<int>(layer->alpha() * 100.f));
+}
+
+const std::string HttpServerThread::SetLayerPlaneFromRequest(const httplib::Request& req) {
+    LayersModel* layerModel = nullptr;
+    int layerIdx = -1;
+    BaseLayer* layer = nullptr;
+    std::string message = getLayerFromRequest(req, layerModel, layerIdx, layer);
+    if (!layer) {
+        return message;
+    }
+    bool updateLayer = false;
+    std::string returnString = "";
+    // Guard against unsigned underflow when fewer than 2 params provided
+    size_t countParams = req.params.size() > 2 ? req.params.size() - 2 : 0;
+    size_t count = 0;
+    if (req.has_param("azimuth")) {
+        int value = 0;
+        if (stringToInt(req.get_param_value("azimuth"), value)) {
+            layer->setPlaneAzimuth(static_cast<double>(value));
+            updateLayer = true;
+        }
+        returnString += std::to_string(static_cast<int>(layer->planeAzimuth()));
+        count++;
+        if (count < countParams)
+            returnString += "\n";
+    }
+    if (req.has_param("elevation")) {
+        int value = 0;
+        if (stringToInt(req.get_param_value("elevation"), value)) {
+            layer->setPlaneElevation(static_cast<double>(value));
+            updateLayer = true;
+        }
+        returnString += std::to_string(static_cast<int>(layer->planeElevation()));
+        count++;
+        if (count < countParams)
+            returnString += "\n";
+    }
+    if (req.has_param("roll")) {
+        int value = 0;
+        if (stringToInt(req.get_param_value("roll"), value)) {
+            layer->setPlaneRoll(static_cast<double>(value));
+            updateLayer = true;
+        }
+        returnString += std::to_string(static_cast<int>(layer->planeRoll()));
+        count++;
+        if (count < countParams)
+            returnString += "\n";
+    }
+    if (req.has_param("distance")) {
+        int value = 0;
+        if (stringToInt(req.get_param_value("distance"), value)) {
+            layer->setPlaneDistance(static_cast<double>(value));
+            updateLayer = true;
+        }
+        returnString += std::to_string(static_cast<int>(layer->planeDistance()));
+        count++;
+        if (count < countParams)
+            returnString += "\n";
+    }
+    if (req.has_param("horizontal")) {
+        int value = 0;
+        if (stringToInt(req.get_param_value("horizontal"), value)) {
+            layer->setPlaneHorizontal(static_cast<double>(value));
+            updateLayer = true;
+        }
+        returnString += std::to_string(static_cast<int>(layer->planeHorizontal()));
+        count++;
+        if (count < countParams)
+            returnString += "\n";
+    }
+    if (req.has_param("vertical")) {
+        int value = 0;
+        if (stringToInt(req.get_param_value("vertical"), value)) {
+            layer->setPlaneVertical(static_cast<double>(value));
+            updateLayer = true;
+        }
+        returnString += std::to_string(static_cast<int>(layer->planeVertical()));
+        count++;
+        if (count < countParams)
+            returnString += "\n";
+    }
+    if (updateLayer) {
+        if (layerModel) layerModel->updateLayer(layerIdx);
+    }
+    return returnString;
+}
+
+int HttpServerThread::runBatch(const QJsonArray& operations, QJsonObject& response) {
+    struct BatchCall {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<BatchOperation> operations;
+        bool applied = false;
+        bool done = false;
+        bool abandoned = false;
+    };
+    auto call = std::make_shared<BatchCall>();
+
+    // Convert the operations to requests, so they can be handled just like the single endpoints
+    for (const QJsonValue& value : operations) {
+        BatchOperation op;
+        QJsonObject opObj = value.toObject();
+        op.endpoint = opObj.value(QStringLiteral("endpoint")).toString().toStdString();
+        if (!value.isObject()) {
+            op.error = "Operation is not a JSON object";
+        }
+        else if (op.endpoint.empty()) {
+            op.error = "Missing endpoint";
+        }
+        QJsonObject params = opObj.value(QStringLiteral("params")).toObject();
+        for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+            op.request.params.emplace(it.key().toStdString(), it.value().toVariant().toString().toStdString());
+        }
+        call->operations.push_back(std::move(op));
+    }
+
+    // Models are owned by the GUI thread, so validate and apply there. The frame lock makes
+    // sure the sync encoder sees either none or all of the changes.
+    QMetaObject::invokeMethod(this, [this, call]() {
+        std::lock_guard<std::mutex> callLock(call->mutex);
+        if (call->abandoned)
+            return;
+        {
+            std::lock_guard<std::mutex> frameLock(SyncHelper::instance().frameMutex);
+            bool valid = true;
+            for (auto& op : call->operations) {
+                if (op.error.empty())
+                    op.error = validateBatchOperation(op.endpoint, op.request);
+                if (!op.error.empty())
+                    valid = false;
+            }
+            if (valid) {
+                for (auto& op : call->operations) {
+                    op.result = applyBatchOperation(op.endpoint, op.request);
+                }
+            }
+            call->applied = valid;
+        }
+        call->done = true;
+        call->condition.notify_one();
+    }, Qt::QueuedConnection);
+
+    std::unique_lock<std::mutex> lock(call->mutex);
+    if (!call->condition.wait_for(lock, std::chrono::seconds(5), [call] { return call->done; })) {
+        // GUI thread is busy (or shutting down), make sure the batch is never applied late
+        call->abandoned = true;
+        response.insert(QStringLiteral("applied"), false);
+        response.insert(QStringLiteral("error"), QStringLiteral("Timed out waiting for the GUI thread"));
+        return 503;
+    }
+
+    QJsonArray results;
+    for (const auto& op : call->operations) {
+        QJsonObject result;
+        result.insert(QStringLiteral("endpoint"), QString::fromStdString(op.endpoint));
+        result.insert(QStringLiteral("ok"), op.error.empty());
+        if (!op.error.empty())
+            result.insert(QStringLiteral("error"), QString::fromStdString(op.error));
+        else if (call->applied)
+            result.insert(QStringLiteral("result"), QString::fromStdString(op.result));
+        results.append(result);
+    }
+    response.insert(QStringLiteral("applied"), call->applied);
+    response.insert(QStringLiteral("results"), results);
+    return call->applied ? 200 : 400;
+}
+
+const std::string HttpServerThread::validateBatchOperation(const std::string& endpoint, const httplib::Request& req) {
+    if (endpoint == "/select_from_slides" || endpoint == "/load_from_slides") {
+        if (!req.has_param("index")) {
+            return "Missing index parameter";
+        }
+        int index = -1;
+        if (!stringToInt(req.get_param_value("index"), index)) {
+            return "Could not interpret index parameter";
+        }
+        if (!m_slidesModel) {
+            return "Could not find reference to SlideModel";
+        }
+        if (index < 0 || index >= m_slidesModel->numberOfSlides()) {
+            return "Index was out of bounds of slide list";
+        }
+        return "";
+    }
+
+    std::string valueParam;
+    std::vector<std::string> planeParams;
+    if (endpoint == "/layer_volume") {
+        valueParam = "level";
+    }
+    else if (endpoint == "/layer_visibility") {
+        valueParam = "value";
+    }
+    else if (endpoint == "/layer_plane") {
+        planeParams = { "azimuth", "elevation", "roll", "distance", "horizontal", "vertical" };
+    }
+    else {
+        return "Endpoint is not supported in a batch: " + endpoint;
+    }
+
+    LayersModel* layerModel = nullptr;
+    int layerIdx = -1;
+    BaseLayer* layer = nullptr;
+    std::string message = getLayerFromRequest(req, layerModel, layerIdx, layer);
+    if (!layer) {
+        return message;
+    }
+
+    if (!valueParam.empty()) {
+        if (!req.has_param(valueParam)) {
+            return "Missing " + valueParam + " parameter";
+        }
+        int value = 0;
+        if (!stringToInt(req.get_param_value(valueParam), value)) {
+            return "Could not interpret " + valueParam + " parameter";
+        }
+        if (value < 0 || value > 100) {
+            return "Parameter " + valueParam + " must be between 0 and 100";
+        }
+        return "";
+    }
+
+    bool hasParam = false;
+    for (const auto& param : planeParams) {
+        if (req.has_param(param)) {
+            int value = 0;
+            if (!stringToInt(req.get_param_value(param), value)) {
+                return "Could not interpret " + param + " parameter";
+            }
+            hasParam = true;
+        }
+    }
+    if (!hasParam) {
+        return "Missing plane parameter";
+    }
+    return "";
+}
+
+const std::string HttpServerThread::applyBatchOperation(const std::string& endpoint, const httplib::Request& req) {
+    if (endpoint == "/layer_volume") {
+        return SetLayerVolumeFromRequest(req);
+    }
+    else if (endpoint == "/layer_visibility") {
+        return SetLayerVisibilityFromRequest(req);
+    }
+    else if (endpoint == "/layer_plane") {
+        return SetLayerPlaneFromRequest(req);
+    }
+    else if (endpoint == "/select_from_slides") {
+        return SelectIndexFromSlides(req.get_param_value("index"));
+    }
+    else if (endpoint == "/load_from_slides") {
+        return LoadIndexFromSlides(req.get_param_value("index"));
+    }
+    return "";
+}
+
 void HttpServerThread::setMpv(MpvObject *mpv) {
     if (m_mpv == mpv) {
         return;
     }
     m_mpv = mpv;
+    m_mediaChanged = true;
+    if (!m_mpv) {
+        return;
+    }
+
+    auto setMediaChanged = [this]() {
+        m_mediaChanged = true;
+    };
+    connect(m_mpv, &MpvObject::fileLoaded, this, setMediaChanged);
+    connect(m_mpv, &MpvObject::audioIdChanged, this, setMediaChanged);
+    connect(m_mpv, &MpvObject::audioTracksModelChanged, this, setMediaChanged);
+    connect(m_mpv->getPlaySectionsModel(), &PlaySectionsModel::currentEditItemChanged, this, setMediaChanged);
+    connect(m_mpv->getPlaySectionsModel(), &PlaySectionsModel::currentEditItemIsEditedChanged, this, setMediaChanged);
+    connect(m_mpv->getPlayListModel(), &PlayListModel::playListIsEditedChanged, this, setMediaChanged);
+    connectModelChanges(m_mpv->getPlayListModel(), m_mediaChanged);
+    connectModelChanges(m_mpv->getPlaySectionsModel(), m_mediaChanged);
+    connectModelChanges(m_mpv->audioTracksModel(), m_mediaChanged);
 }
 
 void HttpServerThread::setSlidesModel(SlidesModel* sm) {
@@ -1509,4 +2044,21 @@ void HttpServerThread::setSlidesModel(SlidesModel* sm) {
         return;
     }
     m_slidesModel = sm;
+    m_titlesChanged = true;
+    if (!m_slidesModel) {
+        return;
+    }
+
+    // Changes of the slides forward slideModelChanged, the master slide is connected itself
+    auto setTitlesChanged = [this]() {
+        m_titlesChanged = true;
+    };
+    connect(m_slidesModel, &SlidesModel::slideModelChanged, this, setTitlesChanged);
+    connect(m_slidesModel, &SlidesModel::slidesNameChanged, this, setTitlesChanged);
+    connect(m_slidesModel, &SlidesModel::presentationHasLoaded, this, setTitlesChanged);
+    connectModelChanges(m_slidesModel, m_titlesChanged);
+    if (m_slidesModel->masterSlide()) {
+        connect(m_slidesModel->masterSlide(), &LayersModel::layersModelChanged, this, setTitlesChanged);
+        connect(m_slidesModel->masterSlide(), &LayersModel::layersNameChanged, this, setTitlesChanged);
+    }
 }
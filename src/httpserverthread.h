@@ -8,19 +8,34 @@
 #ifndef HTTPSERVERTHREAD_H
 #define HTTPSERVERTHREAD_H
 
+#include "httpservermetrics.h"
+#include "httpserverstate.h"
+#include <QJsonArray>
+#include <QJsonObject>
 #include <QMutex>
 #include <QSize>
 #include <QThread>
 #include <QWaitCondition>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
 #ifdef OPENSSL_SUPPORT
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #endif
+#ifdef ZLIB_SUPPORT
+#define CPPHTTPLIB_ZLIB_SUPPORT
+#endif
 #include <cpp-httplib/httplib.h>
 
 class MpvObject;
 class SlidesModel;
 class LayersModel;
 class BaseLayer;
+class QAbstractItemModel;
+class QTimer;
 
 class HttpServerThread : public QThread {
     Q_OBJECT
@@ -82,10 +97,14 @@ private:
     void setViewModeFromStr(std::string volumeLevelStr);
     void setSyncImageFadingFromStr(std::string valueStr);
 
+    // Replies 304 without a body when the client already has this content
+    // The etag is compared with If-None-Match before content is called to build the body
+    void setContentWithETag(const httplib::Request &req, httplib::Response &res, const std::string &etag,
+                            const std::function<std::string()> &content, const std::string &contentType);
+
     const std::string getAudioTracksItems(std::string charsPerItemStr = "", std::string removeLoadedFilePrefix = "");
     const std::string getPlayListItems(std::string charsPerItemStr = "");
     const std::string getSectionsItems(std::string charsPerItemStr = "");
-    const std::string getSlideItems(std::string charsPerItemStr = "");
     const std::string getLayerItems(std::string slideName = "Master", std::string charsPerItemStr = "");
     const std::string getLayerItems(int slideIdx = -1, std::string charsPerItemStr = "");
 
@@ -101,12 +120,71 @@ private:
     const std::string SelectIndexFromSlides(std::string indexStr);
 
     const std::string getLayerFromRequest(const httplib::Request& req, LayersModel* &lm, int &layerIdx, BaseLayer* &resolvedLayer);
+    // Same lookup in the published state, for the read endpoints
+    const std::string getLayerFromState(const httplib::Request& req, const HttpServerState &state, const HttpServerState::Layer* &resolvedLayer);
+    const std::string SetLayerVolumeFromRequest(const httplib::Request& req);
+    const std::string SetLayerVisibilityFromRequest(const httplib::Request& req);
+    const std::string SetLayerPlaneFromRequest(const httplib::Request& req);
+
+    // Batched commands (/batch). Every operation is validated before any of them is
+    // applied, and they are applied on the GUI thread while holding the sync frame lock.
+    struct BatchOperation {
+        std::string endpoint;
+        httplib::Request request;
+        std::string error;
+        std::string result;
+    };
+    int runBatch(const QJsonArray &operations, QJsonObject &response);
+    const std::string validateBatchOperation(const std::string &endpoint, const httplib::Request &req);
+    const std::string applyBatchOperation(const std::string &endpoint, const httplib::Request &req);
+
+    // Read endpoints are served from the latest published state, which is captured
+    // on the GUI thread m_stateRate times per second while there are subscribers or
+    // recent requests. When idle, state() wakes the capture and waits for a fresh state.
+    void publishState();
+    void wakeState();
+    std::shared_ptr<const HttpServerState> state();
+    void connectModelChanges(QAbstractItemModel *model, bool &changed);
+
+    // State streaming (/subscribe). The published state is checked at m_streamRate
+    // per second while there are subscribers, and only changes are pushed.
+    void publishStreamState();
+    bool writeStreamEvent(uint64_t &lastVersion, httplib::DataSink &sink);
+    void stopStreams();
 
     MpvObject *m_mpv;
     SlidesModel* m_slidesModel;
     httplib::Server svr;
     bool runServer;
     int portServer;
+    int m_workerThreads = 0;
+    int m_keepAliveMaxCount = 100;
+    int m_keepAliveTimeout = 5;
+    HttpServerMetrics m_metrics;
+
+    QTimer* m_stateTimer;
+    int m_stateRate = 60;
+    std::atomic<std::shared_ptr<const HttpServerState>> m_state;
+    // Set when the models signal a change, so titles and lists are only rebuilt then
+    bool m_titlesChanged = true;
+    bool m_mediaChanged = true;
+    std::atomic_bool m_stateActive = false;
+    std::atomic<std::chrono::steady_clock::rep> m_lastStateRequest = 0;
+    std::mutex m_captureMutex;
+    std::condition_variable m_captureCondition;
+    uint64_t m_captureCount = 0;
+
+    QTimer* m_streamTimer;
+    int m_streamRate = 10;
+    int m_maxSubscribers = 8;
+    std::atomic_int m_streamSubscribers = 0;
+    std::mutex m_streamMutex;
+    std::condition_variable m_streamCondition;
+    QJsonObject m_streamState;
+    std::string m_streamFullEvent;
+    std::string m_streamDeltaEvent;
+    uint64_t m_streamVersion = 0;
+    bool m_streamStopping = false;
 
     QMutex mutex;
     QWaitCondition condition;
@@ -26,7 +26,6 @@
 
 #include <QOpenGLContext>
 #include <QQuickGraphicsDevice>
-#include <QTimer>
 #include <QtCore/QRunnable>
 #include <QtQuick/qquickwindow.h>
 #include <array>
@@ -52,7 +51,7 @@ static void* get_proc_address_qopengl_v2(const char* name, void* ctx) {
 }
 
 LayerQtItem::LayerQtItem()
-    : m_layerIdx(-1), m_layer(nullptr), m_ownsLayer(false), m_updatingLayer(true), m_renderer(nullptr), m_audioTracksModel(new TracksModel), m_timer(nullptr),
+    : m_layerIdx(-1), m_layer(nullptr), m_ownsLayer(false), m_updatingLayer(true), m_renderer(nullptr), m_audioTracksModel(new TracksModel),
     m_viewOffset(0, 0), m_viewSize(0, 0), m_roiOffset(0, 0), m_roiSize(0, 0) {
     connect(this, &QQuickItem::windowChanged, this, &LayerQtItem::handleWindowChanged);
 }
@@ -1321,18 +1320,31 @@ void LayerQtItem::handleWindowChanged(QQuickWindow *win) {
         connect(win, &QQuickWindow::sceneGraphInvalidated, this, &LayerQtItem::cleanup, Qt::DirectConnection);
         win->setColor(Qt::black);
 
-        if (m_timer == nullptr) {
-            m_timer = new QTimer();
-            m_timer->setInterval((1.0f / 60.0f) * 1000.0f);
+        // Slide layers are previewed at the reduced thumbnail rate,
+        // layers created and played by this item at the full rate.
+        if (m_scheduler)
+            m_scheduler->removeItem(this);
+        m_scheduler = PreviewScheduler::forWindow(win);
+        m_scheduler->addItem(this, m_ownsLayer ? PreviewScheduler::Live : PreviewScheduler::Thumbnail, [this]() {
+            return previewIsDirty();
+        });
+    }
+}
 
-            connect(m_timer, &QTimer::timeout, win, &QQuickWindow::update);
+bool LayerQtItem::previewIsDirty() {
+    if (!m_layer)
+        return false;
 
-            m_timer->start();
-        }
-    }
+    uint64_t changeCount = m_layer->changeCount();
+    bool changed = changeCount != m_seenChangeCount;
+    m_seenChangeCount = changeCount;
+    return changed || !m_layer->ready() || m_layer->isLive();
 }
 
 void LayerQtItem::cleanup() {
+    PreviewScheduler::removeItemLater(m_scheduler.data(), this);
+    m_scheduler = nullptr;
+
     delete m_renderer;
     m_renderer = nullptr;
 
@@ -1460,6 +1472,10 @@ void LayerQtItem::createLayer(int type, QString filepath){
 
     m_layer = newLayer;
     m_ownsLayer = true;
+    if (m_scheduler) {
+        m_scheduler->setItemRate(this, PreviewScheduler::Live);
+        m_scheduler->markDirty();
+    }
 }
 
 void LayerQtItem::start() {
@@ -14,7 +14,9 @@
 #include <QOpenGLVertexArrayObject>
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickWindow>
+#include <QPointer>
 #include <layers/baselayer.h>
+#include "previewscheduler.h"
 #include "tracksmodel.h"
 
 class LayerQtOpenGLObject : public QObject, protected QOpenGLFunctions {
@@ -330,6 +332,7 @@ Q_SIGNALS:
 private:
     Q_INVOKABLE void handleWindowChanged(QQuickWindow *win);
     void releaseResources() override;
+    bool previewIsDirty();
 
     int m_layerIdx;
     BaseLayer *m_layer;
@@ -337,7 +340,8 @@ private:
     bool m_updatingLayer;
     LayerQtOpenGLObject *m_renderer;
     TracksModel* m_audioTracksModel;
-    QTimer *m_timer;
+    QPointer<PreviewScheduler> m_scheduler;
+    uint64_t m_seenChangeCount = 0;
 
     QPoint m_viewOffset;
     QSize m_viewSize;
@@ -133,6 +133,9 @@ void AdaptiveVideoLayer::initializeAndLoad(std::string filePath) {
 }
 
 void AdaptiveVideoLayer::loadFile(std::string filePath, bool reload) {
+    // MPV may still be waiting for a decoder instance from initializeAndLoad()
+    mpvVideoLayer->continueInitialize();
+
     if (!filePath.empty()) {
         // Check which library (MPV or MDK) we should start using based on file name.
         if (std::filesystem::exists(filePath)) {
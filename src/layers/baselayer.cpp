@@ -15,6 +15,7 @@
 #endif
 #include <sgct/opengl.h>
 #include <sgct/shareddata.h>
+#include <type_traits>
 #ifdef AUDIO_LAYER
 #include "audiosettings.h"
 #endif
@@ -539,6 +540,7 @@ void BaseLayer::encodeFull(std::vector<std::byte>& data) {
     encodeBaseCore(data);
     encodeBaseAlways(data);
     encodeBaseProperties(data);
+    encodeTimeline(data);
     encodeTypeCore(data);
     encodeTypeAlways(data);
     encodeTypeProperties(data);
@@ -547,6 +549,7 @@ void BaseLayer::decodeFull(const std::vector<std::byte>& data, unsigned int& pos
     decodeBaseCore(data, pos);
     decodeBaseAlways(data, pos);
     decodeBaseProperties(data, pos);
+    decodeTimeline(data, pos);
     decodeTypeCore(data, pos);
     decodeTypeAlways(data, pos);
     decodeTypeProperties(data, pos);
@@ -603,8 +606,48 @@ bool BaseLayer::needSync() const {
     return false;
 }
 
-void BaseLayer::setHasSynced() {
-    if (m_syncIteration > 0) {
+uint64_t BaseLayer::changeCount() const {
+    uint64_t count = m_changeCount.load();
+    if (hasSubLayers()) {
+        for (const auto& sublayer : getSubLayers()) {
+            if (sublayer)
+                count += sublayer->changeCount();
+        }
+    }
+    return count;
+}
+
+bool BaseLayer::isLive() {
+    if (hasTimeline())
+        return true;
+    if (!ready())
+        return false;
+
+    switch (type()) {
+#ifdef NDI_SUPPORT
+    case NDI:
+#endif
+#ifdef OMT_SUPPORT
+    case OMT:
+#endif
+#ifdef SPOUT_SUPPORT
+    case SPOUT:
+#endif
+#ifdef STREAM_LAYER
+    case STREAM:
+#endif
+        return true;
+    default:
+        return renderingIsOn() && !pause();
+    }
+}
+
+void BaseLayer::setHasSynced(bool allIterations) {
+    if (allIterations) {
+        m_syncIteration = 0;
+        m_needSync = false;
+    }
+    else if (m_syncIteration > 0) {
         m_syncIteration--;
     }
     else {
@@ -614,7 +657,7 @@ void BaseLayer::setHasSynced() {
     if (hasSubLayers()) {
         for (const auto& sublayer : getSubLayers()) {
             if (sublayer)
-                sublayer->setHasSynced();
+                sublayer->setHasSynced(allIterations);
         }
     }
 }
@@ -832,7 +875,9 @@ const glm::vec3 &BaseLayer::rotate() const {
 
 void BaseLayer::setRotate(glm::vec3 &r) {
     renderData.rotate = r;
-    setNeedSync();
+    // Nodes evaluate a playing timeline themselves
+    if (!hasTimeline())
+        setNeedSync();
 }
 
 const glm::vec3 &BaseLayer::translate() const {
@@ -841,9 +886,146 @@ const glm::vec3 &BaseLayer::translate() const {
 
 void BaseLayer::setTranslate(glm::vec3 &t) {
     renderData.translate = t;
+    if (!hasTimeline())
+        setNeedSync();
+}
+
+void BaseLayer::setTimeline(std::shared_ptr<const TimelineTrack> track, const TimelinePlayback &playback) {
+    std::shared_ptr<const TimelineState> current = m_timeline.load();
+    if (current && current->track == track && current->playback == playback)
+        return;
+
+    auto state = std::make_shared<TimelineState>();
+    state->track = std::move(track);
+    state->playback = playback;
+    m_timeline.store(state);
     setNeedSync();
 }
 
+void BaseLayer::clearTimeline() {
+    if (!m_timeline.load())
+        return;
+    m_timeline.store(nullptr);
+    // Full sync so nodes get the values the timeline stopped at
+    setNeedSync();
+}
+
+bool BaseLayer::hasTimeline() const {
+    return m_timeline.load() != nullptr;
+}
+
+void BaseLayer::updateTimeline(int64_t clockMs) {
+    std::shared_ptr<const TimelineState> state = m_timeline.load();
+    if (!state || !state->track)
+        return;
+
+    const TimelineTrack &track = *state->track;
+    int posMs = state->playback.positionAt(clockMs);
+    if (!track.alpha.empty())
+        setAlpha(track.alpha.evaluate(posMs) * state->playback.alphaScale);
+    if (!track.rotate.empty())
+        renderData.rotate = track.evaluateRotate(posMs);
+    if (!track.translate.empty())
+        renderData.translate = track.translate.evaluate(posMs);
+}
+
+template <typename T>
+static void encodeTimelineChannel(std::vector<std::byte>& data, const TimelineChannel<T>& channel) {
+    sgct::serializeObject(data, static_cast<uint32_t>(channel.keys().size()));
+    for (const auto &key : channel.keys()) {
+        sgct::serializeObject(data, key.timeMs);
+        if constexpr (std::is_same_v<T, float>) {
+            sgct::serializeObject(data, key.value);
+        }
+        else {
+            sgct::serializeObject(data, key.value.x);
+            sgct::serializeObject(data, key.value.y);
+            sgct::serializeObject(data, key.value.z);
+        }
+        sgct::serializeObject(data, static_cast<uint8_t>(key.easing));
+        if (key.easing == TimelineEasing::CubicBezier) {
+            sgct::serializeObject(data, key.bezier.x);
+            sgct::serializeObject(data, key.bezier.y);
+            sgct::serializeObject(data, key.bezier.z);
+            sgct::serializeObject(data, key.bezier.w);
+        }
+    }
+}
+
+template <typename T>
+static void decodeTimelineChannel(const std::vector<std::byte>& data, unsigned int& pos, TimelineChannel<T>& channel) {
+    uint32_t numKeys = 0;
+    sgct::deserializeObject(data, pos, numKeys);
+    for (uint32_t i = 0; i < numKeys && pos < data.size(); i++) {
+        int timeMs = 0;
+        T value = T(0);
+        sgct::deserializeObject(data, pos, timeMs);
+        if constexpr (std::is_same_v<T, float>) {
+            sgct::deserializeObject(data, pos, value);
+        }
+        else {
+            sgct::deserializeObject(data, pos, value.x);
+            sgct::deserializeObject(data, pos, value.y);
+            sgct::deserializeObject(data, pos, value.z);
+        }
+        uint8_t easing = 0;
+        glm::vec4 bezier(0.f, 0.f, 1.f, 1.f);
+        sgct::deserializeObject(data, pos, easing);
+        if (static_cast<TimelineEasing>(easing) == TimelineEasing::CubicBezier) {
+            sgct::deserializeObject(data, pos, bezier.x);
+            sgct::deserializeObject(data, pos, bezier.y);
+            sgct::deserializeObject(data, pos, bezier.z);
+            sgct::deserializeObject(data, pos, bezier.w);
+        }
+        channel.append(timeMs, value, static_cast<TimelineEasing>(easing), bezier);
+    }
+}
+
+void BaseLayer::encodeTimeline(std::vector<std::byte>& data) const {
+    std::shared_ptr<const TimelineState> state = m_timeline.load();
+    bool hasTrack = state && state->track;
+    sgct::serializeObject(data, hasTrack);
+    if (!hasTrack)
+        return;
+
+    const TimelinePlayback &playback = state->playback;
+    sgct::serializeObject(data, playback.anchorClockMs);
+    sgct::serializeObject(data, playback.anchorPosMs);
+    sgct::serializeObject(data, playback.rate);
+    sgct::serializeObject(data, playback.minPosMs);
+    sgct::serializeObject(data, playback.maxPosMs);
+    sgct::serializeObject(data, playback.alphaScale);
+
+    encodeTimelineChannel(data, state->track->alpha);
+    encodeTimelineChannel(data, state->track->rotate);
+    encodeTimelineChannel(data, state->track->translate);
+}
+
+void BaseLayer::decodeTimeline(const std::vector<std::byte>& data, unsigned int& pos) {
+    bool hasTrack = false;
+    sgct::deserializeObject(data, pos, hasTrack);
+    if (!hasTrack) {
+        m_timeline.store(nullptr);
+        return;
+    }
+
+    auto state = std::make_shared<TimelineState>();
+    TimelinePlayback &playback = state->playback;
+    sgct::deserializeObject(data, pos, playback.anchorClockMs);
+    sgct::deserializeObject(data, pos, playback.anchorPosMs);
+    sgct::deserializeObject(data, pos, playback.rate);
+    sgct::deserializeObject(data, pos, playback.minPosMs);
+    sgct::deserializeObject(data, pos, playback.maxPosMs);
+    sgct::deserializeObject(data, pos, playback.alphaScale);
+
+    auto track = std::make_shared<TimelineTrack>();
+    decodeTimelineChannel(data, pos, track->alpha);
+    decodeTimelineChannel(data, pos, track->rotate);
+    decodeTimelineChannel(data, pos, track->translate);
+    state->track = track;
+    m_timeline.store(state);
+}
+
 bool BaseLayer::roiEnabled() const {
     return renderData.roiEnabled;
 }
@@ -979,6 +1161,10 @@ bool BaseLayer::hasPlane() const {
     return planeData.mesh != nullptr;
 }
 
+glm::vec2 BaseLayer::planeActualSize() const {
+    return planeData.actualSize;
+}
+
 void BaseLayer::updatePlane() {
     if (renderData.width <= 0 || renderData.height <= 0)
         return;
@@ -1055,6 +1241,7 @@ void BaseLayer::updateIdentifierBasedOnCount() {
 
 void BaseLayer::setNeedSync() {
     m_needSync = true;
+    m_changeCount++;
 #ifdef NETWORK_SYNC_SETTINGS
     m_syncIteration = PresentationSettings::networkSyncIterations();
 #else
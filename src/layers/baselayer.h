@@ -9,10 +9,13 @@
 #define BASELAYER_H
 
 #include <glm/glm.hpp>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include "track.h"
 #include <utils/planegrid.h>
+#include <utils/timelinetrack.h>
 
 class BaseLayer {
 public:
@@ -213,7 +216,13 @@ public:
     void setEnabled(bool enabled);
 
     bool needSync() const;
-    void setHasSynced();
+    // allIterations: the sync went out reliably, skip the remaining NetworkSyncIterations
+    void setHasSynced(bool allIterations = false);
+
+    // Bumped on every property change, so previews can skip redraws while it is unchanged
+    uint64_t changeCount() const;
+    // True while the layer produces new frames on its own (playback, live sources, timelines)
+    bool isLive();
 
     LayerType type() const;
     void setType(LayerType t);
@@ -269,6 +278,13 @@ public:
     const glm::vec3 &translate() const;
     void setTranslate(glm::vec3 &t);
 
+    // Keyframe timeline that nodes evaluate locally while it plays.
+    // Synced once with the full layer sync instead of the values every frame.
+    void setTimeline(std::shared_ptr<const TimelineTrack> track, const TimelinePlayback &playback);
+    void clearTimeline();
+    bool hasTimeline() const;
+    void updateTimeline(int64_t clockMs);
+
     bool roiEnabled() const;
     void setRoiEnabled(bool value);
 
@@ -307,6 +323,8 @@ public:
 
     void drawPlane() const;
     bool hasPlane() const;
+    // Size of the current plane mesh, in the same unit as planeWidth/Height
+    glm::vec2 planeActualSize() const;
     void updatePlane();
 
     void setIsMaster(bool value);
@@ -317,6 +335,8 @@ public:
 
 protected:
     void setNeedSync();
+    void encodeTimeline(std::vector<std::byte>& data) const;
+    void decodeTimeline(const std::vector<std::byte>& data, unsigned int& pos);
 
     LayerType m_type;
     LayerHierarchy m_hierachy;
@@ -336,6 +356,7 @@ protected:
     bool m_needSync;
     bool m_pendingStart;
     int m_syncIteration;
+    std::atomic<uint64_t> m_changeCount = 0;
 
     mutable std::mutex m_updateMutex;
     mutable std::mutex m_updateFrameMutex;
@@ -343,6 +364,12 @@ protected:
     RenderParams renderData;
     PlaneParams planeData;
 
+    struct TimelineState {
+        std::shared_ptr<const TimelineTrack> track;
+        TimelinePlayback playback;
+    };
+    std::atomic<std::shared_ptr<const TimelineState>> m_timeline;
+
     uint32_t m_identifier;
     static std::atomic_uint32_t m_id_gen;
 };
@@ -9,6 +9,7 @@
 #include "imagesettings.h"
 #include <QString>
 #include <sgct/opengl.h>
+#include <utils/frameprofiler.h>
 
 #ifdef WUFFS_SUPPORT
 #include "../utils/wuffsimage.h"
@@ -303,6 +304,7 @@ void ImageLayer::initialize() {
 }
 
 void ImageLayer::update(bool updateRendering) {
+    FrameProfiler::Scope profileScope("update", this);
     const std::string currentPath = filepath();
     const bool fileChanged = m_ctx ? (m_ctx->filename != currentPath) : !currentPath.empty();
     if (updateRendering || !ready())
@@ -312,6 +314,7 @@ void ImageLayer::update(bool updateRendering) {
 }
 
 void ImageLayer::updateFrame() {
+    FrameProfiler::Scope profileScope("updateFrame", this, true);
     if (!m_ctx || !m_ctx->multiFrame || !ready())
         return;
 
@@ -2,6 +2,9 @@
 #include <fmt/core.h>
 #include <sgct/opengl.h>
 #include <sgct/sgct.h>
+#include <utils/frameprofiler.h>
+#include <utils/renderprecision.h>
+#include "playbacksettings.h"
 #include <mdk/MediaInfo.h>
 #include <mdk/RenderAPI.h>
 #include <mdk/Player.h>
@@ -59,6 +62,9 @@ void MdkLayer::initializeGL() {
             auto& c = m_player->mediaInfo().video[0].codec;
             renderData.width = c.width;
             renderData.height = c.height;
+            // MDK only reports the pixel format here, not the transfer characteristics
+            m_data.videoInternalFormat = RenderPrecision::videoInternalFormat(PlaybackSettings::videoRenderPrecision(),
+                                                                              c.format_name ? c.format_name : "", "");
             m_data.updateRendering = true;
             if (m_data.fileLoadedCallback) {
                 m_data.fileLoadedCallback(c.codec);
@@ -95,6 +101,7 @@ void MdkLayer::cleanup() {
 }
 
 void MdkLayer::updateFrame() {
+    FrameProfiler::Scope profileScope("updateFrame", this, true);
     if (!m_data.mdkInitializedGL)
         return;
 
@@ -122,6 +129,7 @@ void MdkLayer::initializeAndLoad(std::string filePath) {
 }
 
 void MdkLayer::update(bool updateRendering) {
+    FrameProfiler::Scope profileScope("update", this);
     if (!m_data.mdkInitializedGL) {
         initializeGL();
     }
@@ -323,8 +331,16 @@ void MdkLayer::updateFbo() {
     checkNeededMdkFboResize();
 }
 
+unsigned int MdkLayer::textureInternalFormat() const {
+    return m_fboInternalFormat != 0 ? m_fboInternalFormat : GL_RGBA16F;
+}
+
 void MdkLayer::checkNeededMdkFboResize() {
-    if (m_data.fboWidth == renderData.width && m_data.fboHeight == renderData.height)
+    unsigned int internalFormat = m_data.videoInternalFormat;
+    if (internalFormat == 0)
+        internalFormat = GL_RGBA16F;
+
+    if (m_data.fboWidth == renderData.width && m_data.fboHeight == renderData.height && m_fboInternalFormat == internalFormat)
         return;
 
     int maxTexSize;
@@ -332,8 +348,9 @@ void MdkLayer::checkNeededMdkFboResize() {
     if (renderData.width <= 0 || renderData.height <= 0 || renderData.width > maxTexSize || renderData.height > maxTexSize)
         return;
 
-    sgct::Log::Info(std::format("New MDK FBO width:{} and height:{}", renderData.width, renderData.height));
+    sgct::Log::Info(std::format("New MDK FBO width:{} and height:{} with format {}", renderData.width, renderData.height, RenderPrecision::name(internalFormat)));
 
+    m_fboInternalFormat = internalFormat;
     createMdkFBO(renderData.width, renderData.height);
 }
 
@@ -374,7 +391,7 @@ void MdkLayer::generateTexture(unsigned int& id, int width, int height) {
 
     glBindTexture(GL_TEXTURE_2D, id);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, textureInternalFormat(), width, height, 0, GL_RGBA, RenderPrecision::pixelType(textureInternalFormat()), nullptr);
 
     // Disable mipmaps
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
@@ -3,6 +3,7 @@
 
 #include <layers/baselayer.h>
 #include <mdk/RenderAPI.h>
+#include <atomic>
 #include <functional>
 
 namespace mdk {
@@ -29,6 +30,8 @@ public:
         int fboHeight = 0;
         bool fboCreated = false;
         unsigned int fboId = 0;
+        // Render target format chosen from the loaded video, 0 until known
+        std::atomic_uint videoInternalFormat = 0;
         double timePos = 0;
         double timeToSet = 0;
         bool timeIsDirty = false;
@@ -48,6 +51,7 @@ public:
     virtual void updateFrame();
     virtual bool ready() const;
     bool hasTexture() const override;
+    unsigned int textureInternalFormat() const override;
 
     void initializeAndLoad(std::string filePath);
     void update(bool updateRendering = true);
@@ -93,6 +97,8 @@ private:
     void generateTexture(unsigned int& id, int width, int height);
 
     mdkData m_data;
+    // Internal format of the FBO texture, reallocated when the video needs another
+    unsigned int m_fboInternalFormat = 0;
     mdk::GLRenderAPI m_renderAPI;
     std::unique_ptr<mdk::Player> m_player;
     gl_adress_func_v2 m_openglProcAdr;
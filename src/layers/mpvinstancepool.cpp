@@ -0,0 +1,333 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "mpvinstancepool.h"
+#include <algorithm>
+#include <sgct/sgct.h>
+
+std::mutex MpvInstancePool::s_instanceMutex;
+bool MpvInstancePool::s_destroyed = false;
+MpvInstancePool* MpvInstancePool::_instance = nullptr;
+
+// Options that are not restored between leases. Setting profile or include
+// applies them again, and pause is left as release() set it.
+static bool keepOptionOnRelease(const std::string& name) {
+    return name == "profile" || name == "include" || name == "playlist" || name == "pause";
+}
+
+static void on_mpv_wakeup(void* ctx) {
+    // Called from mpv internals, so no mpv API calls allowed in here.
+    MpvInstancePool::Instance* inst = static_cast<MpvInstancePool::Instance*>(ctx);
+    {
+        std::lock_guard<std::mutex> lock(inst->wakeMutex);
+        inst->wakeup = true;
+    }
+    inst->wakeCond.notify_one();
+}
+
+MpvInstancePool::MpvInstancePool() {
+}
+
+MpvInstancePool::~MpvInstancePool() {
+    std::vector<std::unique_ptr<Instance>> instances;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        instances = std::move(m_instances);
+        m_instances.clear();
+    }
+    for (auto& inst : instances) {
+        destroyInstance(std::move(inst));
+    }
+}
+
+void MpvInstancePool::destroy() {
+    MpvInstancePool* pool = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s_instanceMutex);
+        pool = _instance;
+        _instance = nullptr;
+        s_destroyed = true;
+    }
+    delete pool;
+}
+
+MpvInstancePool* MpvInstancePool::instance() {
+    std::lock_guard<std::mutex> lock(s_instanceMutex);
+    if (!_instance && !s_destroyed) {
+        _instance = new MpvInstancePool();
+    }
+    return _instance;
+}
+
+void MpvInstancePool::setLimits(int maxInstances, int maxIdleInstances) {
+    std::vector<std::unique_ptr<Instance>> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        m_maxInstances = std::max(0, maxInstances);
+        m_maxIdleInstances = std::max(0, maxIdleInstances);
+
+        int idle = static_cast<int>(std::count_if(m_instances.begin(), m_instances.end(),
+            [](const std::unique_ptr<Instance>& inst) { return !inst->leased; }));
+        for (auto it = m_instances.begin(); it != m_instances.end() && idle > m_maxIdleInstances;) {
+            if (!(*it)->leased) {
+                evicted.push_back(std::move(*it));
+                it = m_instances.erase(it);
+                idle--;
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+    for (auto& inst : evicted) {
+        destroyInstance(std::move(inst));
+    }
+
+    sgct::Log::Info(std::format("MPV instance pool: max {} instances ({} idle)", m_maxInstances, m_maxIdleInstances));
+}
+
+int MpvInstancePool::maxInstances() const {
+    return m_maxInstances;
+}
+
+int MpvInstancePool::maxIdleInstances() const {
+    return m_maxIdleInstances;
+}
+
+int MpvInstancePool::numInstances() const {
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    return static_cast<int>(m_instances.size());
+}
+
+int MpvInstancePool::numLeasedInstances() const {
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    return static_cast<int>(std::count_if(m_instances.begin(), m_instances.end(),
+        [](const std::unique_ptr<Instance>& inst) { return inst->leased.load(); }));
+}
+
+MpvInstancePool::Instance* MpvInstancePool::acquire(uint32_t profile, HandleCallback preInit, ConfigureCallback configure, HandleCallback events) {
+    Instance* leased = nullptr;
+    std::unique_ptr<Instance> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+
+        // Reuse an idle instance with the same profile
+        auto idle = std::find_if(m_instances.begin(), m_instances.end(),
+            [profile](const std::unique_ptr<Instance>& inst) { return !inst->leased && inst->profile == profile; });
+        if (idle != m_instances.end()) {
+            leased = idle->get();
+            leased->leased = true;
+            {
+                std::lock_guard<std::mutex> instLock(leased->mutex);
+                leased->configure = configure;
+                leased->events = events;
+                leased->leaseId = m_nextLeaseId++;
+                leased->pendingConfigure = true;
+            }
+        }
+        else {
+            if (m_maxInstances > 0 && static_cast<int>(m_instances.size()) >= m_maxInstances) {
+                // At capacity: make room by dropping an idle instance of another profile
+                auto other = std::find_if(m_instances.begin(), m_instances.end(),
+                    [](const std::unique_ptr<Instance>& inst) { return !inst->leased; });
+                if (other == m_instances.end()) {
+                    return nullptr;
+                }
+                evicted = std::move(*other);
+                m_instances.erase(other);
+            }
+
+            auto inst = std::make_unique<Instance>();
+            inst->profile = profile;
+            inst->leased = true;
+            inst->configure = configure;
+            inst->events = events;
+            inst->leaseId = m_nextLeaseId++;
+            inst->pendingConfigure = true;
+            leased = inst.get();
+            inst->trd = std::make_unique<std::thread>(runInstance, leased, preInit);
+            m_instances.push_back(std::move(inst));
+        }
+    }
+
+    wakeInstance(leased);
+
+    if (evicted) {
+        destroyInstance(std::move(evicted));
+    }
+
+    return leased;
+}
+
+void MpvInstancePool::release(Instance* inst) {
+    if (!inst)
+        return;
+
+    {
+        // Waits for any ongoing callback of the current lessee to finish
+        std::lock_guard<std::mutex> lock(inst->mutex);
+        inst->configure = nullptr;
+        inst->events = nullptr;
+        inst->pendingConfigure = false;
+
+        if (inst->handle) {
+            mpv_unobserve_property(inst->handle, inst->leaseId);
+            int pause = 1;
+            mpv_set_property_async(inst->handle, 0, "pause", MPV_FORMAT_FLAG, &pause);
+            const char* stopCmd[] = {"stop", nullptr};
+            mpv_command_async(inst->handle, 0, stopCmd);
+            // Options are restored on the instance thread, before the next lease
+            inst->pendingReset = true;
+        }
+    }
+    wakeInstance(inst);
+
+    std::unique_ptr<Instance> evicted;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        inst->leased = false;
+
+        int idle = static_cast<int>(std::count_if(m_instances.begin(), m_instances.end(),
+            [](const std::unique_ptr<Instance>& i) { return !i->leased; }));
+        if (idle > m_maxIdleInstances || inst->failed) {
+            auto it = std::find_if(m_instances.begin(), m_instances.end(),
+                [inst](const std::unique_ptr<Instance>& i) { return i.get() == inst; });
+            if (it != m_instances.end()) {
+                evicted = std::move(*it);
+                m_instances.erase(it);
+            }
+        }
+    }
+
+    if (evicted) {
+        destroyInstance(std::move(evicted));
+    }
+}
+
+void MpvInstancePool::destroyInstance(std::unique_ptr<Instance> inst) {
+    if (!inst)
+        return;
+
+    inst->terminate = true;
+    wakeInstance(inst.get());
+
+    if (inst->trd) {
+        inst->trd->join();
+        inst->trd.reset();
+    }
+
+    if (inst->handle) {
+        mpv_terminate_destroy(inst->handle);
+        inst->handle = nullptr;
+    }
+}
+
+void MpvInstancePool::wakeInstance(Instance* inst) {
+    on_mpv_wakeup(inst);
+}
+
+void MpvInstancePool::runInstance(Instance* inst, HandleCallback preInit) {
+    {
+        std::lock_guard<std::mutex> lock(inst->mutex);
+        inst->handle = mpv_create();
+        if (!inst->handle) {
+            sgct::Log::Error("mpv context init failed");
+            inst->failed = true;
+            return;
+        }
+
+        mpv_set_option_string(inst->handle, "vo", "libmpv");
+
+        // Some minor options can only be set before mpv_initialize().
+        if (preInit) {
+            preInit(inst->handle);
+        }
+
+        if (mpv_initialize(inst->handle) < 0) {
+            sgct::Log::Error("mpv init failed");
+            mpv_terminate_destroy(inst->handle);
+            inst->handle = nullptr;
+            inst->failed = true;
+            return;
+        }
+
+        captureOptions(inst);
+        mpv_set_wakeup_callback(inst->handle, on_mpv_wakeup, inst);
+    }
+
+    while (!inst->terminate) {
+        {
+            std::lock_guard<std::mutex> lock(inst->mutex);
+            if (inst->pendingReset) {
+                inst->pendingReset = false;
+                restoreOptions(inst);
+            }
+
+            if (inst->pendingConfigure) {
+                if (inst->configure) {
+                    inst->configure(inst->handle, inst->leaseId);
+                }
+                inst->pendingConfigure = false;
+            }
+
+            if (inst->events) {
+                inst->events(inst->handle);
+            }
+            else {
+                // Nobody is listening, just empty the queue
+                while (mpv_wait_event(inst->handle, 0)->event_id != MPV_EVENT_NONE) {
+                }
+            }
+        }
+
+        // Sleep until mpv has something for us. The timeout makes sure events left
+        // in the queue by an early return from the event callback are handled as well.
+        std::unique_lock<std::mutex> lock(inst->wakeMutex);
+        inst->wakeCond.wait_for(lock, std::chrono::milliseconds(10), [inst] { return inst->wakeup || inst->terminate; });
+        inst->wakeup = false;
+    }
+}
+
+void MpvInstancePool::captureOptions(Instance* inst) {
+    mpv_node options;
+    if (mpv_get_property(inst->handle, "options", MPV_FORMAT_NODE, &options) < 0)
+        return;
+
+    if (options.format == MPV_FORMAT_NODE_ARRAY) {
+        for (int i = 0; i < options.u.list->num; i++) {
+            const mpv_node& option = options.u.list->values[i];
+            if (option.format != MPV_FORMAT_STRING || keepOptionOnRelease(option.u.string))
+                continue;
+
+            std::string name = option.u.string;
+            char* value = mpv_get_property_string(inst->handle, ("options/" + name).c_str());
+            if (value) {
+                inst->initialOptions.emplace_back(name, value);
+                mpv_free(value);
+            }
+        }
+    }
+    mpv_free_node_contents(&options);
+}
+
+void MpvInstancePool::restoreOptions(Instance* inst) {
+    // Covers what the last lessee set itself (ab-loop, audio output, ...) as
+    // well as everything from the loaded mpv configuration files
+    int restored = 0;
+    for (const auto& [name, value] : inst->initialOptions) {
+        std::string property = "options/" + name;
+        char* current = mpv_get_property_string(inst->handle, property.c_str());
+        if (current && value != current) {
+            mpv_set_property_string(inst->handle, property.c_str(), value.c_str());
+            restored++;
+        }
+        mpv_free(current);
+    }
+
+    if (restored > 0)
+        sgct::Log::Debug(std::format("MPV instance pool: restored {} options of released instance", restored));
+}
@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef MPVINSTANCEPOOL_H
+#define MPVINSTANCEPOOL_H
+
+#include <client.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Process-wide pool of initialized mpv handles, each with its own event thread.
+//
+// Layers lease an instance when they need a decoder and hand it back when they
+// are unloaded. Returned instances are stopped and kept idle, so the next layer
+// with the same profile skips mpv_create()/mpv_initialize() and thread start-up.
+//
+// The number of concurrently existing instances can be capped (maxInstances),
+// in which case acquire() returns nullptr until another layer releases one.
+// The layer is expected to retry on its next update.
+//
+// Each lease gets its own id, which the lessee uses as reply id for
+// mpv_observe_property(). On release those observers are removed, and every
+// option is set back to its value from right after mpv_initialize(), so the
+// next lessee starts from a clean handle.
+//
+// The render context is not part of the lease, as it is bound to the GL context
+// of the leasing layer. It must be freed by the layer before calling release().
+class MpvInstancePool {
+public:
+    typedef std::function<void(mpv_handle* handle)> HandleCallback;
+    typedef std::function<void(mpv_handle* handle, uint64_t leaseId)> ConfigureCallback;
+
+    struct Instance {
+        mpv_handle* handle = nullptr;
+        uint32_t profile = 0;
+        std::unique_ptr<std::thread> trd;
+
+        // Callbacks of the current lessee, only invoked on the instance thread
+        // while holding mutex.
+        std::mutex mutex;
+        ConfigureCallback configure = nullptr;
+        HandleCallback events = nullptr;
+        uint64_t leaseId = 0;
+        bool pendingConfigure = false;
+        bool pendingReset = false;
+
+        // Set when mpv failed to start on the instance
+        std::atomic_bool failed = false;
+
+        // Option values right after mpv_initialize(), restored between leases
+        std::vector<std::pair<std::string, std::string>> initialOptions;
+
+        // Wake-up signalling from mpv (and pool) to the instance thread
+        std::mutex wakeMutex;
+        std::condition_variable wakeCond;
+        bool wakeup = false;
+
+        std::atomic_bool leased = false;
+        std::atomic_bool terminate = false;
+    };
+
+    MpvInstancePool();
+    ~MpvInstancePool();
+    // Destroys the pool for good, once no thread uses layers any more.
+    // instance() returns nullptr from then on.
+    static void destroy();
+    static MpvInstancePool* instance();
+
+    // maxInstances: max number of mpv instances alive at once (0 = unlimited)
+    // maxIdleInstances: max number of released instances kept for reuse
+    void setLimits(int maxInstances, int maxIdleInstances);
+    int maxInstances() const;
+    int maxIdleInstances() const;
+
+    int numInstances() const;
+    int numLeasedInstances() const;
+
+    // Lease an instance with a matching profile (reusing an idle one if possible).
+    // preInit is only called when a new handle is created, before mpv_initialize().
+    // configure is called once on the instance thread when the lease starts.
+    // events is called on the instance thread whenever mpv signals new events.
+    // Returns nullptr if the pool is at capacity.
+    Instance* acquire(uint32_t profile, HandleCallback preInit, ConfigureCallback configure, HandleCallback events);
+
+    // Return a leased instance to the pool. The loaded file is stopped and the
+    // callbacks are detached before this returns, so the lessee may be destroyed.
+    // Instances that failed to start are destroyed instead of kept idle.
+    void release(Instance* inst);
+
+private:
+    void destroyInstance(std::unique_ptr<Instance> inst);
+    static void wakeInstance(Instance* inst);
+    static void runInstance(Instance* inst, HandleCallback preInit);
+    static void captureOptions(Instance* inst);
+    static void restoreOptions(Instance* inst);
+
+    mutable std::mutex m_poolMutex;
+    std::vector<std::unique_ptr<Instance>> m_instances;
+    int m_maxInstances = 0;
+    int m_maxIdleInstances = 4;
+    uint64_t m_nextLeaseId = 1;
+
+    static std::mutex s_instanceMutex;
+    static bool s_destroyed;
+    static MpvInstancePool* _instance;
+};
+
+#endif // MPVINSTANCEPOOL_H
@@ -6,11 +6,15 @@
  */
 
 #include "mpvlayer.h"
+#include "mpvinstancepool.h"
 #include "application.h"
 #include "audiosettings.h"
+#include "playbacksettings.h"
 #include "track.h"
 #include "qthelper.h"
 #include <sgct/sgct.h>
+#include <utils/frameprofiler.h>
+#include <utils/renderprecision.h>
 
 //#define TEST_STREAM_NODE_ONLY
 
@@ -86,6 +90,10 @@ void on_mpv_events(MpvLayer::mpvData &vd, BaseLayer::RenderParams) {
             break;
         }
         case MPV_EVENT_PROPERTY_CHANGE: {
+            // Skip changes still queued from observers of an earlier lease
+            if (event->reply_userdata != vd.observeId)
+                break;
+
             mpv_event_property *prop = (mpv_event_property *)event->data;
             if (strcmp(prop->name, "video-params") == 0) {
                 if (prop->format == MPV_FORMAT_NODE) {
@@ -93,6 +101,14 @@ void on_mpv_events(MpvLayer::mpvData &vd, BaseLayer::RenderParams) {
                     auto vm = videoParams.toMap();
                     vd.pendingWidth = vm[QStringLiteral("w")].toInt();
                     vd.pendingHeight = vm[QStringLiteral("h")].toInt();
+
+                    // Hardware decoded video has the actual format in hw-pixelformat
+                    QString pixelFormat = vm[QStringLiteral("hw-pixelformat")].toString();
+                    if (pixelFormat.isEmpty())
+                        pixelFormat = vm[QStringLiteral("pixelformat")].toString();
+                    vd.videoInternalFormat = RenderPrecision::videoInternalFormat(PlaybackSettings::videoRenderPrecision(),
+                                                                                  pixelFormat.toStdString(),
+                                                                                  vm[QStringLiteral("gamma")].toString().toStdString());
                 }
             } else if (strcmp(prop->name, "pause") == 0) {
                 if (prop->format == MPV_FORMAT_FLAG) {
@@ -176,22 +192,26 @@ void on_mpv_events(MpvLayer::mpvData &vd, BaseLayer::RenderParams) {
     }
 }
 
-void initMPV(MpvLayer::mpvData& vd) {
-    vd.handle = mpv_create();
-    if (!vd.handle)
-        sgct::Log::Error("mpv context init failed");
+uint32_t poolProfile(const MpvLayer::mpvData& vd) {
+    // Pooled handles are only shared between layers that set them up identically
+    uint32_t profile = 0;
+    profile |= vd.supportVideo ? 1u : 0u;
+    profile |= vd.isStream ? 2u : 0u;
+    profile |= vd.isMaster ? 4u : 0u;
+    profile |= vd.loggingOn ? 8u : 0u;
+    profile |= vd.allowDirectRendering ? 16u : 0u;
+    return profile;
+}
 
-    mpv_set_option_string(vd.handle, "vo", "libmpv");
+void preInitMPV(const MpvLayer::mpvData& vd, mpv_handle* handle) {
     if (vd.loggingOn) {
-        mpv_set_option_string(vd.handle, "terminal", "yes");
-        mpv_set_option_string(vd.handle, "msg-level", "all=v");
-        mpv_request_log_messages(vd.handle, vd.logLevel.c_str());
+        mpv_set_option_string(handle, "terminal", "yes");
+        mpv_set_option_string(handle, "msg-level", "all=v");
+        mpv_request_log_messages(handle, vd.logLevel.c_str());
     }
+}
 
-    // Some minor options can only be set before mpv_initialize().
-    if (mpv_initialize(vd.handle) < 0)
-        sgct::Log::Error("mpv init failed");
-
+void initMPV(MpvLayer::mpvData& vd) {
     // Set EOF mode
     if (vd.eofMode == 0) { // Pause
         mpv::qt::set_property_async(vd.handle, QStringLiteral("keep-open"), QStringLiteral("yes"));
@@ -282,26 +302,15 @@ void initMPV(MpvLayer::mpvData& vd) {
         }
     }
 
-    // Observe media parameters
+    // Observe media parameters (removed by the pool when the lease ends)
     if (vd.supportVideo) {
-        mpv_observe_property(vd.handle, 0, "video-params", MPV_FORMAT_NODE);
+        mpv_observe_property(vd.handle, vd.observeId, "video-params", MPV_FORMAT_NODE);
     }
-    mpv_observe_property(vd.handle, 0, "pause", MPV_FORMAT_FLAG);
-    mpv_observe_property(vd.handle, 0, "time-pos", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(vd.handle, 0, "duration", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(vd.handle, vd.observeId, "pause", MPV_FORMAT_FLAG);
+    mpv_observe_property(vd.handle, vd.observeId, "time-pos", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(vd.handle, vd.observeId, "duration", MPV_FORMAT_DOUBLE);
 }
 
-auto runMpvAsync = [](MpvLayer::mpvData& data, BaseLayer::RenderParams& rp) {
-    data.threadRunning = true;
-    initMPV(data);
-    data.mpvInitialized = true;
-    while (!data.terminate) {
-        on_mpv_events(data, rp);
-    }
-    data.threadDone = true;
-    data.threadRunning = false;
-};
-
 MpvLayer::MpvLayer(gl_adress_func_v1 opa,
     bool allowDirectRendering,
     bool loggingOn,
@@ -321,10 +330,38 @@ void MpvLayer::initialize() {
 }
 
 void MpvLayer::initializeMpv() {
-    // Run MPV on another thread
+    // Lease an MPV instance (running on another thread) from the pool.
+    // If the pool is at capacity, we try again on next update.
+    if (m_data.mpvFailed)
+        return;
+
+    MpvInstancePool* pool = MpvInstancePool::instance();
+    if (!pool)
+        return;
+
     if (!m_data.threadRunning) {
-        m_data.threadRunning = true;
-        m_data.trd = std::make_unique<std::thread>(runMpvAsync, std::ref(m_data), std::ref(renderData));
+        m_data.lease = pool->acquire(poolProfile(m_data),
+            [this](mpv_handle* handle) {
+                preInitMPV(m_data, handle);
+            },
+            [this](mpv_handle* handle, uint64_t leaseId) {
+                m_data.handle = handle;
+                m_data.observeId = leaseId;
+                initMPV(m_data);
+                m_data.mpvInitialized = true;
+            },
+            [this](mpv_handle*) {
+                on_mpv_events(m_data, renderData);
+            });
+        m_data.threadRunning = (m_data.lease != nullptr);
+    }
+    else if (m_data.lease && m_data.lease->failed) {
+        // mpv could not start on the instance, hand it back and stop trying
+        sgct::Log::Error(std::format("MPV layer {}: no working mpv instance, giving up", identifier()));
+        pool->release(m_data.lease);
+        m_data.lease = nullptr;
+        m_data.threadRunning = false;
+        m_data.mpvFailed = true;
     }
 }
 
@@ -332,21 +369,19 @@ void MpvLayer::initializeGL() {
 }
 
 void MpvLayer::cleanup() {
-    if (!m_data.mpvInitialized)
+    m_data.initializeDeferred = false;
+    if (!m_data.lease)
         return;
 
-    // Async quit
-    mpv::qt::command_async(m_data.handle, QStringList() << QStringLiteral("quit"));
-
-    // Wait for Mpv to end (running on separate thread)
-    if (m_data.trd) {
-        while (!m_data.threadDone) {
-        }
-        m_data.trd->join();
-        m_data.trd.reset();
-        mpv_destroy(m_data.handle);
-        m_data.handle = nullptr;
-    }
+    // Hand the MPV instance back to the pool (stops playback and detaches our callbacks).
+    // Once the pool is destroyed at shutdown, its instances are gone already.
+    if (MpvInstancePool* pool = MpvInstancePool::instance())
+        pool->release(m_data.lease);
+    m_data.lease = nullptr;
+    m_data.handle = nullptr;
+    m_data.loadedFile = "";
+    m_data.mpvInitialized = false;
+    m_data.threadRunning = false;
 }
 
 void MpvLayer::updateFrame() {
@@ -361,21 +396,37 @@ bool MpvLayer::hasTexture() const {
 }
 
 void MpvLayer::initializeAndLoad(std::string filePath) {
+    // The lease is configured on its instance thread. Until then, and while the
+    // pool is at capacity, continueInitialize() picks it up on later frames, so
+    // the render thread never waits for mpv.
+    m_data.initializeDeferred = true;
+    m_data.deferredFile = filePath;
+    continueInitialize();
+}
+
+bool MpvLayer::continueInitialize() {
+    if (!m_data.initializeDeferred)
+        return m_data.mpvInitialized;
+
     if (!m_data.mpvInitialized) {
         initializeMpv();
-
-        //Wait for MPV to initialize
-        while (!m_data.mpvInitialized) {}
+        if (m_data.mpvFailed)
+            m_data.initializeDeferred = false;
+        return false;
     }
 
     if (!m_data.mpvInitializedGL) {
         initializeGL();
     }
 
-    loadFile(filePath);
+    m_data.initializeDeferred = false;
+    loadFile(m_data.deferredFile);
+    m_data.deferredFile = "";
+    return true;
 }
 
 void MpvLayer::update(bool updateRendering) {
+    FrameProfiler::Scope profileScope("update", this);
     std::lock_guard<std::mutex> lock(m_updateMutex);
 
     if (!m_data.mpvInitialized) {
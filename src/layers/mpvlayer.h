@@ -10,6 +10,7 @@
 
 #include <client.h>
 #include <layers/baselayer.h>
+#include <layers/mpvinstancepool.h>
 #include <mutex>
 #include <render_gl.h>
 #include <functional>
@@ -19,9 +20,9 @@ public:
 
     typedef std::function<void(std::string codecName)> onFileLoadedCallback;
     struct mpvData {
-        mpv_handle *handle;
-        mpv_render_context *renderContext;
-        std::unique_ptr<std::thread> trd;
+        mpv_handle *handle = nullptr;
+        mpv_render_context *renderContext = nullptr;
+        MpvInstancePool::Instance *lease = nullptr;
         bool loggingOn = false;
         bool mediaIsPaused = true;
         bool mediaShouldPause = true;
@@ -47,6 +48,8 @@ public:
         int fboHeight = 0;
         int pendingWidth = 0;
         int pendingHeight = 0;
+        // Render target format chosen from the video parameters, 0 until known
+        std::atomic_uint videoInternalFormat = 0;
         bool fboCreated = false;
         unsigned int fboId = 0;
         int reconfigs = 0;
@@ -67,9 +70,14 @@ public:
         bool timeIsDirty = false;
         bool typePropertiesDecode = false;
         std::atomic_bool threadRunning = false;
+        // Lease id of the instance, used as reply id of the property observers
+        uint64_t observeId = 0;
+        // initializeAndLoad() could not finish, continueInitialize() retries
+        bool initializeDeferred = false;
+        std::string deferredFile = "";
+        bool mpvFailed = false;
         std::atomic_bool mpvInitialized = false;
         std::atomic_bool mpvInitializedGL = false;
-        std::atomic_bool threadDone = false;
         std::atomic_bool terminate = false;
         onFileLoadedCallback fileLoadedCallback = nullptr;
     };
@@ -91,6 +99,9 @@ public:
     bool hasTexture() const override;
 
     void initializeAndLoad(std::string filePath);
+    // Retries an initializeAndLoad() that could not lease an instance at once.
+    // Needs the GL context, returns true when initialized.
+    bool continueInitialize();
     void update(bool updateRendering = true);
 
     void start();
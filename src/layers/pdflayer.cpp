@@ -9,6 +9,7 @@
 #include <presentationsettings.h>
 #include <sgct/sgct.h>
 #include <sgct/opengl.h>
+#include <utils/frameprofiler.h>
 #include <cpp/poppler-page.h>
 #include <cpp/poppler-page-renderer.h>
 
@@ -127,6 +128,7 @@ void PdfLayer::initialize() {
 }
 
 void PdfLayer::update(bool updateRendering) {
+    FrameProfiler::Scope profileScope("update", this);
     std::lock_guard<std::mutex> lock(m_updateMutex);
 
     if(updateRendering || !ready())
@@ -6,8 +6,7 @@
  */
 
 #include "restlayer.h"
-#include "httpclientmodel.h"
-#include "wwsclientmodel.h"
+#include "restclientpool.h"
 #include <sgct/shareddata.h>
 
 RestLayer::RestLayer() {
@@ -21,14 +20,7 @@ RestLayer::~RestLayer() {
 
 void RestLayer::cleanup() {
     m_statusCallback = nullptr;
-    if (m_workerThread) {
-        m_workerThread->quit();
-        m_workerThread->wait();
-        delete m_workerThread;
-        m_workerThread = nullptr;
-        m_worker = nullptr;
-        m_wwsWorker = nullptr;
-    }
+    m_requestToken = std::make_shared<int>(0);
 }
 
 void RestLayer::initialize() {
@@ -52,57 +44,27 @@ void RestLayer::start() {
         return;
     }
 
-    const bool isWebSocket = useWebSocket();
-
-    if ((isWebSocket && m_worker) || (!isWebSocket && m_wwsWorker)) {
-        m_workerThread->quit();
-        m_workerThread->wait();
-        delete m_workerThread;
-        m_workerThread = nullptr;
-        m_worker = nullptr;
-        m_wwsWorker = nullptr;
-    }
-
-    // Lazily create the worker thread on first use
-    if (!m_workerThread) {
-        m_workerThread = new QThread();
-        if (isWebSocket) {
-            m_wwsWorker = new WwsRequestWorker();
-            m_wwsWorker->moveToThread(m_workerThread);
-            QObject::connect(m_workerThread, &QThread::finished, m_wwsWorker, &QObject::deleteLater);
-            QObject::connect(m_wwsWorker, &WwsRequestWorker::requestFinished,
-                [this](int statusCode, const QString &responseBody, const QString &error) {
-                    onRequestFinished(statusCode, responseBody, error);
-                });
-        } else {
-            m_worker = new HttpRequestWorker();
-            m_worker->moveToThread(m_workerThread);
-            QObject::connect(m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
-            QObject::connect(m_worker, &HttpRequestWorker::requestFinished,
-                [this](int statusCode, const QString &responseBody, const QString &error) {
-                    onRequestFinished(statusCode, responseBody, error);
-                });
-        }
-        m_workerThread->start();
-    }
-
     // Set status to "in progress" (1)
     if (m_statusCallback) {
         m_statusCallback(1);
     }
 
-    // Dispatch request to the worker thread
-    if (isWebSocket && m_wwsWorker) {
-        QMetaObject::invokeMethod(m_wwsWorker, "doRequest", Qt::QueuedConnection,
-            Q_ARG(QString, QString::fromStdString(m_url)),
-            Q_ARG(QString, QString::fromStdString(m_parameters)),
-            Q_ARG(bool, m_ignoreStatus));
-    } else if (m_worker) {
-        QMetaObject::invokeMethod(m_worker, "doRequest", Qt::QueuedConnection,
-            Q_ARG(QString, QString::fromStdString(m_url)),
-            Q_ARG(int, m_method),
-            Q_ARG(QString, QString::fromStdString(m_parameters)),
-            Q_ARG(bool, m_ignoreStatus));
+    // The callback is copied, so the result never needs this layer
+    std::weak_ptr<int> token = m_requestToken;
+    StatusCallback statusCallback = m_statusCallback;
+    auto onFinished = [token, statusCallback](int statusCode, const QString &, const QString &) {
+        if (token.expired() || !statusCallback)
+            return;
+        // status: 2=success (HTTP 2xx), 0=failure
+        statusCallback((statusCode >= 200 && statusCode < 300) ? 2 : 0);
+    };
+
+    if (useWebSocket()) {
+        RestClientPool::instance().sendWebSocketRequest(QString::fromStdString(m_url),
+            QString::fromStdString(m_parameters), m_ignoreStatus, onFinished);
+    } else {
+        RestClientPool::instance().sendHttpRequest(QString::fromStdString(m_url), m_method,
+            QString::fromStdString(m_parameters), m_ignoreStatus, onFinished);
     }
 }
 
@@ -110,18 +72,6 @@ void RestLayer::stop() {
     // Nothing to stop for an async request
 }
 
-void RestLayer::onRequestFinished(int statusCode, const QString &responseBody, const QString &error) {
-    Q_UNUSED(responseBody)
-    Q_UNUSED(error)
-
-    // status: 2=success (HTTP 2xx), 0=failure
-    int layerStatus = (statusCode >= 200 && statusCode < 300) ? 2 : 0;
-
-    if (m_statusCallback) {
-        m_statusCallback(layerStatus);
-    }
-}
-
 std::string RestLayer::url() const {
     return m_url;
 }
@@ -11,12 +11,9 @@
 #include <layers/baselayer.h>
 #include <string>
 #include <functional>
-#include <QObject>
-#include <QThread>
+#include <memory>
 
 class HttpClientModel;
-class HttpRequestWorker;
-class WwsRequestWorker;
 
 class RestLayer : public BaseLayer {
 public:
@@ -56,6 +53,7 @@ public:
     void setHttpClientModel(HttpClientModel* model);
 
     // Callback invoked on the main thread when the request finishes.
+    // Requests are sent through the shared RestClientPool.
     // The int parameter is the layer status: 2=success, 0=failure.
     using StatusCallback = std::function<void(int)>;
     void setStatusCallback(StatusCallback cb);
@@ -64,7 +62,6 @@ public:
     void decodeTypeCore(const std::vector<std::byte>& data, unsigned int& pos) override;
 
 private:
-    void onRequestFinished(int statusCode, const QString &responseBody, const QString &error);
     bool useWebSocket() const;
 
     std::string m_url;
@@ -75,9 +72,8 @@ private:
     HttpClientModel* m_httpClientModel = nullptr;
     StatusCallback m_statusCallback;
 
-    QThread* m_workerThread = nullptr;
-    HttpRequestWorker* m_worker = nullptr;
-    WwsRequestWorker* m_wwsWorker = nullptr;
+    // Results of requests still in flight are dropped once this is reset
+    std::shared_ptr<int> m_requestToken = std::make_shared<int>(0);
 };
 
 #endif // RESTLAYER_H
@@ -9,6 +9,7 @@
 #include <fmt/core.h>
 #include <sgct/opengl.h>
 #include <sgct/sgct.h>
+#include <utils/frameprofiler.h>
 
 SpoutFinder* SpoutFinder::_instance = nullptr;
 
@@ -107,6 +108,7 @@ void SpoutLayer::initialize() {
 }
 
 void SpoutLayer::update(bool updateRendering) {
+	FrameProfiler::Scope profileScope("update", this);
 	if (!ready()) {
 		return;
 	}
@@ -117,6 +119,7 @@ void SpoutLayer::update(bool updateRendering) {
 }
 
 void SpoutLayer::updateFrame() {
+	FrameProfiler::Scope profileScope("updateFrame", this, true);
 	// Let's recieve image or audio
 	if (m_receiver && ready()) {
 		unsigned int width = m_receiver->GetSenderWidth();
@@ -12,6 +12,8 @@
 #include <utils/dividetexturehandler.h>
 #include <sgct/opengl.h>
 #include <sgct/sgct.h>
+#include <utils/frameprofiler.h>
+#include <utils/renderprecision.h>
 
 StreamLayer::StreamLayer(gl_adress_func_v1 opa,
     bool allowDirectRendering,
@@ -50,6 +52,7 @@ void StreamLayer::initialize() {
 }
 
 void StreamLayer::updateFrame() {
+    FrameProfiler::Scope profileScope("updateFrame", this, true);
     if (m_typePropertiesDecoded) {
         m_typePropertiesDecoded = false;
         setQRCodeDetectionEnabled(m_qrCodeDetectionEnabled_Dec);
@@ -80,7 +83,8 @@ void StreamLayer::updateFrame() {
             // in its FBO for the next frame's ping-pong cycle.
             if (m_backupTexId > 0
                 && m_backupTexWidth == renderData.width
-                && m_backupTexHeight == renderData.height) {
+                && m_backupTexHeight == renderData.height
+                && m_backupTexFormat == textureInternalFormat()) {
                 renderData.texId = m_backupTexId;
             }
             // If no backup exists yet we have no choice but to show the
@@ -433,15 +437,17 @@ void StreamLayer::copyToBackupTexture(unsigned int srcTexId, int width, int heig
         return;
     }
 
-    // (Re-)create the backup texture if the dimensions changed
-    if (m_backupTexId == 0 || m_backupTexWidth != width || m_backupTexHeight != height) {
+    // (Re-)create the backup texture if the dimensions or the video format changed,
+    // glCopyImageSubData needs matching formats
+    unsigned int internalFormat = textureInternalFormat();
+    if (m_backupTexId == 0 || m_backupTexWidth != width || m_backupTexHeight != height || m_backupTexFormat != internalFormat) {
         if (m_backupTexId > 0) {
             glDeleteTextures(1, &m_backupTexId);
         }
 
         glGenTextures(1, &m_backupTexId);
         glBindTexture(GL_TEXTURE_2D, m_backupTexId);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, RenderPrecision::pixelType(internalFormat), nullptr);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
@@ -452,6 +458,7 @@ void StreamLayer::copyToBackupTexture(unsigned int srcTexId, int width, int heig
 
         m_backupTexWidth = width;
         m_backupTexHeight = height;
+        m_backupTexFormat = internalFormat;
     }
 
     // GPU-to-GPU copy of the clean frame into the backup texture
@@ -79,6 +79,7 @@ private:
     unsigned int m_backupTexId = 0;
     int m_backupTexWidth = 0;
     int m_backupTexHeight = 0;
+    unsigned int m_backupTexFormat = 0;
 };
 
 #endif // STREAMLAYER_H
\ No newline at end of file
@@ -9,9 +9,14 @@
 #include "application.h"
 #include <sgct/opengl.h>
 #include <sgct/sgct.h>
+#include <utils/frameprofiler.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+
+// Rasterized text blocks kept per layer (1280x720 RGBA8 is about 3.5 MB each)
+static constexpr size_t MaxCachedRasters = 8;
 
 #ifdef SGCT_HAS_TEXT
 #include <freetype/freetype.h>
@@ -62,6 +67,8 @@ TextLayer::TextLayer() {
     m_alignment = 1; // Center
     m_colorHex = "#FFFFFF";
     m_color = sgct::vec4{ 1.f, 1.f, 1.f, 1.f };
+    m_halfFloatTexture = false;
+    m_hasRaster = false;
     renderData.width = 1280;
     renderData.height = 720;
     setGridMode(BaseLayer::GridMode::Plane);
@@ -73,11 +80,10 @@ TextLayer::~TextLayer() {
 }
 
 void TextLayer::cleanup() {
+    clearRasterCache();
     if (m_data.fboCreated) {
         glDeleteFramebuffers(1, &m_data.fboId);
-        glDeleteTextures(1, &renderData.texId);
         m_data.fboId = 0;
-        renderData.texId = 0;
         m_data.fboCreated = false;
     }
 }
@@ -91,6 +97,7 @@ void TextLayer::initializeGL() {
 }
 
 void TextLayer::update(bool updateRendering) {
+    FrameProfiler::Scope profileScope("update", this);
     if (!m_data.initializedGL) {
         initializeGL();
     }
@@ -101,108 +108,180 @@ void TextLayer::update(bool updateRendering) {
 }
 
 void TextLayer::updateFrame() {
+    FrameProfiler::Scope profileScope("updateFrame", this, true);
     checkNeededFboResize();
+    if (!m_data.fboCreated)
+        return;
 
-    // If new text and rendered text is the same, we do not need to update
-    if (text() == m_data.text) {
+    RasterKey key = rasterKey();
+    if (m_hasRaster && key == m_rasterKey) {
         return;
     }
-    m_data.text = text();
-
-#ifdef SGCT_HAS_TEXT
-    if (m_fontName.empty()) {
-        sgct::Log::Warning("TextLayer: Font name is empty.");
+    m_rasterKey = key;
+    m_hasRaster = true;
+
+    auto cached = std::find_if(m_rasterCache.begin(), m_rasterCache.end(), [&key](const RasterEntry& e) {
+        return e.key == key;
+    });
+    if (cached != m_rasterCache.end()) {
+        m_rasterCache.splice(m_rasterCache.begin(), m_rasterCache, cached);
+        renderData.texId = cached->texId;
         return;
     }
-    sgct::text::Font* font = sgct::text::FontManager::instance().font(m_fontName, m_fontSize);
-    if (font == nullptr) {
-        // Trying to add the font to the font manager
-        if (!m_fontPath.empty()) {
-            if (sgct::text::FontManager::instance().addFont(m_fontName, m_fontPath, true)) {
-                font = sgct::text::FontManager::instance().font(m_fontName, m_fontSize);
-                if (font == nullptr) {
-                    sgct::Log::Warning(std::format("TextLayer: Font {} with path {} could not be added.", m_fontName, m_fontPath));
-                    return;
-                }
-            }
-            else {
-                sgct::Log::Warning(std::format("TextLayer: Font {} with path {} was not found.", m_fontName, m_fontPath));
-                return;
-            }
+
+    // Reuse the texture of the least recently used block when it has the same size and format
+    unsigned int texId = 0;
+    if (m_rasterCache.size() >= MaxCachedRasters) {
+        RasterEntry& oldest = m_rasterCache.back();
+        if (oldest.key.width == key.width && oldest.key.height == key.height && oldest.key.halfFloat == key.halfFloat) {
+            texId = oldest.texId;
         }
         else {
-            sgct::Log::Warning(std::format("TextLayer: Font path is empty for font {}", m_fontName));
-            return;
+            glDeleteTextures(1, &oldest.texId);
         }
+        m_rasterCache.pop_back();
+    }
+    if (texId == 0) {
+        generateTexture(texId, key.width, key.height, key.halfFloat);
     }
 
+    rasterize(key, texId);
+
+    m_rasterCache.push_front(RasterEntry{ key, texId });
+    renderData.texId = texId;
+}
+
+TextLayer::RasterKey TextLayer::rasterKey() const {
+    RasterKey key;
+    key.text = m_text;
+    key.fontName = m_fontName;
+    key.fontSize = m_fontSize;
+    key.alignment = m_alignment;
+    key.color = m_color;
+    key.width = m_data.fboWidth;
+    key.height = m_data.fboHeight;
+    key.halfFloat = m_halfFloatTexture;
+    return key;
+}
+
+bool TextLayer::RasterKey::operator==(const RasterKey& other) const {
+    return text == other.text && fontName == other.fontName && fontSize == other.fontSize
+        && alignment == other.alignment && color.x == other.color.x && color.y == other.color.y
+        && color.z == other.color.z && width == other.width && height == other.height
+        && halfFloat == other.halfFloat;
+}
+
+void TextLayer::rasterize(const RasterKey& key, unsigned int texId) {
     glBindFramebuffer(GL_FRAMEBUFFER, m_data.fboId);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texId, 0);
 
     GLint viewport[4];
     glGetIntegerv(GL_VIEWPORT, viewport);
-    glViewport(0, 0, m_data.fboWidth, m_data.fboHeight);
+    glViewport(0, 0, key.width, key.height);
     glClearColor(0, 0, 0, 0);
     glClear(GL_COLOR_BUFFER_BIT);
-    glDisable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glBindVertexArray(font->vao());
-
-    std::vector<std::string> lines = split(std::move(m_data.text), '\n');
-    const glm::vec2 res = glm::vec2(m_data.fboWidth, m_data.fboHeight);
-    const glm::mat4 orthoMatrix = glm::ortho(0.f, res.x, 0.f, res.y);
-    const float h = font->height() * 1.59f;
-    const float offsetX = 0;
-    const float offsetY = h * lines.size();
-    const float marginX = res.x / 7.f;
-    sgct::text::Alignment alignment = static_cast<sgct::text::Alignment>(m_alignment);
-    for (size_t i = 0; i < lines.size(); i++) {
-        glm::vec3 offset(offsetX, offsetY - h * i, 0.f);
-
-        if (alignment == sgct::text::Alignment::TopCenter) {
-            offset.x = (res.x / 2) - (getLineWidth(*font, lines[i]) / 2.f);
-        }
-        else if (alignment == sgct::text::Alignment::TopRight) {
-            offset.x = res.x - getLineWidth(*font, lines[i]);
-        }
-        else { //TopLeft
-            offset.x = marginX;
+
+#ifdef SGCT_HAS_TEXT
+    sgct::text::Font* font = nullptr;
+    if (key.fontName.empty()) {
+        sgct::Log::Warning("TextLayer: Font name is empty.");
+    }
+    else {
+        font = sgct::text::FontManager::instance().font(key.fontName, key.fontSize);
+        if (font == nullptr) {
+            // Trying to add the font to the font manager
+            if (m_fontPath.empty()) {
+                sgct::Log::Warning(std::format("TextLayer: Font path is empty for font {}", key.fontName));
+            }
+            else if (sgct::text::FontManager::instance().addFont(key.fontName, m_fontPath, true)) {
+                font = sgct::text::FontManager::instance().font(key.fontName, key.fontSize);
+                if (font == nullptr) {
+                    sgct::Log::Warning(std::format("TextLayer: Font {} with path {} could not be added.", key.fontName, m_fontPath));
+                }
+            }
+            else {
+                sgct::Log::Warning(std::format("TextLayer: Font {} with path {} was not found.", key.fontName, m_fontPath));
+            }
         }
+    }
 
-        for (const char c : lines[i]) {
-            const sgct::text::Font::FontFaceData& ffd = font->fontFaceData(c);
+    if (font != nullptr && !key.text.empty()) {
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        glBindVertexArray(font->vao());
+
+        std::vector<std::string> lines = split(key.text, '\n');
+        const glm::vec2 res = glm::vec2(key.width, key.height);
+        const glm::mat4 orthoMatrix = glm::ortho(0.f, res.x, 0.f, res.y);
+        const float h = font->height() * 1.59f;
+        const float offsetX = 0;
+        const float offsetY = h * lines.size();
+        const float marginX = res.x / 7.f;
+        sgct::text::Alignment alignment = static_cast<sgct::text::Alignment>(key.alignment);
+        unsigned int boundTexId = 0;
+        for (size_t i = 0; i < lines.size(); i++) {
+            glm::vec3 offset(offsetX, offsetY - h * i, 0.f);
+
+            if (alignment == sgct::text::Alignment::TopCenter) {
+                offset.x = (res.x / 2) - (getLineWidth(*font, lines[i]) / 2.f);
+            }
+            else if (alignment == sgct::text::Alignment::TopRight) {
+                offset.x = res.x - getLineWidth(*font, lines[i]);
+            }
+            else { //TopLeft
+                offset.x = marginX;
+            }
+
+            for (const char c : lines[i]) {
+                const sgct::text::Font::FontFaceData& ffd = font->fontFaceData(c);
 
-            glBindTexture(GL_TEXTURE_2D, ffd.texId);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                // Repeated glyphs keep their texture bound
+                if (ffd.texId != boundTexId) {
+                    glBindTexture(GL_TEXTURE_2D, ffd.texId);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    boundTexId = ffd.texId;
+                }
 
-            const glm::mat4 trans = glm::translate(
-                orthoMatrix,
-                glm::vec3(offset.x + ffd.pos.x, offset.y + ffd.pos.y, offset.z)
-            );
-            glm::mat4 scale = glm::scale(trans, glm::vec3(ffd.size.x, ffd.size.y, 1.f));
-            sgct::mat4 s;
-            std::memcpy(&s, glm::value_ptr(scale), sizeof(sgct::mat4));
+                const glm::mat4 trans = glm::translate(
+                    orthoMatrix,
+                    glm::vec3(offset.x + ffd.pos.x, offset.y + ffd.pos.y, offset.z)
+                );
+                glm::mat4 scale = glm::scale(trans, glm::vec3(ffd.size.x, ffd.size.y, 1.f));
+                sgct::mat4 s;
+                std::memcpy(&s, glm::value_ptr(scale), sizeof(sgct::mat4));
 
-            sgct::text::FontManager::instance().bindShader(s, m_color, 0);
+                sgct::text::FontManager::instance().bindShader(s, key.color, 0);
 
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-            offset += glm::vec3(ffd.distToNextChar, 0.f, 0.f);
+                offset += glm::vec3(ffd.distToNextChar, 0.f, 0.f);
+            }
         }
+
+        glDisable(GL_BLEND);
+        glBindVertexArray(0);
+        sgct::ShaderProgram::unbind();
     }
+#endif
 
-    glDisable(GL_BLEND);
-    glBindVertexArray(0);
-    sgct::ShaderProgram::unbind();
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
     glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
-#endif
+}
+
+void TextLayer::clearRasterCache() {
+    for (RasterEntry& entry : m_rasterCache) {
+        glDeleteTextures(1, &entry.texId);
+    }
+    m_rasterCache.clear();
+    m_hasRaster = false;
+    renderData.texId = 0;
 }
 
 bool TextLayer::ready() const {
-    return m_data.fboCreated && !m_text.empty();
+    return m_data.fboCreated && renderData.texId != 0 && !m_text.empty();
 }
 
 bool TextLayer::hasTexture() const {
@@ -316,6 +395,19 @@ void TextLayer::setTextureSize(int w, int h) {
     setNeedSync();
 }
 
+bool TextLayer::halfFloatTexture() const {
+    return m_halfFloatTexture;
+}
+
+void TextLayer::setHalfFloatTexture(bool enabled) {
+    m_halfFloatTexture = enabled;
+    setNeedSync();
+}
+
+unsigned int TextLayer::textureInternalFormat() const {
+    return m_halfFloatTexture ? GL_RGBA16F : GL_RGBA8;
+}
+
 void TextLayer::encodeTypeAlways(std::vector<std::byte>& data) {
     sgct::serializeObject(data, m_textIsChanged);
     if (m_textIsChanged) {
@@ -342,6 +434,7 @@ void TextLayer::encodeTypeProperties(std::vector<std::byte>& data) {
     sgct::serializeObject(data, m_color.z);
     sgct::serializeObject(data, renderData.width);
     sgct::serializeObject(data, renderData.height);
+    sgct::serializeObject(data, m_halfFloatTexture);
 }
 
 void TextLayer::decodeTypeProperties(const std::vector<std::byte>& data, unsigned int& pos) {
@@ -354,6 +447,7 @@ void TextLayer::decodeTypeProperties(const std::vector<std::byte>& data, unsigne
     sgct::deserializeObject(data, pos, m_color.z);
     sgct::deserializeObject(data, pos, renderData.width);
     sgct::deserializeObject(data, pos, renderData.height);
+    sgct::deserializeObject(data, pos, m_halfFloatTexture);
 }
 
 void TextLayer::checkNeededFboResize() {
@@ -371,39 +465,29 @@ void TextLayer::checkNeededFboResize() {
 }
 
 void TextLayer::createFBO(int width, int height) {
-    if (m_data.fboCreated) {
-        glDeleteFramebuffers(1, &m_data.fboId);
-        glDeleteTextures(1, &renderData.texId);
+    // One framebuffer, the cached textures are attached to it when rasterized
+    if (!m_data.fboCreated) {
+        glGenFramebuffers(1, &m_data.fboId);
+        m_data.fboCreated = true;
     }
 
     m_data.fboWidth = width;
     m_data.fboHeight = height;
-
-    glGenFramebuffers(1, &m_data.fboId);
-    glBindFramebuffer(GL_FRAMEBUFFER, m_data.fboId);
-
-    generateTexture(renderData.texId, width, height);
-
-    glFramebufferTexture2D(
-        GL_FRAMEBUFFER,
-        GL_COLOR_ATTACHMENT0,
-        GL_TEXTURE_2D,
-        renderData.texId,
-        0);
-
-    m_data.fboCreated = true;
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
-void TextLayer::generateTexture(unsigned int& id, int width, int height) {
+void TextLayer::generateTexture(unsigned int& id, int width, int height, bool halfFloat) {
     glGenTextures(1, &id);
     glPixelStorei(GL_PACK_ALIGNMENT, 1);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
     glBindTexture(GL_TEXTURE_2D, id);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    if (halfFloat) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    }
+    else {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
 
     // Disable mipmaps
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
@@ -413,4 +497,4 @@ void TextLayer::generateTexture(unsigned int& id, int width, int height) {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-}
\ No newline at end of file
+}
@@ -10,6 +10,7 @@
 
 #include <layers/baselayer.h>
 #include <sgct/sgct.h>
+#include <list>
 #include <string>
 
 class TextLayer : public BaseLayer {
@@ -20,7 +21,20 @@ public:
         int fboHeight = 0;
         bool fboCreated = false;
         unsigned int fboId = 0;
-        std::string text = "";
+    };
+
+    // Everything that changes the rasterized text block
+    struct RasterKey {
+        std::string text;
+        std::string fontName;
+        int fontSize = 0;
+        int alignment = 0;
+        sgct::vec4 color = sgct::vec4{ 1.f, 1.f, 1.f, 1.f };
+        int width = 0;
+        int height = 0;
+        bool halfFloat = false;
+
+        bool operator==(const RasterKey& other) const;
     };
 
     TextLayer();
@@ -59,6 +73,11 @@ public:
 
     void setTextureSize(int w, int h);
 
+    // RGBA16F instead of RGBA8 textures, twice the memory for no gain on plain text
+    bool halfFloatTexture() const;
+    void setHalfFloatTexture(bool enabled);
+    unsigned int textureInternalFormat() const override;
+
     void encodeTypeAlways(std::vector<std::byte>& data);
     void decodeTypeAlways(const std::vector<std::byte>& data, unsigned int& pos);
 
@@ -66,9 +85,17 @@ public:
     void decodeTypeProperties(const std::vector<std::byte>& data, unsigned int& pos);
 
 private:
+    struct RasterEntry {
+        RasterKey key;
+        unsigned int texId = 0;
+    };
+
     void checkNeededFboResize();
     void createFBO(int width, int height);
-    void generateTexture(unsigned int& id, int width, int height);
+    void generateTexture(unsigned int& id, int width, int height, bool halfFloat);
+    RasterKey rasterKey() const;
+    void rasterize(const RasterKey& key, unsigned int texId);
+    void clearRasterCache();
 
     bool m_textIsChanged;
     std::string m_text;
@@ -78,7 +105,14 @@ private:
     int m_alignment;
     std::string m_colorHex;
     sgct::vec4 m_color;
+    bool m_halfFloatTexture;
     textData m_data;
+
+    // Rasterized blocks, most recently used first. Subtitles often repeat,
+    // so showing a cached block is just a texture switch.
+    std::list<RasterEntry> m_rasterCache;
+    RasterKey m_rasterKey;
+    bool m_hasRaster;
 };
 
 #endif // TEXTLAYER_H
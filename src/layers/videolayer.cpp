@@ -12,6 +12,8 @@
 #include "qthelper.h"
 #include <sgct/opengl.h>
 #include <sgct/sgct.h>
+#include <utils/frameprofiler.h>
+#include <utils/renderprecision.h>
 
 void on_mpv_render_update(void* ctx) {
     VideoLayer* videoLayer = static_cast<VideoLayer*>(ctx);
@@ -69,7 +71,8 @@ void VideoLayer::initializeGL() {
 }
 
 void VideoLayer::cleanup() {
-    if (!m_data.mpvInitialized)
+    m_data.initializeDeferred = false;
+    if (!m_data.lease)
         return;
 
     // Destroy the GL renderer and all of the GL objects it allocated. If video
@@ -79,7 +82,7 @@ void VideoLayer::cleanup() {
         mpv_render_context_free(m_data.renderContext);
     }
 
-    // End Mpv running on separate thread
+    // Return Mpv instance (running on separate thread) to the pool
     MpvLayer::cleanup();
 
     if (m_data.fboCreated) {
@@ -99,8 +102,11 @@ void VideoLayer::cleanup() {
 }
 
 void VideoLayer::updateFrame() {
+    FrameProfiler::Scope profileScope("updateFrame", this, true);
     std::lock_guard<std::mutex> lock(m_updateFrameMutex);
 
+    // initializeAndLoad() may have left leasing an instance to later frames
+    continueInitialize();
     if (!m_data.mpvInitializedGL)
         return;
 
@@ -124,7 +130,7 @@ void VideoLayer::updateFrame() {
             renderTargetFbo = m_renderingToPingPong ? m_pingPongFboId : m_data.fboId;
         }
 
-        mpv_opengl_fbo mpfbo{static_cast<int>(renderTargetFbo), m_data.fboWidth, m_data.fboHeight, GL_RGBA16F};
+        mpv_opengl_fbo mpfbo{static_cast<int>(renderTargetFbo), m_data.fboWidth, m_data.fboHeight, static_cast<int>(textureInternalFormat())};
         int flip_y{1};
 
         mpv_render_param params[] = {
@@ -159,7 +165,7 @@ bool VideoLayer::ready() const {
 }
 
 unsigned int VideoLayer::textureInternalFormat() const {
-    return GL_RGBA16F;
+    return m_fboInternalFormat != 0 ? m_fboInternalFormat : GL_RGBA16F;
 }
 
 void VideoLayer::updateFbo() {
@@ -167,7 +173,11 @@ void VideoLayer::updateFbo() {
 }
 
 void VideoLayer::checkNeededMpvFboResize() {
-    if (m_data.fboWidth == renderData.width && m_data.fboHeight == renderData.height)
+    unsigned int internalFormat = m_data.videoInternalFormat;
+    if (internalFormat == 0)
+        internalFormat = GL_RGBA16F;
+
+    if (m_data.fboWidth == renderData.width && m_data.fboHeight == renderData.height && m_fboInternalFormat == internalFormat)
         return;
 
     int maxTexSize;
@@ -175,8 +185,9 @@ void VideoLayer::checkNeededMpvFboResize() {
     if (renderData.width <= 0 || renderData.height <= 0 || renderData.width > maxTexSize || renderData.height > maxTexSize)
         return;
 
-    sgct::Log::Info(std::format("New MPV FBO width:{} and height:{}", renderData.width, renderData.height));
+    sgct::Log::Info(std::format("New MPV FBO width:{} and height:{} with format {}", renderData.width, renderData.height, RenderPrecision::name(internalFormat)));
 
+    m_fboInternalFormat = internalFormat;
     createMpvFBO(renderData.width, renderData.height);
 }
 
@@ -246,7 +257,7 @@ void VideoLayer::generateTexture(unsigned int &id, int width, int height) {
 
     glBindTexture(GL_TEXTURE_2D, id);
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    glTexImage2D(GL_TEXTURE_2D, 0, textureInternalFormat(), width, height, 0, GL_RGBA, RenderPrecision::pixelType(textureInternalFormat()), nullptr);
 
     // Disable mipmaps
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
@@ -36,6 +36,8 @@ private:
 
     // Primary FBO texture (always tracks the texture attached to m_data.fboId)
     unsigned int m_primaryTexId = 0;
+    // Internal format of the FBO textures, reallocated when the video needs another
+    unsigned int m_fboInternalFormat = 0;
 
     // Ping-pong resources (master only)
     unsigned int m_pingPongFboId = 0;
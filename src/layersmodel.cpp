@@ -10,6 +10,7 @@
 #include "imagesettings.h"
 #include "locationsettings.h"
 #include "presentationsettings.h"
+#include "slidethumbnailprovider.h"
 #include "subtitlesettings.h"
 #ifdef NDI_SUPPORT
 #include <ndi/ndilayer.h>
@@ -26,6 +27,7 @@
 #include <layers/restlayer.h>
 #include "httpclientmodel.h"
 #include "application.h"
+#include "utils/pathresolver.h"
 
 #include <QDir>
 #include <QFileInfo>
@@ -57,6 +59,27 @@ static void* get_proc_address_qopengl_v2(const char* name, void* ctx) {
     return reinterpret_cast<void*>(glctx->getProcAddress(QByteArray(name)));
 }
 
+static const QStringList &easingNames() {
+    // Indexed by TimelineEasing
+    static const QStringList names = {
+        QStringLiteral("linear"),
+        QStringLiteral("easeIn"),
+        QStringLiteral("easeOut"),
+        QStringLiteral("easeInOut"),
+        QStringLiteral("bezier"),
+        QStringLiteral("catmullRom")
+    };
+    return names;
+}
+
+static QString easingName(int easing) {
+    return easingNames().value(easing, easingNames().first());
+}
+
+static int easingFromName(const QString &name) {
+    return std::max(0, static_cast<int>(easingNames().indexOf(name)));
+}
+
 LayersModel::LayersModel(QObject *parent)
     : QAbstractListModel(parent),
     m_layerTypeModel(new LayersTypeModel(this)),
@@ -68,6 +91,12 @@ LayersModel::LayersModel(QObject *parent)
     m_timelineTimer = new QTimer(this);
     m_timelineTimer->setInterval(16); // ~60 fps ticks
     connect(m_timelineTimer, &QTimer::timeout, this, &LayersModel::onTimelineTick);
+    // Timeline ticks only change values that are not in the thumbnail, so dataChanged is not used
+    connect(this, &LayersModel::layersModelChanged, this, &LayersModel::invalidateThumbnailHash);
+    connect(this, &QAbstractItemModel::rowsInserted, this, &LayersModel::invalidateThumbnailHash);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &LayersModel::invalidateThumbnailHash);
+    connect(this, &QAbstractItemModel::rowsMoved, this, &LayersModel::invalidateThumbnailHash);
+    connect(this, &QAbstractItemModel::modelReset, this, &LayersModel::invalidateThumbnailHash);
 }
 
 LayersModel::~LayersModel() {
@@ -199,8 +228,12 @@ bool LayersModel::needsSync() {
     return m_needSync;
 }
 
-void LayersModel::setHasSynced() {
-    if (m_syncIteration > 0) {
+void LayersModel::setHasSynced(bool allIterations) {
+    if (allIterations) {
+        m_syncIteration = 0;
+        m_needSync = false;
+    }
+    else if (m_syncIteration > 0) {
         m_syncIteration--;
     }
     else {
@@ -322,6 +355,7 @@ int LayersModel::addLayer(QString title, int type, QString filepath, int stereoM
             newTextLayer->setFont(SubtitleSettings::subtitleFontFamily().toStdString());
             newTextLayer->setFontSize(SubtitleSettings::subtitleFontSize());
             newTextLayer->setTextureSize(SubtitleSettings::subtitleTextureWidth(), SubtitleSettings::subtitleTextureHeight());
+            newTextLayer->setHalfFloatTexture(SubtitleSettings::subtitleTextureHalfFloat());
             newTextLayer->setAlignment(SubtitleSettings::subtitleAlignment());
             QColor textColor(SubtitleSettings::subtitleColor());
             newTextLayer->setColor(textColor.name().toStdString(), textColor.redF(), textColor.greenF(), textColor.blueF());
@@ -512,9 +546,27 @@ void LayersModel::moveLayerBottom(int i) {
 void LayersModel::updateLayer(int i) {
     if (i < 0 || i >= m_layers.size())
         return;
+    invalidateThumbnailHash();
     Q_EMIT dataChanged(index(i, 0), index(i, 0));
 }
 
+QString LayersModel::thumbnailHash(bool *rebuilt) {
+    // The provider forgets descriptions of slides not shown for a long time
+    bool valid = m_thumbnailHashValid
+        && (m_thumbnailHash.isEmpty() || SlideThumbnailProvider::isRegistered(m_thumbnailHash));
+    if (!valid) {
+        m_thumbnailHash = SlideThumbnailProvider::registerSlide(this);
+        m_thumbnailHashValid = true;
+    }
+    if (rebuilt)
+        *rebuilt = !valid;
+    return m_thumbnailHash;
+}
+
+void LayersModel::invalidateThumbnailHash() {
+    m_thumbnailHashValid = false;
+}
+
 void LayersModel::lockLayer(int i) {
     if (i < 0 || i >= m_layers.size() || !m_layers[i].first)
         return;
@@ -796,25 +848,7 @@ std::string LayersModel::getLayersAsFormattedString(size_t charsPerItem) const {
 }
 
 QString LayersModel::checkAndCorrectPath(const QString &filePath, const QStringList &searchPaths) {
-    QFileInfo fileInfo(filePath);
-    if (fileInfo.exists())
-        return filePath;
-    else if (fileInfo.isRelative()) { // Go through search list in order
-        for (int i = 0; i < searchPaths.size(); i++) {
-            QString newFilePath = QDir::cleanPath(searchPaths[i] + QDir::separator() + filePath);
-            QFileInfo newFilePathInfo(newFilePath);
-            if (newFilePathInfo.exists())
-                return newFilePath;
-        }
-
-        // Maybe from network share?
-        QString sharefilePath = filePath;
-        sharefilePath.replace(QStringLiteral("file://"), QStringLiteral("\\\\"));
-        fileInfo = QFileInfo(sharefilePath);
-        if (fileInfo.exists())
-            return sharefilePath;
-    }
-    return QStringLiteral("");
+    return PathResolver::instance().resolve(filePath, searchPaths);
 }
 
 QString LayersModel::makePathRelativeTo(const QString &filePath, const QStringList &pathsToConsider) {
@@ -828,7 +862,43 @@ QString LayersModel::makePathRelativeTo(const QString &filePath, const QStringLi
     return filePath;
 }
 
-void LayersModel::decodeFromJSON(QJsonObject &obj, const QStringList &forRelativePaths) {
+int LayersModel::layerTypeFromJSON(const QJsonObject &layerObj) {
+    int type = 0;
+    if (layerObj.contains(QStringLiteral("type"))) {
+        QString typeStr = layerObj.value(QStringLiteral("type")).toString();
+        for (int i = 1; i != (int)BaseLayer::LayerType::INVALID; i++) {
+            if (typeStr == QString::fromStdString(BaseLayer::typeDescription((BaseLayer::LayerType)i))) {
+                type = i;
+            }
+        }
+    }
+    return type;
+}
+
+static bool layerTypeHasMediaPath(int type) {
+    return type == BaseLayer::IMAGE
+        || type == BaseLayer::VIDEO
+#ifdef  PDF_SUPPORT
+        || type == BaseLayer::PDF
+#endif //  PDF_SUPPORT
+        || type == BaseLayer::AUDIO;
+}
+
+QStringList LayersModel::mediaPathsFromJSON(const QJsonObject &obj) {
+    QStringList paths;
+    QJsonArray array = obj.value(QStringLiteral("layers")).toArray();
+    for (auto v : array) {
+        QJsonObject o = v.toObject();
+        if (layerTypeHasMediaPath(layerTypeFromJSON(o)) && o.contains(QStringLiteral("path"))) {
+            QString path = o.value(QStringLiteral("path")).toString();
+            if (!paths.contains(path))
+                paths.append(path);
+        }
+    }
+    return paths;
+}
+
+void LayersModel::decodeFromJSON(QJsonObject &obj, const QStringList &forRelativePaths, const QHash<QString, QString> *resolvedPaths) {
     if (obj.contains(QStringLiteral("name"))) {
         QString name = obj.value(QStringLiteral("name")).toString();
         setLayersName(name);
@@ -862,25 +932,17 @@ void LayersModel::decodeFromJSON(QJsonObject &obj, const QStringList &forRelativ
         for (auto v : array) {
             QJsonObject o = v.toObject();
             if (o.contains(QStringLiteral("type"))) {
-                int type = 0;
-                QString typeStr = o.value(QStringLiteral("type")).toString();
-                for (int i = 1; i != (int)BaseLayer::LayerType::INVALID; i++) {
-                    if (typeStr == QString::fromStdString(BaseLayer::typeDescription((BaseLayer::LayerType)i))) {
-                        type = i;
-                    }
-                }
+                int type = layerTypeFromJSON(o);
 
                 if (type > 0 && o.contains(QStringLiteral("title")) && o.contains(QStringLiteral("path")) && o.contains(QStringLiteral("grid")) && o.contains(QStringLiteral("stereoscopic"))) {
                     QString title = o.value(QStringLiteral("title")).toString();
 
                     QString path = o.value(QStringLiteral("path")).toString();
-                    if (type == BaseLayer::IMAGE
-                        || type == BaseLayer::VIDEO
-#ifdef  PDF_SUPPORT
-                        || type == BaseLayer::PDF
-#endif //  PDF_SUPPORT
-                        || type == BaseLayer::AUDIO) {
-                        path = checkAndCorrectPath(path, forRelativePaths);
+                    if (layerTypeHasMediaPath(type)) {
+                        if (resolvedPaths && resolvedPaths->contains(path))
+                            path = resolvedPaths->value(path);
+                        else
+                            path = checkAndCorrectPath(path, forRelativePaths);
                     }
                     else if (type == BaseLayer::CONTROL) {
                         // For Control layers, path holds "operation:parameter"
@@ -1255,10 +1317,19 @@ void LayersModel::decodeFromJSON(QJsonObject &obj, const QStringList &forRelativ
                             kf.translateX   = static_cast<float>(ko.value(QStringLiteral("translateX")).toDouble(0.0));
                             kf.translateY   = static_cast<float>(ko.value(QStringLiteral("translateY")).toDouble(0.0));
                             kf.translateZ   = static_cast<float>(ko.value(QStringLiteral("translateZ")).toDouble(0.0));
+                            kf.easing       = easingFromName(ko.value(QStringLiteral("easing")).toString());
+                            QJsonArray bezier = ko.value(QStringLiteral("bezier")).toArray();
+                            if (bezier.size() == 4) {
+                                kf.bezierX1 = static_cast<float>(bezier[0].toDouble());
+                                kf.bezierY1 = static_cast<float>(bezier[1].toDouble());
+                                kf.bezierX2 = static_cast<float>(bezier[2].toDouble());
+                                kf.bezierY2 = static_cast<float>(bezier[3].toDouble());
+                            }
                             track.keyframes.append(kf);
                         }
                         if (idx < m_layerTimelines.size())
                             m_layerTimelines[idx] = track;
+                        invalidateCompiledTimelines();
                     }
                 }
             }
@@ -1616,6 +1687,17 @@ void LayersModel::encodeToJSON(QJsonObject &obj, const QStringList &forRelativeP
                     kfObj.insert(QStringLiteral("translateY"),   QJsonValue(static_cast<double>(kf.translateY)));
                     kfObj.insert(QStringLiteral("translateZ"),   QJsonValue(static_cast<double>(kf.translateZ)));
                 }
+                if (kf.easing != static_cast<int>(TimelineEasing::Linear)) {
+                    kfObj.insert(QStringLiteral("easing"), easingName(kf.easing));
+                    if (kf.easing == static_cast<int>(TimelineEasing::CubicBezier)) {
+                        QJsonArray bezier;
+                        bezier.append(static_cast<double>(kf.bezierX1));
+                        bezier.append(static_cast<double>(kf.bezierY1));
+                        bezier.append(static_cast<double>(kf.bezierX2));
+                        bezier.append(static_cast<double>(kf.bezierY2));
+                        kfObj.insert(QStringLiteral("bezier"), bezier);
+                    }
+                }
                 kfArray.push_back(kfObj);
             }
             layerData.insert(QStringLiteral("timelineKeyframes"), kfArray);
@@ -1667,6 +1749,29 @@ bool LayersModel::runRenderOnLayersThatShouldUpdate(bool updateRendering, bool p
     return statusHasUpdated;
 }
 
+bool LayersModel::hasLayersToUpdate(bool preload) const {
+    for (const auto &l : m_layers) {
+        auto &layer = l.first;
+        if (!layer || !layer->isEnabled())
+            continue;
+        bool wanted = layer->shouldUpdate() || preload || layer->shouldPreLoad();
+        if (wanted && !layer->ready())
+            return true;
+        if ((layer->shouldUpdate() || layer->shouldUpdateFrame()) && layer->isLive())
+            return true;
+    }
+    return false;
+}
+
+uint64_t LayersModel::layersChangeCount() const {
+    uint64_t count = 0;
+    for (const auto &l : m_layers) {
+        if (l.first)
+            count += l.first->changeCount();
+    }
+    return count;
+}
+
 LayersTypeModel::LayersTypeModel(QObject *parent)
     : QAbstractListModel(parent) {
     for (int i = 1; i != (int)BaseLayer::LayerType::INVALID; i++) {
@@ -1746,8 +1851,10 @@ void LayersModel::setHasTimeline(bool value) {
                 anyGenerated = true;
             }
         }
-        if (anyGenerated)
+        if (anyGenerated) {
+            invalidateCompiledTimelines();
             Q_EMIT layersModelChanged();
+        }
     }
     setLayersNeedsSave(true);
     Q_EMIT timelineChanged();
@@ -1818,6 +1925,11 @@ QVariantList LayersModel::getKeyframes(int layerIdx) const {
         m[QStringLiteral("translateX")]   = static_cast<double>(kf.translateX);
         m[QStringLiteral("translateY")]   = static_cast<double>(kf.translateY);
         m[QStringLiteral("translateZ")]   = static_cast<double>(kf.translateZ);
+        m[QStringLiteral("easing")]       = kf.easing;
+        m[QStringLiteral("bezierX1")]     = static_cast<double>(kf.bezierX1);
+        m[QStringLiteral("bezierY1")]     = static_cast<double>(kf.bezierY1);
+        m[QStringLiteral("bezierX2")]     = static_cast<double>(kf.bezierX2);
+        m[QStringLiteral("bezierY2")]     = static_cast<double>(kf.bezierY2);
         result.append(m);
     }
     return result;
@@ -1841,9 +1953,15 @@ void LayersModel::setKeyframes(int layerIdx, const QVariantList &keyframes) {
         kf.translateX   = static_cast<float>(m.value(QStringLiteral("translateX"),   0.0).toDouble());
         kf.translateY   = static_cast<float>(m.value(QStringLiteral("translateY"),   0.0).toDouble());
         kf.translateZ   = static_cast<float>(m.value(QStringLiteral("translateZ"),   0.0).toDouble());
+        kf.easing       = std::clamp(m.value(QStringLiteral("easing"), 0).toInt(), 0, static_cast<int>(TimelineEasing::CatmullRom));
+        kf.bezierX1     = static_cast<float>(m.value(QStringLiteral("bezierX1"),     0.0).toDouble());
+        kf.bezierY1     = static_cast<float>(m.value(QStringLiteral("bezierY1"),     0.0).toDouble());
+        kf.bezierX2     = static_cast<float>(m.value(QStringLiteral("bezierX2"),     1.0).toDouble());
+        kf.bezierY2     = static_cast<float>(m.value(QStringLiteral("bezierY2"),     1.0).toDouble());
         track.keyframes.append(kf);
     }
     m_layerTimelines[layerIdx] = track;
+    invalidateCompiledTimelines();
     setLayersNeedsSave(true);
     Q_EMIT timelineChanged();
 }
@@ -1860,6 +1978,7 @@ void LayersModel::addKeyframe(int layerIdx, int timeMs, float alpha) {
     while (insertPos < kfs.size() && kfs[insertPos].timeMs <= kf.timeMs)
         ++insertPos;
     kfs.insert(insertPos, kf);
+    invalidateCompiledTimelines();
     setLayersNeedsSave(true);
     Q_EMIT timelineChanged();
 }
@@ -1884,6 +2003,7 @@ void LayersModel::addKeyframe(int layerIdx, int timeMs, float alpha,
     while (insertPos < kfs.size() && kfs[insertPos].timeMs <= kf.timeMs)
         ++insertPos;
     kfs.insert(insertPos, kf);
+    invalidateCompiledTimelines();
     setLayersNeedsSave(true);
     Q_EMIT timelineChanged();
 }
@@ -1895,6 +2015,7 @@ void LayersModel::removeKeyframe(int layerIdx, int keyframeIdx) {
     if (keyframeIdx < 0 || keyframeIdx >= kfs.size())
         return;
     kfs.removeAt(keyframeIdx);
+    invalidateCompiledTimelines();
     setLayersNeedsSave(true);
     Q_EMIT timelineChanged();
 }
@@ -1910,6 +2031,7 @@ void LayersModel::updateKeyframe(int layerIdx, int keyframeIdx, int timeMs, floa
     std::sort(kfs.begin(), kfs.end(), [](const LayerKeyframe &a, const LayerKeyframe &b) {
         return a.timeMs < b.timeMs;
     });
+    invalidateCompiledTimelines();
     setLayersNeedsSave(true);
     Q_EMIT timelineChanged();
 }
@@ -1933,144 +2055,217 @@ void LayersModel::updateKeyframe(int layerIdx, int keyframeIdx, int timeMs, floa
     std::sort(kfs.begin(), kfs.end(), [](const LayerKeyframe &a, const LayerKeyframe &b) {
         return a.timeMs < b.timeMs;
     });
+    invalidateCompiledTimelines();
     setLayersNeedsSave(true);
     Q_EMIT timelineChanged();
 }
 
-float LayersModel::evaluateAlphaAt(int layerIdx, int timeMs) const {
+void LayersModel::invalidateCompiledTimelines() {
+    m_compiledTimelinesDirty = true;
+    if (m_timelineRunning || m_outroRunning)
+        updateLayerTimelines();
+}
+
+std::shared_ptr<const TimelineTrack> LayersModel::compiledTimeline(int layerIdx) const {
     if (layerIdx < 0 || layerIdx >= m_layerTimelines.size())
-        return 0.f;
-    const auto &kfs = m_layerTimelines[layerIdx].keyframes;
-    if (kfs.isEmpty())
-        return 0.f;
-    if (timeMs <= kfs.first().timeMs) return kfs.first().alpha;
-    if (timeMs >= kfs.last().timeMs)  return kfs.last().alpha;
-    for (int i = 0; i < kfs.size() - 1; i++) {
-        if (timeMs >= kfs[i].timeMs && timeMs <= kfs[i + 1].timeMs) {
-            float t = static_cast<float>(timeMs - kfs[i].timeMs)
-                    / static_cast<float>(kfs[i + 1].timeMs - kfs[i].timeMs);
-            return kfs[i].alpha + t * (kfs[i + 1].alpha - kfs[i].alpha);
+        return nullptr;
+
+    if (m_compiledTimelinesDirty || m_compiledTimelines.size() != static_cast<size_t>(m_layerTimelines.size())) {
+        m_compiledTimelines.resize(m_layerTimelines.size());
+        for (int l = 0; l < m_layerTimelines.size(); ++l) {
+            // Keyframes set from QML or loaded from file are not guaranteed to be in order
+            QVector<LayerKeyframe> kfs = m_layerTimelines[l].keyframes;
+            std::stable_sort(kfs.begin(), kfs.end(), [](const LayerKeyframe &a, const LayerKeyframe &b) {
+                return a.timeMs < b.timeMs;
+            });
+            // Always a new track, layers may still hold on to the previous one
+            auto track = std::make_shared<TimelineTrack>();
+            for (const LayerKeyframe &kf : kfs) {
+                TimelineEasing easing = static_cast<TimelineEasing>(kf.easing);
+                glm::vec4 bezier(kf.bezierX1, kf.bezierY1, kf.bezierX2, kf.bezierY2);
+                track->alpha.append(kf.timeMs, kf.alpha, easing, bezier);
+                if (kf.hasRotate)
+                    track->rotate.append(kf.timeMs, glm::vec3(kf.rotateX, kf.rotateY, kf.rotateZ), easing, bezier);
+                if (kf.hasTranslate)
+                    track->translate.append(kf.timeMs, glm::vec3(kf.translateX, kf.translateY, kf.translateZ), easing, bezier);
+            }
+            m_compiledTimelines[l] = track->alpha.empty() ? nullptr : track;
         }
+        m_compiledTimelinesDirty = false;
     }
-    return kfs.last().alpha;
+
+    return m_compiledTimelines[layerIdx];
 }
 
-bool LayersModel::evaluateRotateAt(int layerIdx, int timeMs, float &rx, float &ry, float &rz) const {
-    if (layerIdx < 0 || layerIdx >= m_layerTimelines.size()) return false;
-    const auto &kfs = m_layerTimelines[layerIdx].keyframes;
-    QVector<const LayerKeyframe *> rKFs;
-    for (const LayerKeyframe &kf : kfs)
-        if (kf.hasRotate) rKFs.append(&kf);
-    if (rKFs.isEmpty()) return false;
-    if (timeMs <= rKFs.first()->timeMs) { rx = rKFs.first()->rotateX; ry = rKFs.first()->rotateY; rz = rKFs.first()->rotateZ; return true; }
-    if (timeMs >= rKFs.last()->timeMs)  { rx = rKFs.last()->rotateX;  ry = rKFs.last()->rotateY;  rz = rKFs.last()->rotateZ;  return true; }
-    for (int i = 0; i < rKFs.size() - 1; ++i) {
-        if (timeMs >= rKFs[i]->timeMs && timeMs <= rKFs[i + 1]->timeMs) {
-            float t = static_cast<float>(timeMs - rKFs[i]->timeMs)
-                    / static_cast<float>(rKFs[i + 1]->timeMs - rKFs[i]->timeMs);
-            rx = rKFs[i]->rotateX + t * (rKFs[i + 1]->rotateX - rKFs[i]->rotateX);
-            ry = rKFs[i]->rotateY + t * (rKFs[i + 1]->rotateY - rKFs[i]->rotateY);
-            rz = rKFs[i]->rotateZ + t * (rKFs[i + 1]->rotateZ - rKFs[i]->rotateZ);
-            return true;
+void LayersModel::updateLayerTimelines() {
+    const TimelinePlayback *playback = nullptr;
+    if (m_outroRunning)
+        playback = &m_outroPlayback;
+    else if (m_timelineRunning)
+        playback = &m_timelinePlayback;
+
+    for (int l = 0; l < m_layers.size(); ++l) {
+        if (!m_layers[l].first)
+            continue;
+        std::shared_ptr<const TimelineTrack> track = playback ? compiledTimeline(l) : nullptr;
+        if (!track) {
+            m_layers[l].first->clearTimeline();
+            continue;
         }
+        TimelinePlayback layerPlayback = *playback;
+        if (m_outroRunning && l < m_outroTargetAlpha.size())
+            layerPlayback.alphaScale = m_outroTargetAlpha[l];
+        m_layers[l].first->setTimeline(track, layerPlayback);
     }
-    rx = rKFs.last()->rotateX; ry = rKFs.last()->rotateY; rz = rKFs.last()->rotateZ;
+}
+
+float LayersModel::evaluateAlphaAt(int layerIdx, int timeMs) const {
+    std::shared_ptr<const TimelineTrack> track = compiledTimeline(layerIdx);
+    if (!track)
+        return 0.f;
+    return track->alpha.evaluate(timeMs);
+}
+
+bool LayersModel::evaluateRotateAt(int layerIdx, int timeMs, float &rx, float &ry, float &rz) const {
+    std::shared_ptr<const TimelineTrack> track = compiledTimeline(layerIdx);
+    if (!track || track->rotate.empty())
+        return false;
+    glm::vec3 r = track->evaluateRotate(timeMs);
+    rx = r.x; ry = r.y; rz = r.z;
     return true;
 }
 
 bool LayersModel::evaluateTranslateAt(int layerIdx, int timeMs, float &tx, float &ty, float &tz) const {
-    if (layerIdx < 0 || layerIdx >= m_layerTimelines.size()) return false;
-    const auto &kfs = m_layerTimelines[layerIdx].keyframes;
-    QVector<const LayerKeyframe *> tKFs;
-    for (const LayerKeyframe &kf : kfs)
-        if (kf.hasTranslate) tKFs.append(&kf);
-    if (tKFs.isEmpty()) return false;
-    if (timeMs <= tKFs.first()->timeMs) { tx = tKFs.first()->translateX; ty = tKFs.first()->translateY; tz = tKFs.first()->translateZ; return true; }
-    if (timeMs >= tKFs.last()->timeMs)  { tx = tKFs.last()->translateX;  ty = tKFs.last()->translateY;  tz = tKFs.last()->translateZ;  return true; }
-    for (int i = 0; i < tKFs.size() - 1; ++i) {
-        if (timeMs >= tKFs[i]->timeMs && timeMs <= tKFs[i + 1]->timeMs) {
-            float t = static_cast<float>(timeMs - tKFs[i]->timeMs)
-                    / static_cast<float>(tKFs[i + 1]->timeMs - tKFs[i]->timeMs);
-            tx = tKFs[i]->translateX + t * (tKFs[i + 1]->translateX - tKFs[i]->translateX);
-            ty = tKFs[i]->translateY + t * (tKFs[i + 1]->translateY - tKFs[i]->translateY);
-            tz = tKFs[i]->translateZ + t * (tKFs[i + 1]->translateZ - tKFs[i]->translateZ);
-            return true;
-        }
-    }
-    tx = tKFs.last()->translateX; ty = tKFs.last()->translateY; tz = tKFs.last()->translateZ;
+    std::shared_ptr<const TimelineTrack> track = compiledTimeline(layerIdx);
+    if (!track || track->translate.empty())
+        return false;
+    glm::vec3 t = track->translate.evaluate(timeMs);
+    tx = t.x; ty = t.y; tz = t.z;
     return true;
 }
 
+void LayersModel::setKeyframeEasing(int layerIdx, int keyframeIdx, int easing,
+                                    float x1, float y1, float x2, float y2) {
+    if (layerIdx < 0 || layerIdx >= m_layerTimelines.size())
+        return;
+    auto &kfs = m_layerTimelines[layerIdx].keyframes;
+    if (keyframeIdx < 0 || keyframeIdx >= kfs.size())
+        return;
+    LayerKeyframe &kf = kfs[keyframeIdx];
+    kf.easing   = std::clamp(easing, 0, static_cast<int>(TimelineEasing::CatmullRom));
+    kf.bezierX1 = std::clamp(x1, 0.f, 1.f);
+    kf.bezierY1 = y1;
+    kf.bezierX2 = std::clamp(x2, 0.f, 1.f);
+    kf.bezierY2 = y2;
+    invalidateCompiledTimelines();
+    setLayersNeedsSave(true);
+    Q_EMIT timelineChanged();
+}
+
 bool LayersModel::layerHasKeyframes(int layerIdx) const {
     if (layerIdx < 0 || layerIdx >= m_layerTimelines.size())
         return false;
     return !m_layerTimelines[layerIdx].keyframes.isEmpty();
 }
 
+bool LayersModel::applyTimelineValues(int layerIdx, const TimelineTrack &track, int timeMs, float alphaScale) {
+    BaseLayer *layer = m_layers[layerIdx].first.get();
+    bool changed = applyTimelineAlpha(layerIdx, track.alpha.evaluate(timeMs) * alphaScale);
+    if (!track.rotate.empty()) {
+        glm::vec3 r = track.evaluateRotate(timeMs);
+        if (r != layer->rotate()) {
+            layer->setRotate(r);
+            changed = true;
+        }
+    }
+    if (!track.translate.empty()) {
+        glm::vec3 t = track.translate.evaluate(timeMs);
+        if (t != layer->translate()) {
+            layer->setTranslate(t);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool LayersModel::applyTimelineAlpha(int layerIdx, float alpha) {
+    BaseLayer *layer = m_layers[layerIdx].first.get();
+    if (alpha == layer->alpha())
+        return false;
+    layer->setAlpha(alpha);
+    return true;
+}
+
+void LayersModel::updateChangedLayers(const std::vector<bool> &changed) {
+    int runStart = -1;
+    for (int l = 0; l <= static_cast<int>(changed.size()); ++l) {
+        bool rowChanged = l < static_cast<int>(changed.size()) && changed[l];
+        if (rowChanged && runStart < 0) {
+            runStart = l;
+        }
+        else if (!rowChanged && runStart >= 0) {
+            Q_EMIT dataChanged(index(runStart, 0), index(l - 1, 0));
+            runStart = -1;
+        }
+    }
+}
+
 void LayersModel::applyTimelineAt(int timeMs) {
+    std::vector<bool> changed(m_layers.size(), false);
     for (int l = 0; l < m_layers.size(); ++l) {
         if (!m_layers[l].first)
             continue;
-        if (l < m_layerTimelines.size() && !m_layerTimelines[l].keyframes.isEmpty()) {
-            m_layers[l].first->setAlpha(evaluateAlphaAt(l, timeMs));
-            float rx = 0.f, ry = 0.f, rz = 0.f;
-            if (evaluateRotateAt(l, timeMs, rx, ry, rz)) {
-                glm::vec3 r(rx, ry, rz);
-                m_layers[l].first->setRotate(r);
-            }
-            float tx = 0.f, ty = 0.f, tz = 0.f;
-            if (evaluateTranslateAt(l, timeMs, tx, ty, tz)) {
-                glm::vec3 t(tx, ty, tz);
-                m_layers[l].first->setTranslate(t);
-            }
+        if (std::shared_ptr<const TimelineTrack> track = compiledTimeline(l)) {
+            changed[l] = applyTimelineValues(l, *track, timeMs, 1.f);
         } else {
             // No keyframes: fade in linearly over the intro, hold 1.0 from outroStart onward
             int introEnd = hasOutro() ? m_timelineOutroStart : m_timelineDuration;
             if (introEnd > 0 && timeMs < introEnd) {
                 float t = static_cast<float>(timeMs) / static_cast<float>(introEnd);
-                m_layers[l].first->setAlpha(t);
+                changed[l] = applyTimelineAlpha(l, t);
             } else {
-                m_layers[l].first->setAlpha(1.f);
+                changed[l] = applyTimelineAlpha(l, 1.f);
             }
         }
-        updateLayer(l);
     }
+    updateChangedLayers(changed);
 }
 
 void LayersModel::applyTimelineOutroAt(int outroTimeMs, const QVector<float> &targetAlphaPerLayer) {
     if (!hasOutro())
         return;
     int absTimeMs = std::max(m_timelineOutroStart, std::min(m_timelineOutroStart + outroTimeMs, m_timelineDuration));
+    std::vector<bool> changed(m_layers.size(), false);
     for (int l = 0; l < m_layers.size(); ++l) {
         if (!m_layers[l].first)
             continue;
-        if (l < m_layerTimelines.size() && !m_layerTimelines[l].keyframes.isEmpty()) {
+        if (std::shared_ptr<const TimelineTrack> track = compiledTimeline(l)) {
             float targetAlpha = (l < targetAlphaPerLayer.size()) ? targetAlphaPerLayer[l] : m_layers[l].first->alpha();
-            m_layers[l].first->setAlpha(evaluateAlphaAt(l, absTimeMs) * targetAlpha);
-            float rx = 0.f, ry = 0.f, rz = 0.f;
-            if (evaluateRotateAt(l, absTimeMs, rx, ry, rz)) {
-                glm::vec3 r(rx, ry, rz);
-                m_layers[l].first->setRotate(r);
-            }
-            float tx = 0.f, ty = 0.f, tz = 0.f;
-            if (evaluateTranslateAt(l, absTimeMs, tx, ty, tz)) {
-                glm::vec3 t(tx, ty, tz);
-                m_layers[l].first->setTranslate(t);
-            }
+            changed[l] = applyTimelineValues(l, *track, absTimeMs, targetAlpha);
         } else {
             // No keyframes: layer is fully visible at the outro boundary, fades to 0
             int dur = outroDuration();
             if (dur > 0) {
                 float ft = static_cast<float>(std::min(outroTimeMs, dur)) / static_cast<float>(dur);
-                m_layers[l].first->setAlpha(1.f - ft);
+                changed[l] = applyTimelineAlpha(l, 1.f - ft);
             }
         }
-        updateLayer(l);
     }
+    updateChangedLayers(changed);
 }
 
 // ---- Timeline playback (per-slide) ------------------------------------------
 
+static TimelinePlayback timelinePlayback(int anchorPosMs, int rate, int minPosMs, int maxPosMs) {
+    TimelinePlayback playback;
+    playback.anchorClockMs = TimelinePlayback::clockMs();
+    playback.anchorPosMs = anchorPosMs;
+    playback.rate = rate;
+    playback.minPosMs = minPosMs;
+    playback.maxPosMs = maxPosMs;
+    return playback;
+}
+
 void LayersModel::startTimeline() {
     startTimelineFrom(0);
 }
@@ -2086,6 +2281,8 @@ void LayersModel::startTimelineFrom(int startMs) {
     m_timelineReversed    = false;
     m_timelinePositionMs  = m_timelinePauseOffset;
     m_timelineElapsed.start();
+    m_timelinePlayback = timelinePlayback(m_timelinePauseOffset, 1, 0, hasOutro() ? introDuration() : m_timelineDuration);
+    updateLayerTimelines();
     ensureTimerRunning();
 
     Q_EMIT timelineStarted();
@@ -2103,6 +2300,8 @@ void LayersModel::startTimelineReverse() {
     m_timelineReversed    = true;
     m_timelinePositionMs  = m_timelineDuration;
     m_timelineElapsed.start();
+    m_timelinePlayback = timelinePlayback(m_timelineDuration, -1, 0, m_timelineDuration);
+    updateLayerTimelines();
     ensureTimerRunning();
 
     Q_EMIT timelineStarted();
@@ -2120,6 +2319,8 @@ void LayersModel::startTimelineIntro() {
     m_timelineReversed    = false;
     m_timelinePositionMs  = 0;
     m_timelineElapsed.start();
+    m_timelinePlayback = timelinePlayback(0, 1, 0, hasOutro() ? introDuration() : m_timelineDuration);
+    updateLayerTimelines();
     ensureTimerRunning();
 
     Q_EMIT timelineStarted();
@@ -2141,6 +2342,8 @@ void LayersModel::startTimelineOutro() {
     m_outroRunning = true;
     m_timelinePositionMs = getTimelineOutroStart();
     m_outroElapsed.start();
+    m_outroPlayback = timelinePlayback(getTimelineOutroStart(), 1, getTimelineOutroStart(), m_timelineDuration);
+    updateLayerTimelines();
     ensureTimerRunning();
 
     Q_EMIT outroStarted();
@@ -2151,6 +2354,7 @@ void LayersModel::stopTimeline() {
     if (!m_timelineRunning)
         return;
     m_timelineRunning = false;
+    updateLayerTimelines();
     stopTimerIfIdle();
     Q_EMIT timelineStopped();
 }
@@ -2160,6 +2364,7 @@ void LayersModel::stopOutro() {
         return;
     m_outroRunning = false;
     m_outroTargetAlpha.clear();
+    updateLayerTimelines();
     stopTimerIfIdle();
     Q_EMIT outroStopped();
 }
@@ -2169,6 +2374,7 @@ void LayersModel::stopAllTimelines() {
     m_timelineRunning = false;
     m_outroRunning    = false;
     m_outroTargetAlpha.clear();
+    updateLayerTimelines();
     if (m_timelineTimer)
         m_timelineTimer->stop();
     if (wasRunning) {
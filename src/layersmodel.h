@@ -10,7 +10,9 @@
 
 #include <QAbstractListModel>
 #include <QElapsedTimer>
+#include <QHash>
 #include <layers/baselayer.h>
+#include <utils/timelinetrack.h>
 #include <QtQml/qqmlregistration.h>
 #include <QVector>
 #include <memory>
@@ -21,6 +23,7 @@ using Layers = QList<QPair<std::shared_ptr<BaseLayer>, int>>;
 
 // A single keyframe: time in milliseconds [0, timelineDuration] and alpha [0.0, 1.0]
 // Rotation (X/Y/Z in degrees) and translation (X/Y/Z) are optional per-keyframe.
+// Easing applies to the segment from this keyframe to the next one.
 struct LayerKeyframe {
     int     timeMs = 0;
     float   alpha  = 0.f;
@@ -32,6 +35,11 @@ struct LayerKeyframe {
     float   translateX = 0.f;
     float   translateY = 0.f;
     float   translateZ = 0.f;
+    int     easing = 0; // TimelineEasing
+    float   bezierX1 = 0.f;
+    float   bezierY1 = 0.f;
+    float   bezierX2 = 1.f;
+    float   bezierY2 = 1.f;
 };
 
 // Per-layer timeline track: ordered list of keyframes
@@ -91,11 +99,16 @@ public:
 
     int numberOfLayers();
     bool needsSync();
-    void setHasSynced();
+    void setHasSynced(bool allIterations = false);
 
     Q_INVOKABLE BaseLayer *layer(int i);
     std::shared_ptr<BaseLayer> layerShared(int i);
 
+    // Thumbnail hash of the layers, kept until they or their files change.
+    // rebuilt is set when the hash had to be computed again.
+    QString thumbnailHash(bool *rebuilt = nullptr);
+    void invalidateThumbnailHash();
+
     Q_INVOKABLE QString layerTitle(int i) const;
     Q_INVOKABLE int layerVisibility(int i) const;
     Q_INVOKABLE int layerIdx(std::string title);
@@ -189,10 +202,22 @@ public:
     Q_INVOKABLE QString checkAndCorrectPath(const QString &filePath, const QStringList &searchPaths);
     Q_INVOKABLE QString makePathRelativeTo(const QString &filePath, const QStringList &pathsToConsider);
 
-    void decodeFromJSON(QJsonObject &obj, const QStringList &forRelativePaths);
+    // resolvedPaths optionally holds already resolved media paths (raw path -> result of
+    // checkAndCorrectPath), so the file system probing can be done ahead of time off the GUI thread.
+    void decodeFromJSON(QJsonObject &obj, const QStringList &forRelativePaths, const QHash<QString, QString> *resolvedPaths = nullptr);
     void encodeToJSON(QJsonObject &obj, const QStringList &forRelativePaths);
 
+    // Layer type of a layer JSON object, or 0 if unknown
+    static int layerTypeFromJSON(const QJsonObject &layerObj);
+    // Raw paths of all file based layers in a slide JSON object, that need checkAndCorrectPath
+    static QStringList mediaPathsFromJSON(const QJsonObject &obj);
+
     bool runRenderOnLayersThatShouldUpdate(bool updateRendering, bool preload);
+    // Whether runRenderOnLayersThatShouldUpdate has work beyond static layers,
+    // i.e. layers that are loading or live
+    bool hasLayersToUpdate(bool preload) const;
+    // Sum of the layer change counters, changes whenever a layer property does
+    uint64_t layersChangeCount() const;
 
     // ---- Timeline --------------------------------------------------------
 
@@ -240,6 +265,9 @@ public:
                                     float rotateX, float rotateY, float rotateZ,
                                     bool hasTranslate,
                                     float translateX, float translateY, float translateZ);
+    // easing: 0 linear, 1 ease in, 2 ease out, 3 ease in-out, 4 custom Bezier (x1, y1, x2, y2), 5 Catmull-Rom
+    Q_INVOKABLE void setKeyframeEasing(int layerIdx, int keyframeIdx, int easing,
+                                       float x1 = 0.f, float y1 = 0.f, float x2 = 1.f, float y2 = 1.f);
     Q_INVOKABLE bool layerHasKeyframes(int layerIdx) const;
 
     // Evaluate interpolated alpha for a given layer at a given time
@@ -310,6 +338,17 @@ Q_SIGNALS:
 private:
     void setNeedSync();
     void ensureTimelineSizeMatchesLayers();
+    // Marks the compiled tracks as stale after keyframes were edited or loaded
+    void invalidateCompiledTimelines();
+    // Compiled track of layer, rebuilt on demand. Null if the layer has no keyframes.
+    std::shared_ptr<const TimelineTrack> compiledTimeline(int layerIdx) const;
+    // Hands the running playback (if any) to the layers, so nodes animate them locally
+    void updateLayerTimelines();
+    // Writes the evaluated values into the layer, returns true if any of them changed
+    bool applyTimelineValues(int layerIdx, const TimelineTrack &track, int timeMs, float alphaScale);
+    bool applyTimelineAlpha(int layerIdx, float alpha);
+    // Emits dataChanged once per contiguous run of changed rows
+    void updateChangedLayers(const std::vector<bool> &changed);
 
     Layers m_layers;
     LayersTypeModel *m_layerTypeModel;
@@ -323,12 +362,16 @@ private:
     int m_syncIteration;
     QString m_layersName;
     QString m_layersPath;
+    QString m_thumbnailHash;
+    bool m_thumbnailHashValid = false;
 
     // Timeline data
     bool m_hasTimeline = false;
     int  m_timelineDuration = 5000; // ms
     int  m_timelineOutroStart = -1; // ms, -1 = no split
     QVector<LayerTimeline> m_layerTimelines;
+    mutable std::vector<std::shared_ptr<const TimelineTrack>> m_compiledTimelines;
+    mutable bool m_compiledTimelinesDirty = true;
 
     // Timeline playback state (per-slide)
     void onTimelineTick();
@@ -337,12 +380,14 @@ private:
 
     QTimer*        m_timelineTimer = nullptr;
     QElapsedTimer  m_timelineElapsed;
+    TimelinePlayback m_timelinePlayback;
     int            m_timelinePauseOffset = 0;
     bool           m_timelineRunning     = false;
     bool           m_timelineReversed    = false;
     int            m_timelinePositionMs  = 0;
 
     QElapsedTimer  m_outroElapsed;
+    TimelinePlayback m_outroPlayback;
     bool           m_outroRunning        = false;
     QVector<float> m_outroTargetAlpha;
 };
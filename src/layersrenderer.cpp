@@ -10,6 +10,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <sgct/opengl.h>
+#include <utils/frameprofiler.h>
+#include <algorithm>
+#include <array>
 
 constexpr std::string_view VideoVert = R"(
   #version 410 core
@@ -105,6 +108,82 @@ constexpr std::string_view MeshVert = R"(
   }
 )";
 
+// Same as MeshVert, with matrix, ROI and alpha per instance
+constexpr std::string_view InstancedMeshVert = R"(
+  #version 410 core
+
+  layout (location = 0) in vec2 in_texCoord;
+  layout (location = 1) in vec3 in_normal;
+  layout (location = 2) in vec3 in_position;
+
+  struct Instance {
+    mat4 mvp;
+    vec4 roi;
+    vec4 alpha; // x
+  };
+
+  layout (std140) uniform Instances {
+    Instance instances[16]; // LayersRenderer::MaxInstances
+  };
+
+  uniform int eye;
+  uniform int stereoscopicMode;
+  uniform bool flipY;
+
+  out vec2 tr_uv;
+  out vec3 tr_normals;
+  flat out float tr_alpha;
+
+  void main() {
+    Instance instance = instances[gl_InstanceID];
+    gl_Position = instance.mvp * vec4(in_position, 1.0);
+    tr_uv = flipY ? vec2(in_texCoord.x, 1.0-in_texCoord.y) : in_texCoord;
+    tr_uv = (tr_uv * instance.roi.zw) + instance.roi.xy;
+    tr_normals = in_normal;
+    tr_alpha = instance.alpha.x;
+
+    if(eye==2) { //Right Eye
+        if(stereoscopicMode==1) { //Side-by-side
+            tr_uv = (tr_uv * vec2(0.5, 1.0)) + vec2(0.5, 0.0);
+        }
+        else if(stereoscopicMode==2) { //Top-bottom
+            tr_uv = tr_uv * vec2(1.0, 0.5);
+        }
+        else if(stereoscopicMode==3) { //Top-bottom-flip
+            tr_uv = tr_uv * vec2(1.0, 0.5);
+            tr_uv = vec2(1.0 - tr_uv.y, tr_uv.x);
+        }
+    }
+    else { // Left Eye or Mono
+        if(stereoscopicMode==1) { //Side-by-side
+            tr_uv = tr_uv * vec2(0.5, 1.0);
+        }
+        else if(stereoscopicMode==2) { //Top-bottom
+            tr_uv = (tr_uv * vec2(1.0, 0.5)) + vec2(0.0, 0.5);
+        }
+        else if(stereoscopicMode==3) { //Top-bottom-flip
+            tr_uv = (tr_uv * vec2(1.0, 0.5)) + vec2(0.0, 0.5);
+            tr_uv = vec2(1.0 - tr_uv.y, tr_uv.x);
+        }
+    }
+  }
+)";
+
+constexpr std::string_view InstancedVideoFrag = R"(
+  #version 410 core
+
+  uniform sampler2D tex;
+
+  in vec2 tr_uv;
+  in vec3 tr_normals;
+  flat in float tr_alpha;
+  out vec4 out_color;
+
+  void main() {
+    out_color = texture(tex, tr_uv) * vec4(1.0, 1.0, 1.0, tr_alpha);
+  }
+)";
+
 constexpr std::string_view VideoFrag = R"(
   #version 410 core
 
@@ -388,13 +467,22 @@ LayersRenderer::LayersRenderer() : meshRadius(0),
                                  EACStereoscopicModeLoc(-1),
                                  videoPrg(nullptr),
                                  meshPrg(nullptr),
-                                 EACPrg(nullptr) {
+                                 EACPrg(nullptr),
+                                 instancedPrg(nullptr),
+                                 instancedEyeModeLoc(-1),
+                                 instancedFlipYLoc(-1),
+                                 instancedStereoscopicModeLoc(-1),
+                                 instanceBuffer(0) {
 }
 
 LayersRenderer::~LayersRenderer() {
     layers2render.clear();
     domeMesh.reset();
     sphereMesh.reset();
+    unitPlane.reset();
+    if (instanceBuffer != 0) {
+        glDeleteBuffers(1, &instanceBuffer);
+    }
 }
 
 void LayersRenderer::initializeGL(double radius, double fov) {
@@ -405,6 +493,8 @@ void LayersRenderer::initializeGL(double radius, double fov) {
         sgct::ShaderManager::instance().addShaderProgram("EAC", EACMeshVert, EACVideoFrag);
     if (!sgct::ShaderManager::instance().shaderProgramExists("video"))
         sgct::ShaderManager::instance().addShaderProgram("video", VideoVert, VideoFrag);
+    if (!sgct::ShaderManager::instance().shaderProgramExists("meshInstanced"))
+        sgct::ShaderManager::instance().addShaderProgram("meshInstanced", InstancedMeshVert, InstancedVideoFrag);
 
     // OBS: Need to create all shaders befor using any of them. Bug?
     meshPrg = &sgct::ShaderManager::instance().shaderProgram("mesh");
@@ -449,6 +539,28 @@ void LayersRenderer::initializeGL(double radius, double fov) {
         videoPrg->unbind();
     }
 
+    instancedPrg = &sgct::ShaderManager::instance().shaderProgram("meshInstanced");
+    if (instancedPrg) {
+        instancedPrg->bind();
+        glUniform1i(glGetUniformLocation(instancedPrg->id(), "tex"), 0);
+        instancedEyeModeLoc = glGetUniformLocation(instancedPrg->id(), "eye");
+        instancedFlipYLoc = glGetUniformLocation(instancedPrg->id(), "flipY");
+        instancedStereoscopicModeLoc = glGetUniformLocation(instancedPrg->id(), "stereoscopicMode");
+        glUniformBlockBinding(instancedPrg->id(), glGetUniformBlockIndex(instancedPrg->id(), "Instances"), 0);
+        instancedPrg->unbind();
+
+        if (instanceBuffer == 0) {
+            glGenBuffers(1, &instanceBuffer);
+            glBindBuffer(GL_UNIFORM_BUFFER, instanceBuffer);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(InstanceData) * MaxInstances, nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        }
+    }
+
+    // Unit plane, scaled per instance to the size of each sublayer plane
+    if (!unitPlane)
+        unitPlane = std::make_unique<PlaneGrid>(1.f, 1.f);
+
     updateMeshes(radius, fov);
 }
 
@@ -474,6 +586,18 @@ const std::vector<std::shared_ptr<BaseLayer>> &LayersRenderer::getLayers() {
     return layers2render;
 }
 
+// Level of detail of a dome or sphere mesh centred at center, as seen through
+// the current viewport (one cube face when rendering fisheye)
+template <typename Mesh>
+static unsigned int meshLevel(const Mesh &mesh, const sgct::RenderData &data, const glm::vec3 &center) {
+    const glm::mat4 modelView = glm::make_mat4(data.viewMatrix.values.data()) * glm::make_mat4(data.modelMatrix.values.data());
+    const glm::vec3 eye = glm::vec3(glm::inverse(modelView)[3]);
+    const float projectionScale = glm::make_mat4(data.projectionMatrix.values.data())[1][1];
+    GLint viewport[4] = { 0, 0, 0, 0 };
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    return mesh.levelFor(glm::distance(eye, center), projectionScale, static_cast<float>(viewport[3]));
+}
+
 void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer* layer, sgct::FrustumMode currentEye, float angle) {
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, layer->textureId());
@@ -481,6 +605,7 @@ void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer*
 
     if (layer->gridMode() == 4) {
         glEnable(GL_CULL_FACE);
+        const unsigned int level = meshLevel(*sphereMesh, data, layer->translate());
 
         EACPrg->bind();
 
@@ -509,7 +634,7 @@ void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer*
         MVP_transformed_rot = glm::rotate(MVP_transformed_rot, glm::radians(90.f), glm::vec3(0.0f, 0.0f, 1.0f));                     // roll
         glUniformMatrix4fv(EACMatrixLoc, 1, GL_FALSE, &MVP_transformed_rot[0][0]);
 
-        sphereMesh->draw();
+        sphereMesh->draw(level);
 
         // Set up frontface culling
         glCullFace(GL_FRONT);
@@ -524,7 +649,7 @@ void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer*
         glUniformMatrix4fv(EACMatrixLoc, 1, GL_FALSE, &MVP_transformed_rot2[0][0]);
         // render outside sphere
         glUniform1i(EACOutsideLoc, 1);
-        sphereMesh->draw();
+        sphereMesh->draw(level);
 
         // Set up backface culling again
         glCullFace(GL_BACK);
@@ -536,6 +661,7 @@ void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer*
     }
     else if (layer->gridMode() == 3) {
         glEnable(GL_CULL_FACE);
+        const unsigned int level = meshLevel(*sphereMesh, data, layer->translate());
 
         const sgct::mat4 mvp = data.modelViewProjectionMatrix;
         glm::mat4 MVP_transformed = glm::translate(glm::make_mat4(mvp.values.data()), layer->translate());
@@ -570,7 +696,7 @@ void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer*
 
         // render inside sphere
         glUniform1i(meshOutsideLoc, 0);
-        sphereMesh->draw();
+        sphereMesh->draw(level);
 
         // Set up frontface culling
         glCullFace(GL_FRONT);
@@ -584,7 +710,7 @@ void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer*
         glUniformMatrix4fv(meshMatrixLoc, 1, GL_FALSE, &MVP_transformed_rot2[0][0]);
         // render outside sphere
         glUniform1i(meshOutsideLoc, 1);
-        sphereMesh->draw();
+        sphereMesh->draw(level);
 
         // Set up backface culling again
         glCullFace(GL_BACK);
@@ -625,7 +751,7 @@ void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer*
         MVP_transformed_rot = glm::rotate(MVP_transformed_rot, glm::radians(layer->rotate().y), glm::vec3(0.0f, 1.0f, 0.0f));         // yaw
         glUniformMatrix4fv(meshMatrixLoc, 1, GL_FALSE, &MVP_transformed_rot[0][0]);
 
-        domeMesh->draw();
+        domeMesh->draw(meshLevel(*domeMesh, data, layer->translate()));
 
         meshPrg->unbind();
 
@@ -711,6 +837,7 @@ void LayersRenderer::renderLayer(const sgct::RenderData& data, const BaseLayer*
 }
 
 void LayersRenderer::renderLayers(const sgct::RenderData &data, int viewMode, float angle) {
+    FrameProfiler::Scope profileScope("renderLayers", true);
     sgct::FrustumMode currentEye = data.frustumMode;
 
     // Check if we force all viewports to 2D, meaning only show LeftEye if 3D
@@ -721,11 +848,9 @@ void LayersRenderer::renderLayers(const sgct::RenderData &data, int viewMode, fl
     const int currentEyeInt = static_cast<int>(currentEye);
 
     for (const auto &layer : layers2render) {
+        FrameProfiler::Scope layerScope("renderLayer", layer.get());
         if (layer->hasSubLayers()) {
-            for (const auto& sublayer : layer->getSubLayers()) {
-                if (sublayer->shouldRenderForEye(currentEyeInt))
-                    renderLayer(data, sublayer.get(), currentEye, angle);
-            }
+            renderSubLayers(data, layer->getSubLayers(), currentEye, angle);
         }
         else if (!layer->isQRCodeDetectionEnabled() || layer->isQRCodeDetectionEnabled() && !layer->hasSubLayers()) {
             if (layer->shouldRenderForEye(currentEyeInt))
@@ -733,3 +858,121 @@ void LayersRenderer::renderLayers(const sgct::RenderData &data, int viewMode, fl
         }
     }
 }
+
+bool LayersRenderer::canRenderInstanced(const BaseLayer* layer) const {
+    if (!instancedPrg || instanceBuffer == 0)
+        return false;
+    if (layer->gridMode() == BaseLayer::GridMode::Plane)
+        return unitPlane && layer->hasPlane();
+    return layer->gridMode() == BaseLayer::GridMode::Dome && domeMesh;
+}
+
+void LayersRenderer::renderSubLayers(const sgct::RenderData& data, const std::vector<std::shared_ptr<BaseLayer>>& subLayers, sgct::FrustumMode currentEye, float angle) {
+    const int currentEyeInt = static_cast<int>(currentEye);
+
+    // Consecutive sublayers that sample the same texture the same way are
+    // drawn together, which keeps the draw order for blending.
+    std::vector<const BaseLayer*> batch;
+    auto flush = [&]() {
+        if (batch.size() > 1)
+            renderInstanced(data, batch, currentEye, angle);
+        else if (batch.size() == 1)
+            renderLayer(data, batch.front(), currentEye, angle);
+        batch.clear();
+    };
+
+    for (const auto& sublayer : subLayers) {
+        if (!sublayer->shouldRenderForEye(currentEyeInt))
+            continue;
+
+        const BaseLayer* layer = sublayer.get();
+        if (!canRenderInstanced(layer)) {
+            flush();
+            renderLayer(data, layer, currentEye, angle);
+            continue;
+        }
+
+        if (!batch.empty()) {
+            const BaseLayer* first = batch.front();
+            if (batch.size() == MaxInstances
+                || first->textureId() != layer->textureId()
+                || first->gridMode() != layer->gridMode()
+                || first->stereoMode() != layer->stereoMode()
+                || first->flipY() != layer->flipY()) {
+                flush();
+            }
+        }
+        batch.push_back(layer);
+    }
+    flush();
+}
+
+void LayersRenderer::renderInstanced(const sgct::RenderData& data, const std::vector<const BaseLayer*>& batch, sgct::FrustumMode currentEye, float angle) {
+    const BaseLayer* first = batch.front();
+    const bool plane = first->gridMode() == BaseLayer::GridMode::Plane;
+
+    std::array<InstanceData, MaxInstances> instances;
+    const GLsizei count = static_cast<GLsizei>(std::min<size_t>(batch.size(), MaxInstances));
+    for (GLsizei i = 0; i < count; i++) {
+        const BaseLayer* layer = batch[i];
+        InstanceData& instance = instances[i];
+
+        if (plane) {
+            // Same transform as a single plane, scaled from the unit plane
+            const sgct::mat4 mvp = data.projectionMatrix * data.viewMatrix;
+            glm::mat4 planeTransform = glm::mat4(1.0f);
+            planeTransform = glm::rotate(planeTransform, glm::radians(-angle), glm::vec3(1.0f, 0.0f, 0.0f));
+            planeTransform = glm::rotate(planeTransform, glm::radians(float(layer->planeAzimuth())), glm::vec3(0.0f, -1.0f, 0.0f));  // azimuth
+            planeTransform = glm::rotate(planeTransform, glm::radians(float(layer->planeElevation())), glm::vec3(1.0f, 0.0f, 0.0f)); // elevation
+            planeTransform = glm::rotate(planeTransform, glm::radians(float(layer->planeRoll())), glm::vec3(0.0f, 0.0f, 1.0f));      // roll
+            planeTransform = glm::translate(planeTransform, glm::vec3(float(layer->planeHorizontal()) / 100.f, float(layer->planeVertical()) / 100.f, float(-layer->planeDistance()) / 100.f));
+            planeTransform = glm::scale(planeTransform, glm::vec3(layer->planeActualSize() / 100.f, 1.0f));
+            instance.mvp = glm::make_mat4(mvp.values.data()) * planeTransform;
+        }
+        else {
+            const sgct::mat4 mvp = data.modelViewProjectionMatrix;
+            glm::mat4 MVP_transformed_rot = glm::translate(glm::make_mat4(mvp.values.data()), layer->translate());
+            MVP_transformed_rot = glm::rotate(MVP_transformed_rot, glm::radians(layer->rotate().z), glm::vec3(0.0f, 0.0f, 1.0f));         // roll
+            MVP_transformed_rot = glm::rotate(MVP_transformed_rot, glm::radians(layer->rotate().x - angle), glm::vec3(1.0f, 0.0f, 0.0f)); // pitch
+            MVP_transformed_rot = glm::rotate(MVP_transformed_rot, glm::radians(layer->rotate().y), glm::vec3(0.0f, 1.0f, 0.0f));         // yaw
+            instance.mvp = MVP_transformed_rot;
+        }
+        instance.roi = layer->roiEnabled() ? layer->roi() : glm::vec4(0.f, 0.f, 1.f, 1.f);
+        instance.alpha = glm::vec4(layer->alpha(), 0.f, 0.f, 0.f);
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, first->textureId());
+    glEnable(GL_BLEND);
+    glEnable(GL_CULL_FACE);
+    if (plane)
+        glCullFace(GL_FRONT);
+
+    instancedPrg->bind();
+
+    if (first->stereoMode() > 0) {
+        glUniform1i(instancedEyeModeLoc, (GLint)currentEye);
+        glUniform1i(instancedStereoscopicModeLoc, (GLint)first->stereoMode());
+    }
+    else {
+        glUniform1i(instancedEyeModeLoc, 0);
+        glUniform1i(instancedStereoscopicModeLoc, 0);
+    }
+    glUniform1i(instancedFlipYLoc, (first->flipY() ? 1 : 0));
+
+    glBindBuffer(GL_UNIFORM_BUFFER, instanceBuffer);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(InstanceData) * count, instances.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, instanceBuffer);
+
+    if (plane)
+        unitPlane->draw(count);
+    else
+        domeMesh->draw(meshLevel(*domeMesh, data, first->translate()), count);
+
+    instancedPrg->unbind();
+
+    // Set up backface culling again
+    glCullFace(GL_BACK);
+    glDisable(GL_CULL_FACE);
+}
@@ -12,6 +12,7 @@
 #include <mutex>
 #include <sgct/sgct.h>
 #include <utils/domegrid.h>
+#include <utils/planegrid.h>
 #include <utils/spheregrid.h>
 
 class LayersRenderer {
@@ -31,7 +32,21 @@ public:
     void renderLayer(const sgct::RenderData& data, const BaseLayer* layer, sgct::FrustumMode currentEye, float angle);
     void renderLayers(const sgct::RenderData& data, int viewMode, float angle);
 
+    // Sublayers per instanced draw, same as the array size in InstancedMeshVert
+    static constexpr size_t MaxInstances = 16;
+
 private:
+    // Per-instance data in the std140 "Instances" uniform block
+    struct InstanceData {
+        glm::mat4 mvp;
+        glm::vec4 roi;
+        glm::vec4 alpha; // x
+    };
+
+    bool canRenderInstanced(const BaseLayer* layer) const;
+    void renderSubLayers(const sgct::RenderData& data, const std::vector<std::shared_ptr<BaseLayer>>& subLayers, sgct::FrustumMode currentEye, float angle);
+    void renderInstanced(const sgct::RenderData& data, const std::vector<const BaseLayer*>& batch, sgct::FrustumMode currentEye, float angle);
+
     std::vector<std::shared_ptr<BaseLayer>> layers2render;
 
     double meshRadius;
@@ -68,6 +83,14 @@ private:
 
     std::unique_ptr<DomeGrid> domeMesh;
     std::unique_ptr<SphereGrid> sphereMesh;
+
+    // Sublayers sharing a texture, drawn as dome or plane instances
+    const sgct::ShaderProgram *instancedPrg;
+    int instancedEyeModeLoc;
+    int instancedFlipYLoc;
+    int instancedStereoscopicModeLoc;
+    unsigned int instanceBuffer;
+    std::unique_ptr<PlaneGrid> unitPlane;
 };
 
 #endif // LAYERSRENDERER_H
\ No newline at end of file
@@ -14,7 +14,6 @@
 #include "userinterfacesettings.h"
 #include <QOpenGLContext>
 #include <QQuickGraphicsDevice>
-#include <QTimer>
 #include <QtCore/QRunnable>
 #include <QtQuick/qquickwindow.h>
 #include <glm/glm.hpp>
@@ -390,7 +389,6 @@ std::mutex LayersRendererQtItem::s_layerAccessMutex;
 
 LayersRendererQtItem::LayersRendererQtItem()
     : m_renderer(nullptr), 
-    m_timer(nullptr), 
     m_fieldOfView(90.0f),
     m_cameraPosition(0.0f, 0.0f, 0.0f),
     m_cameraEulerRotation(0.0f, 0.0f, 0.0f) {
@@ -399,6 +397,15 @@ LayersRendererQtItem::LayersRendererQtItem()
     m_meshAngle = GridSettings::surfaceAngle();
 
     connect(this, &QQuickItem::windowChanged, this, &LayersRendererQtItem::handleWindowChanged);
+
+    // Property changes do not touch the scene graph, so ask for a new frame ourselves
+    connect(this, &LayersRendererQtItem::cameraChanged, this, &LayersRendererQtItem::markPreviewDirty);
+    connect(this, &LayersRendererQtItem::meshRadiusChanged, this, &LayersRendererQtItem::markPreviewDirty);
+    connect(this, &LayersRendererQtItem::meshFovChanged, this, &LayersRendererQtItem::markPreviewDirty);
+    connect(this, &LayersRendererQtItem::meshAngleChanged, this, &LayersRendererQtItem::markPreviewDirty);
+    connect(this, &LayersRendererQtItem::backgroundImageFileChanged, this, &LayersRendererQtItem::markPreviewDirty);
+    connect(this, &LayersRendererQtItem::foregroundImageFileChanged, this, &LayersRendererQtItem::markPreviewDirty);
+    connect(this, &LayersRendererQtItem::mpvObjectChanged, this, &LayersRendererQtItem::markPreviewDirty);
 }
 
 float LayersRendererQtItem::fieldOfView() const {
@@ -474,7 +481,19 @@ MpvObject* LayersRendererQtItem::mpvObject() const {
 void LayersRendererQtItem::setMpvObject(MpvObject* mpv) {
     if (m_mpvObject == mpv)
         return;
+    if (m_mpvObject)
+        disconnect(m_mpvObject, nullptr, this, nullptr);
     m_mpvObject = mpv;
+    if (m_mpvObject) {
+        // Seeking while paused, and the properties the preview draws the video with
+        connect(m_mpvObject, &MpvObject::positionChanged, this, &LayersRendererQtItem::markPreviewDirty);
+        connect(m_mpvObject, &MpvObject::visibilityChanged, this, &LayersRendererQtItem::markPreviewDirty);
+        connect(m_mpvObject, &MpvObject::stereoscopicModeChanged, this, &LayersRendererQtItem::markPreviewDirty);
+        connect(m_mpvObject, &MpvObject::gridToMapOnChanged, this, &LayersRendererQtItem::markPreviewDirty);
+        connect(m_mpvObject, &MpvObject::rotateChanged, this, &LayersRendererQtItem::markPreviewDirty);
+        connect(m_mpvObject, &MpvObject::translateChanged, this, &LayersRendererQtItem::markPreviewDirty);
+        connect(m_mpvObject, &MpvObject::planeChanged, this, &LayersRendererQtItem::markPreviewDirty);
+    }
     Q_EMIT mpvObjectChanged();
 }
 
@@ -531,25 +550,46 @@ void LayersRendererQtItem::handleWindowChanged(QQuickWindow* win) {
         connect(win, &QQuickWindow::sceneGraphInvalidated, this, &LayersRendererQtItem::cleanup, Qt::DirectConnection);
         win->setColor(Qt::black);
 
-        if (m_timer == nullptr) {
-            m_timer = new QTimer();
-            m_timer->setInterval((1.0f / 60.0f) * 1000.0f);
+        if (m_scheduler)
+            m_scheduler->removeItem(this);
+        m_scheduler = PreviewScheduler::forWindow(win);
+        m_scheduler->addItem(this, PreviewScheduler::Live, [this]() {
+            return previewIsDirty();
+        });
+    }
+}
 
-            connect(m_timer, &QTimer::timeout, win, &QQuickWindow::update);
+void LayersRendererQtItem::markPreviewDirty() {
+    if (m_scheduler)
+        m_scheduler->markDirty();
+}
 
-            m_timer->start();
+bool LayersRendererQtItem::previewIsDirty() {
+    if (s_shuttingDown)
+        return false;
+
+    bool dirty = false;
+    if (m_mpvObject && (!m_mpvObject->pause() || m_mpvObject->surfaceTransitionOnGoing()))
+        dirty = true;
+
+    if (Application::isCreated() && Application::instance().slidesModel()) {
+        SlidesModel* sm = Application::instance().slidesModel();
+        uint64_t changeCount = sm->layersChangeCount();
+        if (changeCount != m_seenChangeCount) {
+            m_seenChangeCount = changeCount;
+            dirty = true;
         }
+        if (!dirty && sm->hasLayersToUpdate())
+            dirty = true;
     }
+    return dirty;
 }
 
 void LayersRendererQtItem::cleanup() {
     beginShutdown();
 
-    if (m_timer) {
-        m_timer->stop();
-        m_timer->deleteLater();
-        m_timer = nullptr;
-    }
+    PreviewScheduler::removeItemLater(m_scheduler.data(), this);
+    m_scheduler = nullptr;
 
     if (window()) {
         disconnect(window(), &QQuickWindow::beforeSynchronizing, this, &LayersRendererQtItem::sync);
@@ -574,11 +614,8 @@ private:
 
 void LayersRendererQtItem::releaseResources() {
     beginShutdown();
-    if (m_timer) {
-        m_timer->stop();
-        m_timer->deleteLater();
-        m_timer = nullptr;
-    }
+    PreviewScheduler::removeItemLater(m_scheduler.data(), this);
+    m_scheduler = nullptr;
 
     if (m_renderer) {
         m_renderer->shutdown();
@@ -814,6 +851,14 @@ void LayersRendererQtOpenGLObject::renderQuad() {
     m_quadVAO.release();
 }
 
+// Level of detail of a dome or sphere mesh centred at center in the preview
+template <typename Mesh>
+static unsigned int meshLevel(const Mesh &mesh, const QMatrix4x4 &viewMatrix, const QMatrix4x4 &projectionMatrix,
+                              const QVector3D &center, int viewportHeight) {
+    const QVector3D eye = viewMatrix.inverted().map(QVector3D(0.0f, 0.0f, 0.0f));
+    return mesh.levelFor(eye.distanceToPoint(center), projectionMatrix(1, 1), static_cast<float>(viewportHeight));
+}
+
 void LayersRendererQtOpenGLObject::renderLayer(const BaseLayer* layer, int eyeMode, float angle,
     const QMatrix4x4& viewMatrix, const QMatrix4x4& projectionMatrix) {
     if (!layer || !layer->ready()) {
@@ -855,6 +900,7 @@ void LayersRendererQtOpenGLObject::renderLayer(const BaseLayer* layer, int eyeMo
 
         QMatrix4x4 mvp = projectionMatrix * viewMatrix;
         QVector3D translate(layer->translate().x, layer->translate().y, layer->translate().z);
+        const unsigned int level = m_sphereMesh ? meshLevel(*m_sphereMesh, viewMatrix, projectionMatrix, translate, m_viewportRect.height()) : 0;
         mvp.translate(translate);
 
         QMatrix4x4 mvpRot = mvp;
@@ -869,11 +915,11 @@ void LayersRendererQtOpenGLObject::renderLayer(const BaseLayer* layer, int eyeMo
 
         glCullFace(GL_BACK);
         if (m_sphereMesh)
-            m_sphereMesh->draw();
+            m_sphereMesh->draw(level);
 
         glCullFace(GL_FRONT);
         if (m_sphereMesh)
-            m_sphereMesh->draw();
+            m_sphereMesh->draw(level);
 
         // Restore backface culling
         glCullFace(GL_BACK);
@@ -886,6 +932,7 @@ void LayersRendererQtOpenGLObject::renderLayer(const BaseLayer* layer, int eyeMo
         // EQR sphere rendering
         QMatrix4x4 mvp = projectionMatrix * viewMatrix;
         QVector3D translate(layer->translate().x, layer->translate().y, layer->translate().z);
+        const unsigned int level = m_sphereMesh ? meshLevel(*m_sphereMesh, viewMatrix, projectionMatrix, translate, m_viewportRect.height()) : 0;
         mvp.translate(translate);
 
         QMatrix4x4 mvpRot = mvp;
@@ -923,11 +970,11 @@ void LayersRendererQtOpenGLObject::renderLayer(const BaseLayer* layer, int eyeMo
 
         glCullFace(GL_BACK);
         if (m_sphereMesh)
-            m_sphereMesh->draw();
+            m_sphereMesh->draw(level);
 
         glCullFace(GL_FRONT);
         if (m_sphereMesh)
-            m_sphereMesh->draw();
+            m_sphereMesh->draw(level);
 
         glDisable(GL_CULL_FACE);
 
@@ -967,7 +1014,7 @@ void LayersRendererQtOpenGLObject::renderLayer(const BaseLayer* layer, int eyeMo
         m_meshPrg->setUniformValue(m_meshMatrixLoc, mvpRot);
 
         if (m_domeMesh) {
-            m_domeMesh->draw();
+            m_domeMesh->draw(meshLevel(*m_domeMesh, viewMatrix, projectionMatrix, translate, m_viewportRect.height()));
         }
 
         m_meshPrg->release();
@@ -1087,6 +1134,8 @@ void LayersRendererQtOpenGLObject::renderMpvObject(MpvObject* mpv, int eyeMode,
         mpv->rotate().y(),
         mpv->rotate().z());
 
+    const unsigned int sphereLevel = m_sphereMesh ? meshLevel(*m_sphereMesh, viewMatrix, projectionMatrix, translate, m_viewportRect.height()) : 0;
+
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, texId);
     glEnable(GL_BLEND);
@@ -1134,11 +1183,11 @@ void LayersRendererQtOpenGLObject::renderMpvObject(MpvObject* mpv, int eyeMode,
 
         glCullFace(GL_BACK);
         if (m_sphereMesh)
-            m_sphereMesh->draw();
+            m_sphereMesh->draw(sphereLevel);
 
         glCullFace(GL_FRONT);
         if (m_sphereMesh)
-            m_sphereMesh->draw();
+            m_sphereMesh->draw(sphereLevel);
 
         // Restore backface culling
         glCullFace(GL_BACK);
@@ -1179,11 +1228,11 @@ void LayersRendererQtOpenGLObject::renderMpvObject(MpvObject* mpv, int eyeMode,
         
         glCullFace(GL_BACK);
         if (m_sphereMesh)
-            m_sphereMesh->draw();
+            m_sphereMesh->draw(sphereLevel);
 
         glCullFace(GL_FRONT);
         if (m_sphereMesh)
-            m_sphereMesh->draw();
+            m_sphereMesh->draw(sphereLevel);
 
         glDisable(GL_CULL_FACE);
         m_meshPrg->release();
@@ -1214,7 +1263,7 @@ void LayersRendererQtOpenGLObject::renderMpvObject(MpvObject* mpv, int eyeMode,
         m_meshPrg->setUniformValue(m_meshMatrixLoc, mvpRot);
 
         if (m_domeMesh)
-            m_domeMesh->draw();
+            m_domeMesh->draw(meshLevel(*m_domeMesh, viewMatrix, projectionMatrix, translate, m_viewportRect.height()));
 
         m_meshPrg->release();
     }
@@ -1526,7 +1575,7 @@ void LayersRendererQtOpenGLObject::renderLayers(float angle,
 
         m_meshPrg->setUniformValue(m_meshMatrixLoc, mvpRot);
 
-        m_domeMaskMesh->draw();
+        m_domeMaskMesh->draw(meshLevel(*m_domeMaskMesh, viewMatrix, projectionMatrix, QVector3D(), m_viewportRect.height()));
 
         m_meshPrg->release();
         glDisable(GL_BLEND);
@@ -14,7 +14,7 @@
 #include <QOpenGLVertexArrayObject>
 #include <QtQuick/QQuickItem>
 #include <QtQuick/QQuickWindow>
-#include <QTimer>
+#include <QPointer>
 #include <QVector3D>
 #include <QMatrix4x4>
 #include <atomic>
@@ -26,6 +26,7 @@
 #include <utils/domegrid.h>
 #include <utils/spheregrid.h>
 #include "mpvobject.h"
+#include "previewscheduler.h"
 
 class LayersRendererQtOpenGLObject : public QObject, protected QOpenGLFunctions {
     Q_OBJECT
@@ -206,9 +207,12 @@ private:
     void releaseResources() override;
 
     void updateCameraMatrices();
+    void markPreviewDirty();
+    bool previewIsDirty();
 
     LayersRendererQtOpenGLObject* m_renderer;
-    QTimer* m_timer;
+    QPointer<PreviewScheduler> m_scheduler;
+    uint64_t m_seenChangeCount = 0;
 
     float m_fieldOfView;
     QVector3D m_cameraPosition;
@@ -9,18 +9,29 @@
 #include <sgct/sgct.h>
 #define GLFW_INCLUDE_NONE
 #include "application.h"
+#include "clusterstats.h"
 #include <GLFW/glfw3.h>
+#include <format>
 #include <fstream>
 #include <glm/glm.hpp>
 #include <layersrenderer.h>
 #include <layers/baselayer.h>
 #include <layers/imagelayer.h>
+#include <layers/mpvinstancepool.h>
 #include <layers/videolayer.h>
 #include <layers/textlayer.h>
 #include <layersmodel.h>
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <mutex>
+#include <optional>
 #include <slidesmodel.h>
+#include <thread>
+#include <utils/frameprofiler.h>
+#include <utils/syncpayload.h>
+#include <unordered_map>
+#include <unordered_set>
 
 #ifdef MDK_SUPPORT
 #include <mdk/global.h>
@@ -31,6 +42,12 @@
 #include <ndi/ndilayer.h>
 #endif
 
+#ifdef SGCT_HAS_TEXT
+#include <sgct/font.h>
+#include <sgct/fontmanager.h>
+#include <sgct/freetype.h>
+#endif
+
 namespace {
 
 bool allowDirectRendering = false;
@@ -53,7 +70,23 @@ std::vector<PendingLayerPacket> pendingLayerPackets;
 bool pendingLayerPacketsAvailable = false;
 bool pendingLayerPacketsFullSync = false;
 bool pendingPreLoadLayers = false;
+
+// Full layer sync larger than SyncPayload::ChunkBytes, sent one chunk per frame
+struct LayerSyncChunks {
+    std::vector<std::byte> data;
+    size_t sent = 0;
+    int numLayers = 0;
+    // Layers sent with full information, which the nodes only have once the last chunk arrives
+    std::unordered_set<uint32_t> fullLayers;
+};
+std::optional<LayerSyncChunks> layerSyncChunks; // Master
+std::vector<std::byte> receivedLayerSyncChunks; // Node
+// Layers the nodes have from the last full sync, when only slides in scope are synced
+std::unordered_set<uint32_t> syncedScopeLayers; // Master
 std::atomic_bool shuttingDown = false;
+// Profiler traces are written on this thread, so the frame does not wait for the file
+std::unique_ptr<std::thread> profilerTraceThread;
+bool profilerTracePending = false; // Master, requested in encode()
 
 std::vector<std::shared_ptr<BaseLayer>> primaryLayers;
 std::shared_ptr<ImageLayer> backgroundImageLayer;
@@ -78,6 +111,27 @@ std::shared_ptr<LayersRenderer> layerRender;
 
 using namespace sgct;
 
+// Chrome trace of the profiler, next to the log files
+static void writeProfilerTrace(const std::string &nodeName) {
+    std::string path = std::format("./data/log/trace_{}_{}.json", nodeName, Engine::instance().currentFrameNumber());
+    if (profilerTraceThread)
+        profilerTraceThread->join();
+    profilerTraceThread = std::make_unique<std::thread>([path] {
+        if (FrameProfiler::instance().writeChromeTrace(path))
+            Log::Info("Wrote profiler trace " + path);
+        else
+            Log::Warning("Could not write profiler trace " + path);
+    });
+}
+
+// Node decode and apply times for the cluster stats, from the profiler scopes
+static void addDecodeTime(double ms) {
+    ClusterStats::instance().addNodeTime(ClusterStats::Decode, ms);
+}
+static void addApplyTime(double ms) {
+    ClusterStats::instance().addNodeTime(ClusterStats::Apply, ms);
+}
+
 static void *get_proc_address_glfw_v1(void*, const char *name) {
     return reinterpret_cast<void *>(glfwGetProcAddress(name));
 }
@@ -113,6 +167,9 @@ static void initOGL(GLFWwindow *) {
     layerRender = std::make_shared<LayersRenderer>();
     layerRender->initializeGL(SyncHelper::instance().variables.radius, SyncHelper::instance().variables.fov);
 
+    // GPU time of the profiler scopes is measured on this thread
+    FrameProfiler::instance().initializeGL();
+
     // Set up backface culling
     glCullFace(GL_BACK);
     // our polygon winding is clockwise since we are inside of the dome
@@ -120,15 +177,31 @@ static void initOGL(GLFWwindow *) {
 }
 
 static void preSync() {
+    FrameProfiler::instance().newFrame();
+    FrameProfiler::Scope profileScope("preSync");
+
+    // Decode and apply times of the last frames, for the master cluster stats
+    if (!Engine::instance().isMaster()) {
+        std::vector<std::byte> report;
+        if (ClusterStats::instance().takeNodeReport(Engine::instance().currentFrameNumber(), ClusterManager::instance().thisNodeId(), report)) {
+            NetworkManager::instance().transferData(report.data(), static_cast<int>(report.size()), ClusterStats::NodeReportPackageId);
+        }
+    }
 }
 
 static std::vector<std::byte> encode() {
+    FrameProfiler::Scope profileScope("encode");
+    auto encodeStart = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> frameLock(SyncHelper::instance().frameMutex);
     std::vector<std::byte> data;
+    SyncPayload::begin(data);
+    ClusterStats::EncodeSizes encodeSizes;
 
     serializeObject(data, SyncHelper::instance().variables.syncOn);
     serializeObject(data, SyncHelper::instance().variables.terminateNodes);
 
     if (SyncHelper::instance().variables.terminateNodes) {
+        SyncPayload::pack(data);
         return data;
     }
 
@@ -144,6 +217,10 @@ static std::vector<std::byte> encode() {
         serializeObject(data, SyncHelper::instance().variables.timeThreshold);
         serializeObject(data, SyncHelper::instance().variables.paused);
 
+        // Clock that nodes evaluate playing slide timelines against
+        SyncHelper::instance().variables.timelineClockMs = TimelinePlayback::clockMs();
+        serializeObject(data, SyncHelper::instance().variables.timelineClockMs);
+
         // MpvObject variables - only sync when dirty
         bool mpvSync = SyncHelper::instance().variables.mpvNeedSync;
         serializeObject(data, mpvSync);
@@ -226,6 +303,15 @@ static std::vector<std::byte> encode() {
                 SyncHelper::instance().variables.takeScreenshot = false;
             }
 
+            // Profiler
+            serializeObject(data, SyncHelper::instance().variables.profilerOn);
+            serializeObject(data, SyncHelper::instance().variables.profilerOverlay);
+            serializeObject(data, SyncHelper::instance().variables.profilerDumpTrace);
+            if (SyncHelper::instance().variables.profilerDumpTrace) {
+                profilerTracePending = true;
+                SyncHelper::instance().variables.profilerDumpTrace = false;
+            }
+
             SyncHelper::instance().variables.playerControllerNeedSync = false;
         }
 
@@ -276,6 +362,8 @@ static std::vector<std::byte> encode() {
         // 1. Check if slides needs sync, if yes, sync all slides and layers (except layers with "existOnMasterOnly" flag) with full information
         // 2. If sync is needed, only sync those layers with full information, and for the rest of the layers, perform a simpler "always" sync which contains update only
         // 3. If sync is not needed, perform a simpler "always" sync for all layers which contains update only
+        // Only layers of slides in the sync scope are synced (see SlidesModel::SyncScope). Nodes create layers
+        // when they enter the scope and delete them when they leave it, which takes a full sync.
 
         // Take a thread-safe snapshot of the slide list so we iterate over a stable copy
         // even if the GUI thread modifies slides concurrently.
@@ -299,8 +387,11 @@ static std::vector<std::byte> encode() {
             if (masterSlidePtr)
                 slidesToSync.push_back(std::make_pair(-1, masterSlidePtr));
 
-            // Check if model says sync needed
-            int totalLayersToSync = 0;
+            // Collect the layers in scope once, so the count matches what is written,
+            // and check if sync is needed
+            SlidesModel::SyncScope syncScope = Application::instance().slidesModel()->syncScope();
+            std::vector<std::shared_ptr<BaseLayer>> layersToSync;
+            std::unordered_set<uint32_t> scopeLayers;
             bool needLayerSync = Application::instance().slidesModel()->needsSync();
             for (auto& sp : slidesToSync) {
                 LayersModel* slide = sp.second;
@@ -308,81 +399,185 @@ static std::vector<std::byte> encode() {
                 for (int l = 0; l < numLayers; l++) {
                     std::shared_ptr<BaseLayer> layerPtr = slide->layerShared(l);
                     BaseLayer* layer = layerPtr.get();
-                    if (layer && !layer->existOnMasterOnly()) {
-                        totalLayersToSync++;
+                    if (layer && !layer->existOnMasterOnly() && syncScope.contains(sp.first, layer)) {
+                        scopeLayers.insert(layer->identifier());
                         if(layer->needSync()) {
                             needLayerSync = true;
                         }
+                        layersToSync.push_back(std::move(layerPtr));
                     }
                 }
             }
+            int totalLayersToSync = static_cast<int>(layersToSync.size());
+
+            // Layers entered or left the scope
+            if (scopeLayers != syncedScopeLayers)
+                needLayerSync = true;
+
+            // A full sync while chunks are in flight replaces that transfer, so it also carries
+            // the layers the nodes have not received yet. Past half way the transfer is finished
+            // first, so continuous edits can not keep restarting it.
+            if (needLayerSync && layerSyncChunks && layerSyncChunks->sent * 2 > layerSyncChunks->data.size())
+                needLayerSync = false;
 
-            serializeObject(data, needLayerSync);
-            serializeObject(data, Application::instance().slidesModel()->preLoadLayers());
             // Layers sync...
             // Orders is top to bottom in the list = (first to last in the vector)
             // Sync only complete layer information when needed
-            serializeObject(data, totalLayersToSync);
+            std::vector<std::byte> fullLayerData;
+            ClusterStats::EncodeSizes fullLayerSizes;
             if (needLayerSync) {
-                for (auto& sp : slidesToSync) {
-                    LayersModel* slideRaw = sp.second;
-                    int numLayers = slideRaw->numberOfLayers();
-                    for (int l = 0; l < numLayers; l++) {
-                        std::shared_ptr<BaseLayer> layerPtr = slideRaw->layerShared(l);
-                        BaseLayer *nextLayer = layerPtr.get();
-                        if(nextLayer && !nextLayer->existOnMasterOnly()) {
-                            serializeObject(data, nextLayer->identifier()); // ID
-                            bool needSync = nextLayer->needSync();
-                            serializeObject(data, needSync);   // Check needs sync
-                            serializeObject(data, static_cast<int>(nextLayer->type())); // Type
-
-                            std::vector<std::byte> layerData;
-                            if (needSync) {
-                                nextLayer->encodeFull(layerData);
-                                nextLayer->setHasSynced();
-                            }
-                            else {
-                                nextLayer->encodeAlways(layerData);
-                            }
-                            int layerDataSize = static_cast<int>(layerData.size());
-                            serializeObject(data, layerDataSize);
-                            data.insert(data.end(), layerData.begin(), layerData.end());
-                        }
+                std::vector<BaseLayer*> fullLayers;
+                std::unordered_set<uint32_t> fullLayerIds;
+                for (const std::shared_ptr<BaseLayer>& nextLayer : layersToSync) {
+                    serializeObject(fullLayerData, nextLayer->identifier()); // ID
+                    // Layers new to the scope are created on the nodes from full information
+                    bool needSync = nextLayer->needSync() || !syncedScopeLayers.contains(nextLayer->identifier())
+                        || (layerSyncChunks && layerSyncChunks->fullLayers.contains(nextLayer->identifier()));
+                    serializeObject(fullLayerData, needSync);   // Check needs sync
+                    serializeObject(fullLayerData, static_cast<int>(nextLayer->type())); // Type
+
+                    std::vector<std::byte> layerData;
+                    if (needSync) {
+                        nextLayer->encodeFull(layerData);
+                        fullLayers.push_back(nextLayer.get());
+                        fullLayerIds.insert(nextLayer->identifier());
                     }
-                    slideRaw->setHasSynced();
+                    else {
+                        nextLayer->encodeAlways(layerData);
+                    }
+                    int layerDataSize = static_cast<int>(layerData.size());
+                    serializeObject(fullLayerData, layerDataSize);
+                    if (needSync)
+                        fullLayerSizes.layerFull += layerData.size();
+                    else
+                        fullLayerSizes.layerAlways += layerData.size();
+                    fullLayerData.insert(fullLayerData.end(), layerData.begin(), layerData.end());
+                }
+
+                // Too large for one frame, which would stall all nodes. Sent in chunks
+                // from this frame on, with an "always" sync meanwhile. The chunks arrive
+                // reliably, so one transfer stands for all sync iterations.
+                bool chunked = fullLayerData.size() > SyncPayload::ChunkBytes;
+                for (BaseLayer* layer : fullLayers) {
+                    layer->setHasSynced(chunked);
+                }
+                for (auto& sp : slidesToSync) {
+                    sp.second->setHasSynced(chunked);
+                }
+                Application::instance().slidesModel()->setHasSynced(chunked);
+                syncedScopeLayers = std::move(scopeLayers);
+
+                if (chunked) {
+                    layerSyncChunks.emplace();
+                    layerSyncChunks->data = std::move(fullLayerData);
+                    layerSyncChunks->numLayers = totalLayersToSync;
+                    layerSyncChunks->fullLayers = std::move(fullLayerIds);
+                    needLayerSync = false;
+                }
+                else {
+                    // Sent inline, including everything the transfer in flight carried
+                    layerSyncChunks.reset();
                 }
-                Application::instance().slidesModel()->setHasSynced();
+            }
+
+            serializeObject(data, needLayerSync);
+            serializeObject(data, Application::instance().slidesModel()->preLoadLayers());
+            serializeObject(data, totalLayersToSync);
+            if (needLayerSync) {
+                encodeSizes.layerFull += fullLayerSizes.layerFull;
+                encodeSizes.layerAlways += fullLayerSizes.layerAlways;
+                data.insert(data.end(), fullLayerData.begin(), fullLayerData.end());
             }
             else {
                 // Perform a simpler "always" sync which contains update only
                 // Should never remove layers, but only update existing ones, so no need to send layer count or ID
-                for (auto& sp : slidesToSync) {
-                    LayersModel* slideRaw = sp.second;
-                    int numLayers = slideRaw->numberOfLayers();
-                    for (int l = 0; l < numLayers; l++) {
-                        std::shared_ptr<BaseLayer> layerPtr = slideRaw->layerShared(l);
-                        BaseLayer *nextLayer = layerPtr.get();
-                        if(nextLayer && !nextLayer->existOnMasterOnly()) {
-                            serializeObject(data, nextLayer->identifier()); // ID
-                            // Encode always data with a size prefix so clients can skip if layer not found
-                            std::vector<std::byte> alwaysData;
-                            nextLayer->encodeAlways(alwaysData);
-                            int alwaysSize = static_cast<int>(alwaysData.size());
-                            serializeObject(data, alwaysSize);
-                            data.insert(data.end(), alwaysData.begin(), alwaysData.end());
-                        }
-                    }
+                for (const std::shared_ptr<BaseLayer>& nextLayer : layersToSync) {
+                    serializeObject(data, nextLayer->identifier()); // ID
+                    // Encode always data with a size prefix so clients can skip if layer not found
+                    std::vector<std::byte> alwaysData;
+                    nextLayer->encodeAlways(alwaysData);
+                    int alwaysSize = static_cast<int>(alwaysData.size());
+                    serializeObject(data, alwaysSize);
+                    encodeSizes.layerAlways += alwaysData.size();
+                    data.insert(data.end(), alwaysData.begin(), alwaysData.end());
                 }
             }
         }
+
+        // Next chunk of a large full layer sync. Nodes collect the chunks and apply
+        // the sync when the last one arrives, so all nodes switch on the same frame.
+        bool sendLayerChunk = layerSyncChunks.has_value();
+        serializeObject(data, sendLayerChunk);
+        if (sendLayerChunk) {
+            const std::vector<std::byte> &chunks = layerSyncChunks->data;
+            size_t chunkSize = std::min(SyncPayload::ChunkBytes, chunks.size() - layerSyncChunks->sent);
+            serializeObject(data, static_cast<uint32_t>(layerSyncChunks->sent)); // Offset
+            serializeObject(data, static_cast<uint32_t>(chunks.size())); // Total size
+            serializeObject(data, layerSyncChunks->numLayers);
+            serializeObject(data, static_cast<uint32_t>(chunkSize));
+            data.insert(data.end(), chunks.begin() + layerSyncChunks->sent, chunks.begin() + layerSyncChunks->sent + chunkSize);
+            encodeSizes.layerFull += chunkSize;
+
+            layerSyncChunks->sent += chunkSize;
+            if (layerSyncChunks->sent >= chunks.size())
+                layerSyncChunks.reset();
+        }
     }
 
+    // Everything except the layer payloads counts as globals
+    encodeSizes.globals = data.size() - encodeSizes.layerFull - encodeSizes.layerAlways;
+    SyncPayload::pack(data);
+    encodeSizes.sent = data.size();
+    std::chrono::duration<double, std::milli> encodeTime = std::chrono::steady_clock::now() - encodeStart;
+    ClusterStats::instance().recordEncode(Engine::instance().currentFrameNumber(), encodeSizes, encodeTime.count());
+
     return data;
 }
 
-static void decode(const std::vector<std::byte> &data) {
+// Layer packets of a full layer sync, as written by encode()
+static bool readFullLayerPackets(const std::vector<std::byte> &data, unsigned int &pos, int numLayers, std::vector<PendingLayerPacket> &packets) {
+    for (int i = 0; i < numLayers; i++) {
+        if (pos + sizeof(uint32_t) + sizeof(bool) + sizeof(int) + sizeof(int) > data.size()) {
+            Log::Error("Decode: buffer exhausted in full layer sync at pos " + std::to_string(pos));
+            return false;
+        }
+
+        PendingLayerPacket packet;
+        deserializeObject(data, pos, packet.id);
+        deserializeObject(data, pos, packet.fullSync);
+        deserializeObject(data, pos, packet.layerType);
+
+        int payloadSize = 0;
+        deserializeObject(data, pos, payloadSize);
+        if (payloadSize < 0 || pos + static_cast<unsigned int>(payloadSize) > data.size()) {
+            Log::Warning("Decode: invalid layer payload size for layer " + std::to_string(packet.id));
+            return false;
+        }
+
+        packet.payload.insert(packet.payload.end(), data.begin() + pos, data.begin() + pos + payloadSize);
+        pos += static_cast<unsigned int>(payloadSize);
+        packets.push_back(std::move(packet));
+    }
+    return true;
+}
+
+static void decode(const std::vector<std::byte> &frame) {
+    FrameProfiler::Scope profileScope("decode", addDecodeTime);
     unsigned int pos = 0;
 
+    // Every frame would be dropped, so stop the node instead of running out of sync
+    if (!SyncPayload::compatible(frame)) {
+        Log::Error("Master compresses sync frames with zstd, but this node is built without BUILD_CPLAY_WITH_ZSTD. Build master and nodes with the same options.");
+        SyncHelper::instance().variables.terminateNodes = true;
+        return;
+    }
+
+    std::vector<std::byte> unpacked;
+    const std::vector<std::byte> *unpackedData = SyncPayload::unpack(frame, pos, unpacked);
+    if (!unpackedData)
+        return;
+    const std::vector<std::byte> &data = *unpackedData;
+
     // Helper to check if there's enough data remaining before deserializing.
     // Returns false and logs an error if the buffer is exhausted.
     auto safeToRead = [&data, &pos](size_t minBytesNeeded = 1) -> bool {
@@ -413,6 +608,7 @@ static void decode(const std::vector<std::byte> &data) {
         deserializeObject(data, pos, SyncHelper::instance().variables.timeDirty);
         deserializeObject(data, pos, SyncHelper::instance().variables.timeThreshold);
         deserializeObject(data, pos, SyncHelper::instance().variables.paused);
+        deserializeObject(data, pos, SyncHelper::instance().variables.timelineClockMs);
 
         // MpvObject variables - conditionally synced
         bool mpvSync = false;
@@ -505,6 +701,12 @@ static void decode(const std::vector<std::byte> &data) {
                 deserializeObject(data, pos, SyncHelper::instance().variables.screenshotPath);
                 deserializeObject(data, pos, SyncHelper::instance().variables.captureBackBuffer);
             }
+
+            // Profiler
+            if (!safeToRead()) return;
+            deserializeObject(data, pos, SyncHelper::instance().variables.profilerOn);
+            deserializeObject(data, pos, SyncHelper::instance().variables.profilerOverlay);
+            deserializeObject(data, pos, SyncHelper::instance().variables.profilerDumpTrace);
         }
 
         // Strings
@@ -565,25 +767,7 @@ static void decode(const std::vector<std::byte> &data) {
         decodedLayerPackets.reserve(static_cast<size_t>(numLayers));
 
         if (layerSync) {
-            for (int i = 0; i < numLayers; i++) {
-                if (!safeToRead(sizeof(uint32_t) + sizeof(bool) + sizeof(int) + sizeof(int))) return;
-
-                PendingLayerPacket packet;
-                deserializeObject(data, pos, packet.id);
-                deserializeObject(data, pos, packet.fullSync);
-                deserializeObject(data, pos, packet.layerType);
-
-                int payloadSize = 0;
-                deserializeObject(data, pos, payloadSize);
-                if (payloadSize < 0 || pos + static_cast<unsigned int>(payloadSize) > data.size()) {
-                    Log::Warning("Decode: invalid layer payload size for layer " + std::to_string(packet.id));
-                    return;
-                }
-
-                packet.payload.insert(packet.payload.end(), data.begin() + pos, data.begin() + pos + payloadSize);
-                pos += static_cast<unsigned int>(payloadSize);
-                decodedLayerPackets.push_back(std::move(packet));
-            }
+            if (!readFullLayerPackets(data, pos, numLayers, decodedLayerPackets)) return;
         }
         else {
             for (int i = 0; i < numLayers; i++) {
@@ -605,6 +789,58 @@ static void decode(const std::vector<std::byte> &data) {
             }
         }
 
+        // Chunk of a large full layer sync, applied when the last chunk is in
+        if (!safeToRead()) return;
+        bool hasLayerChunk = false;
+        deserializeObject(data, pos, hasLayerChunk);
+        if (hasLayerChunk) {
+            if (!safeToRead(3 * sizeof(uint32_t) + sizeof(int))) return;
+            uint32_t chunkOffset = 0;
+            uint32_t chunksTotal = 0;
+            int chunkLayers = 0;
+            uint32_t chunkSize = 0;
+            deserializeObject(data, pos, chunkOffset);
+            deserializeObject(data, pos, chunksTotal);
+            deserializeObject(data, pos, chunkLayers);
+            deserializeObject(data, pos, chunkSize);
+            if (!safeToRead(chunkSize)) return;
+
+            if (chunkOffset == 0)
+                receivedLayerSyncChunks.clear();
+            if (receivedLayerSyncChunks.size() != chunkOffset) {
+                // Joined in the middle of a transfer, wait for the next full sync
+                if (chunkOffset + chunkSize >= chunksTotal)
+                    Log::Warning("Decode: skipped full layer sync with missing chunks");
+            }
+            else {
+                receivedLayerSyncChunks.insert(receivedLayerSyncChunks.end(), data.begin() + pos, data.begin() + pos + chunkSize);
+                if (receivedLayerSyncChunks.size() >= chunksTotal) {
+                    std::vector<PendingLayerPacket> fullPackets;
+                    fullPackets.reserve(static_cast<size_t>(std::max(chunkLayers, 0)));
+                    unsigned int chunkPos = 0;
+                    bool complete = chunkLayers >= 0 && chunkLayers <= 10000
+                                    && readFullLayerPackets(receivedLayerSyncChunks, chunkPos, chunkLayers, fullPackets);
+                    receivedLayerSyncChunks.clear();
+                    receivedLayerSyncChunks.shrink_to_fit();
+
+                    if (complete) {
+                        // The chunks are a few frames old, unchanged layers take this frame's "always" data
+                        std::unordered_map<uint32_t, size_t> alwaysPackets;
+                        for (size_t i = 0; i < decodedLayerPackets.size(); i++)
+                            alwaysPackets[decodedLayerPackets[i].id] = i;
+                        for (PendingLayerPacket &packet : fullPackets) {
+                            auto always = alwaysPackets.find(packet.id);
+                            if (!packet.fullSync && always != alwaysPackets.end())
+                                packet.payload = std::move(decodedLayerPackets[always->second].payload);
+                        }
+                        decodedLayerPackets = std::move(fullPackets);
+                        layerSync = true;
+                    }
+                }
+            }
+            pos += chunkSize;
+        }
+
         {
             std::lock_guard<std::mutex> lock(pendingLayerPacketsMutex);
             pendingLayerPackets = std::move(decodedLayerPackets);
@@ -616,6 +852,7 @@ static void decode(const std::vector<std::byte> &data) {
 }
 
 static void postSyncPreDraw() {
+    FrameProfiler::Scope profileScope("postSyncPreDraw", Engine::instance().isMaster() ? nullptr : addApplyTime);
     if (SyncHelper::instance().variables.terminateNodes) {
         if (!Engine::instance().isMaster()) {
             Engine::instance().terminate();
@@ -623,6 +860,12 @@ static void postSyncPreDraw() {
         return;
     }
 
+    // Outside encode(), which holds the frame mutex
+    if (profilerTracePending) {
+        writeProfilerTrace("master");
+        profilerTracePending = false;
+    }
+
     if (shuttingDown)
         return;
 
@@ -734,6 +977,13 @@ static void postSyncPreDraw() {
             SyncHelper::instance().variables.takeScreenshot = false;
         }
 
+        // Profiler state from master, collected data is cleared when turned on
+        FrameProfiler::instance().setEnabled(SyncHelper::instance().variables.profilerOn);
+        if (SyncHelper::instance().variables.profilerDumpTrace) {
+            writeProfilerTrace(std::format("node{}", ClusterManager::instance().thisNodeId()));
+            SyncHelper::instance().variables.profilerDumpTrace = false;
+        }
+
         // Delete layers left in old container, and update to new
         // Needs to be done in this function, not in the deserialization.
         if (updateLayers) {
@@ -752,6 +1002,13 @@ static void postSyncPreDraw() {
             updateLayers = false;
         }
 
+        // Slide timelines play locally against the synced clock
+        for (auto& layer : secondaryLayers) {
+            if (layer && layer->hasTimeline()) {
+                layer->updateTimeline(SyncHelper::instance().variables.timelineClockMs);
+            }
+        }
+
         glm::vec3 rotXYZ = glm::vec3(float(SyncHelper::instance().variables.rotateX),
                                      float(SyncHelper::instance().variables.rotateY),
                                      float(SyncHelper::instance().variables.rotateZ));
@@ -1034,6 +1291,44 @@ static void draw(const RenderData &data) {
     glDisable(GL_BLEND);
 }
 
+static void draw2D(const RenderData &data) {
+#ifdef SGCT_HAS_TEXT
+    if (shuttingDown || Engine::instance().isMaster() || !SyncHelper::instance().variables.profilerOverlay || !FrameProfiler::enabled())
+        return;
+
+    text::Font *font = text::FontManager::instance().font("SGCTFont", 12);
+    if (!font)
+        return;
+
+    const float lineHeight = font->height() * 1.5f;
+    float y = static_cast<float>(data.window.resolution().y) - lineHeight * 2.f;
+    std::string overlay = FrameProfiler::instance().overlayText();
+    size_t start = 0;
+    while (start < overlay.size()) {
+        size_t end = overlay.find('\n', start);
+        if (end == std::string::npos)
+            end = overlay.size();
+        text::print(data.window, data.viewport, *font, text::Alignment::TopLeft, 20.f, y, vec4{1.f, 1.f, 0.4f, 1.f}, overlay.substr(start, end - start));
+        y -= lineHeight;
+        start = end + 1;
+    }
+#else
+    (void)data;
+#endif
+}
+
+static void dataTransferDecode(void *data, int length, int packageId, int clientIndex) {
+    if (packageId == ClusterStats::NodeReportPackageId && Engine::instance().isMaster()) {
+        ClusterStats::instance().recordNodeReport(clientIndex, data, length, Engine::instance().currentFrameNumber());
+    }
+}
+
+static void dataTransferStatus(bool connected, int clientIndex) {
+    if (Engine::instance().isMaster()) {
+        ClusterStats::instance().setNodeConnected(clientIndex, connected);
+    }
+}
+
 static void cleanup() {
     shuttingDown = true;
 
@@ -1049,6 +1344,8 @@ static void cleanup() {
         secondaryLayers.clear();
         primaryLayers.clear();
 
+        FrameProfiler::instance().cleanupGL();
+
         backgroundImageLayer.reset();
         foregroundImageLayer.reset();
         overlayImageLayer.reset();
@@ -1059,6 +1356,11 @@ static void cleanup() {
         ImageLayer::processPendingGLCleanup();
     }
 
+    if (profilerTraceThread) {
+        profilerTraceThread->join();
+        profilerTraceThread.reset();
+    }
+
 #ifdef NDI_SUPPORT
     NdiFinder::destroy();
     NDIlib_destroy();
@@ -1092,6 +1394,16 @@ int main(int argc, char *argv[]) {
             SyncHelper::instance().configuration.confMasterOnly = "./data/mpv-conf/" + mpvConfFolder + "/master-only.json";
             SyncHelper::instance().configuration.confNodesOnly = "./data/mpv-conf/" + mpvConfFolder + "/nodes-only.json";
             arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        } else if (arg[i] == "--maxdecoders") {
+            if (i + 1 >= arg.size()) { i++; continue; }
+            // Max number of concurrent mpv instances (0 = unlimited)
+            SyncHelper::instance().configuration.maxDecoders = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        } else if (arg[i] == "--idledecoders") {
+            if (i + 1 >= arg.size()) { i++; continue; }
+            // Max number of unloaded mpv instances kept for reuse
+            SyncHelper::instance().configuration.maxIdleDecoders = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
         } else if (arg[i] == "--allowDirectRendering") {
             allowDirectRendering = true;
             arg.erase(arg.begin() + i);
@@ -1138,6 +1450,10 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    MpvInstancePool::instance()->setLimits(
+        SyncHelper::instance().configuration.maxDecoders,
+        SyncHelper::instance().configuration.maxIdleDecoders);
+
     Engine::Callbacks callbacks;
     callbacks.initOpenGL = initOGL;
     callbacks.preSync = preSync;
@@ -1145,7 +1461,10 @@ int main(int argc, char *argv[]) {
     callbacks.decode = decode;
     callbacks.postSyncPreDraw = postSyncPreDraw;
     callbacks.draw = draw;
+    callbacks.draw2D = draw2D;
     callbacks.cleanup = cleanup;
+    callbacks.dataTransferDecode = dataTransferDecode;
+    callbacks.dataTransferStatus = dataTransferStatus;
     try {
         Engine::create(cluster, callbacks, config);
     } catch (const std::runtime_error &e) {
@@ -23,6 +23,7 @@
 #include "track.h"
 #include "tracksmodel.h"
 #include "layers/textlayer.h"
+#include "utils/pathresolver.h"
 #include <iostream>
 
 #include <QCryptographicHash>
@@ -121,6 +122,7 @@ MpvObject::MpvObject(QQuickItem *parent)
     setProperty(QStringLiteral("sub-auto"), loadSubtitleInVidFolder);
     setProperty(QStringLiteral("slang"), SubtitleSettings::preferredLanguage());
     SyncHelper::instance().variables.subtitleText = new TextLayer();
+    static_cast<TextLayer*>(SyncHelper::instance().variables.subtitleText)->setHalfFloatTexture(SubtitleSettings::subtitleTextureHalfFloat());
     
     setProperty(QStringLiteral("volume-max"), QStringLiteral("100"));
     setProperty(QStringLiteral("keep-open"), QStringLiteral("yes"));
@@ -853,25 +855,7 @@ void MpvObject::setLoadAudioInVidFolder(bool enabled) {
 }
 
 QString MpvObject::checkAndCorrectPath(const QString &filePath, const QStringList &searchPaths) {
-    QFileInfo fileInfo(filePath);
-    if (fileInfo.exists())
-        return filePath;
-    else if (fileInfo.isRelative()) { // Go through search list in order
-        for (int i = 0; i < searchPaths.size(); i++) {
-            QString newFilePath = QDir::cleanPath(searchPaths[i] + QDir::separator() + filePath);
-            QFileInfo newFilePathInfo(newFilePath);
-            if (newFilePathInfo.exists())
-                return newFilePath;
-        }
-
-        // Maybe from network share?
-        QString sharefilePath = filePath;
-        sharefilePath.replace(QStringLiteral("file://"), QStringLiteral("\\\\"));
-        fileInfo = QFileInfo(sharefilePath);
-        if (fileInfo.exists())
-            return sharefilePath;
-    }
-    return QStringLiteral("");
+    return PathResolver::instance().resolve(filePath, searchPaths);
 }
 
 void MpvObject::loadFile(const QString &file, bool updateLastPlayedFile) {
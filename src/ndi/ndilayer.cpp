@@ -8,6 +8,7 @@
 #include "ndilayer.h"
 #include "audiosettings.h"
 #include <sgct/sgct.h>
+#include <utils/frameprofiler.h>
 #include <chrono>
 #include <cstdint>
 #include <cstddef>
@@ -368,6 +369,7 @@ void NdiLayer::initialize() {
 }
 
 void NdiLayer::update(bool updateRendering) {
+    FrameProfiler::Scope profileScope("update", this);
     std::lock_guard<std::mutex> lock(m_updateMutex);
 
     if (m_typePropertiesDecoded) {
@@ -416,6 +418,7 @@ void NdiLayer::update(bool updateRendering) {
 }
 
 void NdiLayer::updateFrame() {
+    FrameProfiler::Scope profileScope("updateFrame", this, true);
     // Let's recieve image or audio
     if (m_isReady) {
         ReceiveData(true);
@@ -8,6 +8,7 @@
 #include "omtlayer.h"
 #include "audiosettings.h"
 #include <sgct/sgct.h>
+#include <utils/frameprofiler.h>
 #include <utils/dividetexturehandler.h>
 #include <cstring>
 #include <cmath>
@@ -109,6 +110,7 @@ void OmtLayer::initialize() {
 }
 
 void OmtLayer::update(bool updateRendering) {
+    FrameProfiler::Scope profileScope("update", this);
     if (m_typePropertiesDecoded) {
         m_typePropertiesDecoded = false;
         setVolume(m_volume_Dec);
@@ -169,6 +171,7 @@ void OmtLayer::update(bool updateRendering) {
 }
 
 void OmtLayer::updateFrame() {
+    FrameProfiler::Scope profileScope("updateFrame", this, true);
     if (!m_receiver) {
         return;
     }
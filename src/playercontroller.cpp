@@ -1,6 +1,7 @@
 #include "playercontroller.h"
 #include "_debug.h"
 #include "application.h"
+#include "clusterstats.h"
 #include "httpserverthread.h"
 #include "imagesettings.h"
 #include "locationsettings.h"
@@ -15,6 +16,8 @@
 #include "tracksmodel.h"
 #include "layers/imagelayer.h"
 #include "utils/imagesequenceutils.h"
+#include "utils/frameprofiler.h"
+#include "utils/pathresolver.h"
 
 #include <QDir>
 #include <QFileInfo>
@@ -455,31 +458,13 @@ QString PlayerController::returnRelativeOrAbsolutePath(const QString &path) {
 QString PlayerController::checkAndCorrectPath(const QString &path) {
     QString filePath = path;
     filePath.replace(QStringLiteral("file:///"), QStringLiteral(""));
-    QFileInfo fileInfo(filePath);
 
-    if (fileInfo.exists())
-        return filePath;
-    else if (fileInfo.isRelative()) { // Go through search list in order
-        QStringList searchPaths;
-        searchPaths.append(LocationSettings::cPlayMediaLocation());
-        searchPaths.append(LocationSettings::cPlayFileLocation());
-        searchPaths.append(LocationSettings::univiewVideoLocation());
-
-        for (int i = 0; i < searchPaths.size(); i++) {
-            QString newFilePath = QDir::cleanPath(searchPaths[i] + QDir::separator() + filePath);
-            QFileInfo newFilePathInfo(newFilePath);
-            if (newFilePathInfo.exists())
-                return newFilePath;
-        }
+    QStringList searchPaths;
+    searchPaths.append(LocationSettings::cPlayMediaLocation());
+    searchPaths.append(LocationSettings::cPlayFileLocation());
+    searchPaths.append(LocationSettings::univiewVideoLocation());
 
-        // Maybe from network share?
-        filePath = path;
-        filePath.replace(QStringLiteral("file://"), QStringLiteral("\\\\"));
-        fileInfo = QFileInfo(filePath);
-        if (fileInfo.exists())
-            return filePath;
-    }
-    return QStringLiteral("");
+    return PathResolver::instance().resolve(filePath, searchPaths);
 }
 
 QString PlayerController::returnFileBaseName(const QString &path) {
@@ -748,6 +733,38 @@ void PlayerController::setCaptureBackBuffer(bool backBuffer) {
     SyncHelper::instance().variables.captureBackBuffer = backBuffer;
 }
 
+bool PlayerController::profilerEnabled() {
+    return SyncHelper::instance().variables.profilerOn;
+}
+
+void PlayerController::setProfilerEnabled(bool value) {
+    if (SyncHelper::instance().variables.profilerOn == value)
+        return;
+    // Master profiles its own sync callbacks and previews
+    FrameProfiler::instance().setEnabled(value);
+    SyncHelper::instance().variables.profilerOn = value;
+    SyncHelper::instance().variables.playerControllerNeedSync = true;
+    Q_EMIT profilerEnabledChanged();
+}
+
+bool PlayerController::profilerOverlay() {
+    return SyncHelper::instance().variables.profilerOverlay;
+}
+
+void PlayerController::setProfilerOverlay(bool value) {
+    if (SyncHelper::instance().variables.profilerOverlay == value)
+        return;
+    SyncHelper::instance().variables.profilerOverlay = value;
+    SyncHelper::instance().variables.playerControllerNeedSync = true;
+    Q_EMIT profilerOverlayChanged();
+}
+
+void PlayerController::dumpProfilerTrace() {
+    // Written by master and every node to data/log on their next sync
+    SyncHelper::instance().variables.profilerDumpTrace = true;
+    SyncHelper::instance().variables.playerControllerNeedSync = true;
+}
+
 QString PlayerController::supportedImageNameFilters() const {
     QStringList exts = {
         QStringLiteral("*.bmp"),
@@ -808,6 +825,10 @@ QString PlayerController::imageRingBufferGpuMemoryText(int percent) const {
     return formatMemoryBudgetText(budgetBytes);
 }
 
+QVariantMap PlayerController::clusterStats() const {
+    return ClusterStats::instance().toJson().toVariantMap();
+}
+
 MpvObject *PlayerController::mpv() const {
     return m_mpv;
 }
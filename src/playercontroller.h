@@ -44,9 +44,20 @@ public:
         WRITE setSyncProperties
         NOTIFY syncPropertiesChanged)
 
+    Q_PROPERTY(bool profilerEnabled
+        READ profilerEnabled
+        WRITE setProfilerEnabled
+        NOTIFY profilerEnabledChanged)
+
+    Q_PROPERTY(bool profilerOverlay
+        READ profilerOverlay
+        WRITE setProfilerOverlay
+        NOTIFY profilerOverlayChanged)
+
     Q_INVOKABLE QString supportedImageNameFilters() const;
     Q_INVOKABLE QStringList supportedImageDecoderNames() const;
     Q_INVOKABLE QString imageRingBufferGpuMemoryText(int percent) const;
+    Q_INVOKABLE QVariantMap clusterStats() const;
 
 public Q_SLOTS:
     void QuitCPlay();
@@ -131,6 +142,12 @@ public Q_SLOTS:
     void takeNodeScreenshot(const QString& screenshotPath);
     void setCaptureBackBuffer(bool backBuffer);
 
+    bool profilerEnabled();
+    void setProfilerEnabled(bool value);
+    bool profilerOverlay();
+    void setProfilerOverlay(bool value);
+    void dumpProfilerTrace();
+
 Q_SIGNALS:
     void quitCPlay();
     void next();
@@ -161,6 +178,8 @@ Q_SIGNALS:
     void nodeWindowOnTopChanged();
     void nodeWindowOpacityChanged();
     void syncPropertiesChanged();
+    void profilerEnabledChanged();
+    void profilerOverlayChanged();
 
 private:
     MpvObject *mpv() const;
@@ -10,6 +10,7 @@
 #include "_debug.h"
 #include "locationsettings.h"
 #include "layers/baselayer.h"
+#include "utils/pathresolver.h"
 #include <algorithm>
 
 #include <QDir>
@@ -974,23 +975,5 @@ void PlayListItem::loadUniviewFDV() {
 }
 
 QString PlayListItem::checkAndCorrectPath(const QString &filePath, const QStringList &searchPaths) {
-    QFileInfo fileInfo(filePath);
-    if (fileInfo.exists())
-        return filePath;
-    else if (fileInfo.isRelative()) { // Go through search list in order
-        for (int i = 0; i < searchPaths.size(); i++) {
-            QString newFilePath = QDir::cleanPath(searchPaths[i] + QDir::separator() + filePath);
-            QFileInfo newFilePathInfo(newFilePath);
-            if (newFilePathInfo.exists())
-                return newFilePath;
-        }
-
-        // Maybe from network share?
-        QString sharefilePath = filePath;
-        sharefilePath.replace(QStringLiteral("file://"), QStringLiteral("\\\\"));
-        fileInfo = QFileInfo(sharefilePath);
-        if (fileInfo.exists())
-            return sharefilePath;
-    }
-    return QStringLiteral("");
+    return PathResolver::instance().resolve(filePath, searchPaths);
 }
@@ -15,11 +15,13 @@
 
 #include <QCollator>
 #include <QDirIterator>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QMimeDatabase>
+#include <QThreadPool>
 #include <QUrl>
 #include <KSharedConfig>
 
@@ -305,39 +307,55 @@ int PlaySectionsModel::sectionEOSMode(int i) const {
     return m_currentEditItem->sectionEOSMode(i);
 }
 
-std::string PlaySectionsModel::getSectionsAsFormattedString(size_t charsPerItem) const {
+std::vector<std::pair<std::string, std::string>> PlaySectionsModel::getSectionItems() const {
+    std::vector<std::pair<std::string, std::string>> items;
     if (!m_currentEditItem)
-        return "";
+        return items;
 
-    std::string fullItemList = "";
     for (int i = 0; i < m_currentEditItem->numberOfSections(); i++) {
-        std::string title = std::to_string(i + 1) + ". ";
-
         auto playListItemSection = m_currentEditItem->getSection(i);
-
-        title += playListItemSection.title.toStdString();
-
         std::string duration = Application::formatTime(playListItemSection.endTime - playListItemSection.startTime).toStdString();
+        items.emplace_back(playListItemSection.title.toStdString(), duration);
+    }
+    return items;
+}
+
+// Videos found by a folder scan are handed to the model in batches of this
+// size, or after this interval when the folder is slow to read
+static constexpr int FolderScanBatchSize = 64;
+static constexpr qint64 FolderScanBatchIntervalMs = 100;
+
+// Classifies by file name first, which needs no disk access. Files with an
+// unknown or ambiguous extension (e.g. .ts) are sniffed by content.
+static bool isVideoFile(const QFileInfo &fileInfo, QHash<QString, bool> &suffixCache) {
+    const QString suffix = fileInfo.suffix().toLower();
+    if (!suffix.isEmpty()) {
+        auto it = suffixCache.constFind(suffix);
+        if (it != suffixCache.cend()) {
+            return it.value();
+        }
+    }
 
-        size_t countChars = title.size() + duration.size();
-        if (countChars < charsPerItem) {
-            title.insert(title.end(), charsPerItem - countChars, ' ');
-        } else if (countChars >= charsPerItem) {
-            title.erase(title.end() - (countChars - charsPerItem + 4), title.end());
-            title.insert(title.end(), 3, '.');
-            title.insert(title.end(), 1, ' ');
+    const QMimeDatabase &db = Application::mimeDatabase();
+    QList<QMimeType> types = db.mimeTypesForFileName(fileInfo.fileName());
+    if (types.size() == 1) {
+        bool isVideo = types.first().name().startsWith(QStringLiteral("video/"));
+        if (!suffix.isEmpty()) {
+            suffixCache.insert(suffix, isVideo);
         }
-        std::string itemText = title + duration;
-        fullItemList += itemText;
-        if (i < m_currentEditItem->numberOfSections() - 1)
-            fullItemList += "\n";
+        return isVideo;
     }
-    return fullItemList;
+    return db.mimeTypeForFile(fileInfo).name().startsWith(QStringLiteral("video/"));
 }
 
 PlayListModel::PlayListModel(QObject *parent)
     : QAbstractListModel(parent) {
     m_config = KSharedConfig::openConfig(QStringLiteral("C-Play/cplay.conf"));
+
+    // One scan at a time, a new scan cancels the previous one
+    m_scanPool = new QThreadPool(this);
+    m_scanPool->setMaxThreadCount(1);
+
     connect(this, &PlayListModel::videoAdded,
             Worker::instance(), &Worker::getMetaData);
 
@@ -359,6 +377,13 @@ PlayListModel::PlayListModel(QObject *parent)
     m_playListPath = QStringLiteral("");
 }
 
+PlayListModel::~PlayListModel() {
+    if (m_scanCancelled) {
+        m_scanCancelled->store(true);
+    }
+    m_scanPool->waitForDone();
+}
+
 int PlayListModel::rowCount(const QModelIndex &parent) const {
     if (parent.isValid())
         return 0;
@@ -471,39 +496,118 @@ void PlayListModel::getVideos(QString path) {
     clear();
     path = QUrl(path).toLocalFile().isEmpty() ? path : QUrl(path).toLocalFile();
     QFileInfo pathInfo(path);
-    QStringList videoFiles;
-    if (pathInfo.exists() && pathInfo.isFile()) {
-        QDirIterator it(pathInfo.absolutePath(), QDir::Files, QDirIterator::NoIteratorFlags);
-        while (it.hasNext()) {
-            QString file = it.next();
-            QFileInfo fileInfo(file);
-            QMimeDatabase db;
-            QMimeType type = db.mimeTypeForFile(file);
-            if (fileInfo.exists() && type.name().startsWith(QStringLiteral("video/"))) {
-                videoFiles.append(fileInfo.absoluteFilePath());
+    if (!pathInfo.exists() || !pathInfo.isFile()) {
+        return;
+    }
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_scanCancelled = cancelled;
+    m_scanPlayingFile = pathInfo.absoluteFilePath();
+    Q_EMIT scanningFolderChanged();
+
+    const QString folder = pathInfo.absolutePath();
+    m_scanPool->start([this, folder, cancelled]() {
+        QHash<QString, bool> suffixCache;
+        QStringList batch;
+        QElapsedTimer batchTimer;
+        batchTimer.start();
+
+        auto post = [&](bool finished) {
+            QMetaObject::invokeMethod(this, [this, cancelled, videoFiles = batch, finished]() {
+                // Results of a cancelled (or replaced) scan are dropped
+                if (cancelled->load()) {
+                    return;
+                }
+                insertScannedVideos(videoFiles);
+                if (finished) {
+                    finishFolderScan();
+                }
+            }, Qt::QueuedConnection);
+            batch.clear();
+            batchTimer.restart();
+        };
+
+        QDirIterator it(folder, QDir::Files, QDirIterator::NoIteratorFlags);
+        while (it.hasNext() && !cancelled->load()) {
+            QFileInfo fileInfo = it.nextFileInfo();
+            if (isVideoFile(fileInfo, suffixCache)) {
+                batch.append(fileInfo.absoluteFilePath());
+            }
+            if (batch.size() >= FolderScanBatchSize
+                || (!batch.isEmpty() && batchTimer.elapsed() >= FolderScanBatchIntervalMs)) {
+                post(false);
             }
         }
+        if (!cancelled->load()) {
+            post(true);
+        }
+    });
+}
+
+void PlayListModel::cancelFolderScan() {
+    if (!m_scanCancelled) {
+        return;
     }
-    QCollator collator;
-    collator.setNumericMode(true);
-    std::sort(videoFiles.begin(), videoFiles.end(), collator);
+    // Keep what was listed so far
+    m_scanCancelled->store(true);
+    finishFolderScan();
+}
 
-    if (videoFiles.isEmpty()) {
+void PlayListModel::stopFolderScan() {
+    if (!m_scanCancelled) {
         return;
     }
+    m_scanCancelled->store(true);
+    m_scanCancelled.reset();
+    Q_EMIT scanningFolderChanged();
+}
 
-    beginInsertRows(QModelIndex(), 0, videoFiles.count() - 1);
+bool PlayListModel::isScanningFolder() const {
+    return m_scanCancelled != nullptr;
+}
 
-    for (int i = 0; i < videoFiles.count(); ++i) {
-        auto video = new PlayListItem(videoFiles.at(i), i, this);
-        m_playList.append(QPointer<PlayListItem>(video));
-        if (path == videoFiles.at(i)) {
-            setPlayingVideo(i);
+void PlayListModel::insertScannedVideos(const QStringList &videoFiles) {
+    QCollator collator;
+    collator.setNumericMode(true);
+
+    for (const QString &videoFile : videoFiles) {
+        auto pos = std::upper_bound(m_playList.cbegin(), m_playList.cend(), videoFile,
+                                    [&collator](const QString &file, const QPointer<PlayListItem> &item) {
+                                        return collator.compare(file, item ? item->filePath() : QString()) < 0;
+                                    });
+        int row = static_cast<int>(std::distance(m_playList.cbegin(), pos));
+
+        beginInsertRows(QModelIndex(), row, row);
+        auto video = new PlayListItem(videoFile, row, this);
+        m_playList.insert(row, QPointer<PlayListItem>(video));
+        bool playingMoved = m_playingVideo >= row;
+        if (playingMoved) {
+            m_playingVideo += 1;
+        }
+        endInsertRows();
+
+        if (playingMoved) {
+            Q_EMIT playingVideoChanged();
+        }
+        if (videoFile == m_scanPlayingFile) {
+            setPlayingVideo(row);
         }
-        Q_EMIT videoAdded(i, video->filePath());
     }
+}
 
-    endInsertRows();
+void PlayListModel::finishFolderScan() {
+    m_scanCancelled.reset();
+    m_scanPlayingFile.clear();
+
+    // Rows are final now, so the metadata can be matched by index
+    for (int i = 0; i < m_playList.size(); ++i) {
+        if (!m_playList[i]) {
+            continue;
+        }
+        m_playList[i]->setIndex(i);
+        Q_EMIT videoAdded(i, m_playList[i]->filePath());
+    }
+    Q_EMIT scanningFolderChanged();
 }
 
 Playlist PlayListModel::items() const {
@@ -523,41 +627,29 @@ Playlist PlayListModel::getPlayList() const {
 }
 
 void PlayListModel::setPlayList(const Playlist &playList) {
+    stopFolderScan();
     beginResetModel();
     m_playList = playList;
     endResetModel();
     setPlayListIsEdited(false);
 }
 
-std::string PlayListModel::getListAsFormattedString(int charsPerItem) const {
-    std::string fullItemList = "";
+std::vector<std::pair<std::string, std::string>> PlayListModel::getListItems() const {
+    std::vector<std::pair<std::string, std::string>> items;
     for (int i = 0; i < m_playList.size(); i++) {
         if (!m_playList[i])
             continue;
-        std::string title = std::to_string(i + 1) + ". ";
+        std::string title;
         if (!m_playList[i]->listTitle().isEmpty()) {
-            title += m_playList[i]->listTitle().toStdString();
+            title = m_playList[i]->listTitle().toStdString();
         } else if (!m_playList[i]->mediaTitle().isEmpty()) {
-            title += m_playList[i]->mediaTitle().toStdString();
+            title = m_playList[i]->mediaTitle().toStdString();
         } else {
-            title += m_playList[i]->fileName().toStdString();
-        }
-        std::string duration = Application::formatTime(m_playList[i]->duration()).toStdString();
-
-        size_t countChars = title.size() + duration.size();
-        if (countChars < charsPerItem) {
-            title.insert(title.end(), charsPerItem - countChars, ' ');
-        } else if (countChars >= charsPerItem) {
-            title.erase(title.end() - (countChars - charsPerItem + 4), title.end());
-            title.insert(title.end(), 3, '.');
-            title.insert(title.end(), 1, ' ');
+            title = m_playList[i]->fileName().toStdString();
         }
-        std::string itemText = title + duration;
-        fullItemList += itemText;
-        if (i < m_playList.size() - 1)
-            fullItemList += "\n";
+        items.emplace_back(title, Application::formatTime(m_playList[i]->duration()).toStdString());
     }
-    return fullItemList;
+    return items;
 }
 
 void PlayListModel::setPlayListName(QString name) {
@@ -585,6 +677,7 @@ int PlayListModel::getPlayingVideo() const {
 }
 
 void PlayListModel::clear() {
+    stopFolderScan();
     m_playingVideo = -1;
     qDeleteAll(m_playList);
     beginResetModel();
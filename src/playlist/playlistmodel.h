@@ -14,10 +14,15 @@
 #include <QPointer>
 #include <QtQml/qqmlregistration.h>
 #include <KSharedConfig>
+#include <atomic>
 #include <map>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 class PlayListItem;
+class QThreadPool;
 using Playlist = QList<QPointer<PlayListItem>>;
 
 class PlaySectionsModel : public QAbstractListModel {
@@ -76,7 +81,8 @@ public:
     Q_INVOKABLE double sectionEndTime(int i) const;
     Q_INVOKABLE int sectionEOSMode(int i) const;
 
-    std::string getSectionsAsFormattedString(size_t charsPerItem = 40) const;
+    // Title and formatted duration of each section
+    std::vector<std::pair<std::string, std::string>> getSectionItems() const;
 
 Q_SIGNALS:
     void currentEditItemChanged();
@@ -105,8 +111,13 @@ class PlayListModel : public QAbstractListModel {
                            WRITE setPlayListIsEdited
                                NOTIFY playListIsEditedChanged)
 
+    Q_PROPERTY(bool scanningFolder
+                   READ isScanningFolder
+                       NOTIFY scanningFolderChanged)
+
 public:
     explicit PlayListModel(QObject *parent = nullptr);
+    ~PlayListModel();
 
     enum {
         NameRole = Qt::UserRole,
@@ -128,7 +139,8 @@ public:
     Playlist getPlayList() const;
     void setPlayList(const Playlist &playList);
 
-    std::string getListAsFormattedString(int charsPerItem = 40) const;
+    // Title and formatted duration of each item
+    std::vector<std::pair<std::string, std::string>> getListItems() const;
 
     Q_INVOKABLE void setPlayListName(QString name);
     Q_INVOKABLE QString getPlayListName() const;
@@ -151,7 +163,11 @@ public:
     Q_INVOKABLE bool getPlayListIsEdited();
     Q_INVOKABLE void setPlayingVideo(int playingVideo);
     Q_INVOKABLE int getPlayingVideo() const;
+    // Lists the videos in the folder of path on a background thread. Rows are
+    // inserted in sorted order as the folder is read.
     Q_INVOKABLE void getVideos(QString path);
+    Q_INVOKABLE void cancelFolderScan();
+    Q_INVOKABLE bool isScanningFolder() const;
     Q_INVOKABLE void clear();
     Q_INVOKABLE QString filePath(int i) const;
     Q_INVOKABLE QUrl filePathAsURL(int i) const;
@@ -208,10 +224,18 @@ Q_SIGNALS:
     void videoAdded(int index, QString path);
     void playingVideoChanged();
     void playListIsEditedChanged();
+    void scanningFolderChanged();
 
 private:
     Playlist items() const;
     QString configFolder();
+    void insertScannedVideos(const QStringList &videoFiles);
+    void finishFolderScan();
+    void stopFolderScan();
+
+    QThreadPool *m_scanPool = nullptr;
+    std::shared_ptr<std::atomic<bool>> m_scanCancelled;
+    QString m_scanPlayingFile;
     Playlist m_playList;
     QString m_playListName;
     QString m_playListPath;
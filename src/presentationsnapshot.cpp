@@ -0,0 +1,225 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "presentationsnapshot.h"
+#include "layersmodel.h"
+#include <QCborArray>
+#include <QCborValue>
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+#include <limits>
+
+static const char SnapshotMagic[8] = {'C', 'P', 'L', 'A', 'Y', 'S', 'N', 'P'};
+static const quint32 SnapshotVersion = 1;
+
+// magic, version, numSlides, jsonSize, jsonModified
+static const qint64 HeaderSize = 8 + 4 + 4 + 8 + 8;
+// offset, length, pathsLength, visibility, reserved
+static const qint64 EntrySize = 8 + 4 + 4 + 4 + 4;
+
+template <typename T>
+static void appendLE(QByteArray &data, T value) {
+    char buf[sizeof(T)];
+    qToLittleEndian<T>(value, buf);
+    data.append(buf, sizeof(T));
+}
+
+template <typename T>
+static T readLE(const uchar *src) {
+    return qFromLittleEndian<T>(src);
+}
+
+PresentationSnapshot::PresentationSnapshot() {
+}
+
+PresentationSnapshot::~PresentationSnapshot() {
+    close();
+}
+
+QString PresentationSnapshot::snapshotPath(const QString &jsonFilePath) {
+    return jsonFilePath + QStringLiteral(".snapshot");
+}
+
+bool PresentationSnapshot::write(const QJsonObject &presentation, const QFileInfo &jsonFileInfo) {
+    const bool hasMaster = presentation.contains(QStringLiteral("master"));
+    QList<QJsonObject> objects;
+    objects.append(presentation.value(QStringLiteral("master")).toObject());
+    const QJsonArray slides = presentation.value(QStringLiteral("slides")).toArray();
+    for (auto v : slides) {
+        objects.append(v.toObject());
+    }
+
+    QByteArray index;
+    QByteArray data;
+    const qint64 dataStart = HeaderSize + EntrySize * objects.size();
+    for (int i = 0; i < objects.size(); i++) {
+        QByteArray objectData;
+        if (i > 0 || hasMaster)
+            objectData = QCborValue::fromJsonValue(objects[i]).toCbor();
+
+        QCborArray paths;
+        for (const QString &p : LayersModel::mediaPathsFromJSON(objects[i])) {
+            paths.append(p);
+        }
+        QByteArray pathsData = QCborValue(paths).toCbor();
+
+        appendLE<quint64>(index, static_cast<quint64>(dataStart + data.size()));
+        appendLE<quint32>(index, static_cast<quint32>(objectData.size()));
+        appendLE<quint32>(index, static_cast<quint32>(pathsData.size()));
+        appendLE<qint32>(index, objects[i].value(QStringLiteral("visibility")).toInt());
+        appendLE<quint32>(index, 0);
+
+        data.append(objectData);
+        data.append(pathsData);
+    }
+
+    QByteArray header;
+    header.append(SnapshotMagic, sizeof(SnapshotMagic));
+    appendLE<quint32>(header, SnapshotVersion);
+    appendLE<quint32>(header, static_cast<quint32>(slides.size()));
+    appendLE<qint64>(header, jsonFileInfo.size());
+    appendLE<qint64>(header, jsonFileInfo.lastModified().toMSecsSinceEpoch());
+
+    QSaveFile snapshotFile(snapshotPath(jsonFileInfo.absoluteFilePath()));
+    if (!snapshotFile.open(QIODevice::WriteOnly)) {
+        qDebug() << QStringLiteral("Failed to open C-play presentation snapshot for writing: ") << snapshotFile.fileName();
+        return false;
+    }
+    snapshotFile.write(header);
+    snapshotFile.write(index);
+    snapshotFile.write(data);
+    if (!snapshotFile.commit()) {
+        qDebug() << QStringLiteral("Failed to write C-play presentation snapshot: ") << snapshotFile.fileName();
+        return false;
+    }
+    return true;
+}
+
+bool PresentationSnapshot::open(const QFileInfo &jsonFileInfo) {
+    close();
+
+    m_file.setFileName(snapshotPath(jsonFileInfo.absoluteFilePath()));
+    if (!m_file.exists() || !m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    m_size = m_file.size();
+    if (m_size < HeaderSize) {
+        close();
+        return false;
+    }
+
+    m_data = m_file.map(0, m_size);
+    if (!m_data) {
+        close();
+        return false;
+    }
+
+    // Only valid if written for this exact version of the JSON file
+    if (std::memcmp(m_data, SnapshotMagic, sizeof(SnapshotMagic)) != 0
+        || readLE<quint32>(m_data + 8) != SnapshotVersion
+        || readLE<qint64>(m_data + 16) != jsonFileInfo.size()
+        || readLE<qint64>(m_data + 24) != jsonFileInfo.lastModified().toMSecsSinceEpoch()) {
+        close();
+        return false;
+    }
+
+    // The index (master plus slides) has to fit in the file
+    const quint32 numSlides = readLE<quint32>(m_data + 12);
+    const quint64 maxEntries = static_cast<quint64>(m_size - HeaderSize) / EntrySize;
+    if (static_cast<quint64>(numSlides) + 1 > maxEntries || numSlides >= static_cast<quint32>(std::numeric_limits<int>::max())) {
+        close();
+        return false;
+    }
+    m_numSlides = static_cast<int>(numSlides);
+
+    // Written so that no sum can wrap around
+    const quint64 size = static_cast<quint64>(m_size);
+    for (int i = -1; i < m_numSlides; i++) {
+        Entry e = entry(i);
+        if (e.offset > size || e.length > size - e.offset || e.pathsLength > size - e.offset - e.length) {
+            close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void PresentationSnapshot::close() {
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+        m_data = nullptr;
+    }
+    if (m_file.isOpen())
+        m_file.close();
+    m_size = 0;
+    m_numSlides = 0;
+}
+
+bool PresentationSnapshot::isOpen() const {
+    return m_data != nullptr;
+}
+
+bool PresentationSnapshot::hasMaster() const {
+    return isOpen() && entry(-1).length > 0;
+}
+
+QJsonObject PresentationSnapshot::master() const {
+    if (!isOpen())
+        return QJsonObject();
+    return decodeObject(entry(-1));
+}
+
+int PresentationSnapshot::numSlides() const {
+    return m_numSlides;
+}
+
+QJsonObject PresentationSnapshot::slide(int idx) const {
+    if (!isOpen() || idx < 0 || idx >= m_numSlides)
+        return QJsonObject();
+    return decodeObject(entry(idx));
+}
+
+QStringList PresentationSnapshot::slideMediaPaths(int idx) const {
+    QStringList paths;
+    if (!isOpen() || idx < 0 || idx >= m_numSlides)
+        return paths;
+
+    Entry e = entry(idx);
+    QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + e.offset + e.length), e.pathsLength);
+    const QCborArray array = QCborValue::fromCbor(raw).toArray();
+    for (const QCborValue &v : array) {
+        paths.append(v.toString());
+    }
+    return paths;
+}
+
+int PresentationSnapshot::slideVisibility(int idx) const {
+    if (!isOpen() || idx < 0 || idx >= m_numSlides)
+        return 0;
+    return entry(idx).visibility;
+}
+
+PresentationSnapshot::Entry PresentationSnapshot::entry(int idx) const {
+    // idx -1 is the master
+    const uchar *src = m_data + HeaderSize + EntrySize * (idx + 1);
+    Entry e;
+    e.offset = readLE<quint64>(src);
+    e.length = readLE<quint32>(src + 8);
+    e.pathsLength = readLE<quint32>(src + 12);
+    e.visibility = readLE<qint32>(src + 16);
+    return e;
+}
+
+QJsonObject PresentationSnapshot::decodeObject(const Entry &e) const {
+    QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + e.offset), e.length);
+    return QCborValue::fromCbor(raw).toJsonValue().toObject();
+}
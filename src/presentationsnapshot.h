@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef PRESENTATIONSNAPSHOT_H
+#define PRESENTATIONSNAPSHOT_H
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QStringList>
+
+// Binary snapshot of a C-Play presentation, written next to the JSON file.
+//
+// Layout (little endian):
+//   Header: magic "CPLAYSNP", version, number of slides, size and modification
+//           time of the JSON file it was written from.
+//   Index:  one entry for the master followed by one per slide, holding the offset
+//           and length of its data, the length of its media path list and its visibility.
+//   Data:   per entry the slide JSON object followed by the raw media paths of its
+//           file based layers, both encoded as CBOR.
+//
+// The file is memory-mapped and a slide is only decoded when asked for. The snapshot
+// is only used while size and modification time of the JSON file still match.
+//
+// What this saves is parsing the whole JSON document before anything is shown.
+// Every slide is still built into a LayersModel while loading, as the slide list,
+// the HTTP state (layer titles of all slides), name lookups and syncing all
+// slides to the nodes expect a complete model. Keeping unviewed slides as index
+// entries would need that data duplicated into the index.
+class PresentationSnapshot {
+public:
+    PresentationSnapshot();
+    ~PresentationSnapshot();
+
+    static QString snapshotPath(const QString &jsonFilePath);
+
+    // Write a snapshot of the presentation object read from/written to jsonFileInfo
+    static bool write(const QJsonObject &presentation, const QFileInfo &jsonFileInfo);
+
+    bool open(const QFileInfo &jsonFileInfo);
+    void close();
+    bool isOpen() const;
+
+    bool hasMaster() const;
+    QJsonObject master() const;
+
+    int numSlides() const;
+    QJsonObject slide(int idx) const;
+    QStringList slideMediaPaths(int idx) const;
+    int slideVisibility(int idx) const;
+
+private:
+    struct Entry {
+        quint64 offset = 0;
+        quint32 length = 0;
+        quint32 pathsLength = 0;
+        qint32 visibility = 0;
+    };
+
+    Entry entry(int idx) const;
+    QJsonObject decodeObject(const Entry &e) const;
+
+    QFile m_file;
+    const uchar *m_data = nullptr;
+    qint64 m_size = 0;
+    int m_numSlides = 0;
+};
+
+#endif // PRESENTATIONSNAPSHOT_H
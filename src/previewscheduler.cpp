@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "previewscheduler.h"
+#include "userinterfacesettings.h"
+
+#include <QtQuick/QQuickItem>
+#include <QtQuick/QQuickWindow>
+#include <algorithm>
+
+static int frameIntervalMs(int frameRate) {
+    return std::max(1, 1000 / std::clamp(frameRate, 1, 240));
+}
+
+PreviewScheduler *PreviewScheduler::forWindow(QQuickWindow *win) {
+    if (!win)
+        return nullptr;
+
+    PreviewScheduler *scheduler = win->findChild<PreviewScheduler *>(QString(), Qt::FindDirectChildrenOnly);
+    if (!scheduler) {
+        scheduler = new PreviewScheduler(win);
+    }
+    return scheduler;
+}
+
+PreviewScheduler::PreviewScheduler(QQuickWindow *win)
+    : QObject(win), m_window(win) {
+    m_clock.start();
+    connect(&m_timer, &QTimer::timeout, this, &PreviewScheduler::poll);
+    updateInterval();
+}
+
+void PreviewScheduler::addItem(QQuickItem *item, Rate rate, std::function<bool()> isDirty) {
+    if (!item)
+        return;
+
+    removeItem(item);
+    Source source;
+    source.item = item;
+    source.rate = rate;
+    source.isDirty = std::move(isDirty);
+    m_sources.push_back(std::move(source));
+
+    // Visibility changes need a frame, to show or clear the item
+    connect(item, &QQuickItem::visibleChanged, this, &PreviewScheduler::markDirty, Qt::UniqueConnection);
+
+    markDirty();
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void PreviewScheduler::setItemRate(QQuickItem *item, Rate rate) {
+    for (auto &source : m_sources) {
+        if (source.item == item)
+            source.rate = rate;
+    }
+}
+
+void PreviewScheduler::removeItem(QQuickItem *item) {
+    // Only compared, the item may be on its way out
+    m_sources.erase(std::remove_if(m_sources.begin(), m_sources.end(), [item](const Source &s) {
+        return s.item.isNull() || s.item == item;
+    }), m_sources.end());
+
+    if (m_sources.empty())
+        m_timer.stop();
+}
+
+void PreviewScheduler::removeItemLater(PreviewScheduler *scheduler, QQuickItem *item) {
+    if (!scheduler)
+        return;
+    QMetaObject::invokeMethod(scheduler, [scheduler, item]() {
+        scheduler->removeItem(item);
+    }, Qt::QueuedConnection);
+}
+
+void PreviewScheduler::markDirty() {
+    m_dirty = true;
+}
+
+void PreviewScheduler::updateInterval() {
+    int interval = frameIntervalMs(UserInterfaceSettings::previewFrameRate());
+    if (m_timer.interval() != interval)
+        m_timer.setInterval(interval);
+}
+
+void PreviewScheduler::poll() {
+    updateInterval();
+
+    const qint64 now = m_clock.elapsed();
+    const int thumbnailInterval = frameIntervalMs(UserInterfaceSettings::previewThumbnailFrameRate());
+
+    bool update = m_dirty;
+    m_dirty = false;
+    for (auto &source : m_sources) {
+        if (source.item.isNull() || !source.item->isVisible() || !source.isDirty)
+            continue;
+        if (source.rate == Thumbnail && now - source.lastPollMs < thumbnailInterval)
+            continue;
+        source.lastPollMs = now;
+        // Poll every source, they track what they have seen in their checks
+        if (source.isDirty())
+            update = true;
+    }
+
+    if (update && m_window)
+        m_window->update();
+}
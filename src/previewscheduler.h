@@ -0,0 +1,70 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef PREVIEWSCHEDULER_H
+#define PREVIEWSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <functional>
+#include <vector>
+
+class QQuickItem;
+class QQuickWindow;
+
+// Decides when a window with OpenGL preview items needs a new frame.
+//
+// The preview items draw straight into the window during its render pass, so a
+// frame can not be skipped per item. Instead each item registers a dirty check
+// here, and the window is only asked to update when a visible item has new
+// content (a new video frame, a changed property, a moved camera). Invisible
+// items are never polled. Thumbnail items are polled at a reduced rate.
+// Everything runs on the GUI thread.
+class PreviewScheduler : public QObject {
+    Q_OBJECT
+public:
+    enum Rate {
+        Live,
+        Thumbnail
+    };
+
+    // Scheduler of the window, created on first use and deleted with the window
+    static PreviewScheduler *forWindow(QQuickWindow *win);
+
+    // isDirty is polled while item is visible. Returning true requests a window update.
+    void addItem(QQuickItem *item, Rate rate, std::function<bool()> isDirty);
+    void setItemRate(QQuickItem *item, Rate rate);
+    void removeItem(QQuickItem *item);
+    // Thread safe variant of removeItem, for cleanup on the render thread
+    static void removeItemLater(PreviewScheduler *scheduler, QQuickItem *item);
+
+    // Request a window update on the next poll, i.e. after a property change
+    void markDirty();
+
+private:
+    explicit PreviewScheduler(QQuickWindow *win);
+
+    void poll();
+    void updateInterval();
+
+    struct Source {
+        QPointer<QQuickItem> item;
+        Rate rate = Live;
+        std::function<bool()> isDirty;
+        qint64 lastPollMs = 0;
+    };
+
+    QQuickWindow *m_window = nullptr;
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    std::vector<Source> m_sources;
+    bool m_dirty = true;
+};
+
+#endif // PREVIEWSCHEDULER_H
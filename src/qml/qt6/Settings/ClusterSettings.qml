@@ -0,0 +1,134 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls
+
+import org.kde.kirigami as Kirigami
+import org.ctoolbox.cplay
+
+SettingsBasePage {
+    id: root
+
+    property var stats: ({})
+    property var sync: stats.sync !== undefined ? stats.sync : ({})
+    property var nodes: stats.nodes !== undefined ? stats.nodes : []
+
+    function formatBytes(bytes) {
+        if (bytes === undefined)
+            return "-";
+        if (bytes >= 1048576)
+            return (bytes / 1048576).toFixed(2) + " MB";
+        if (bytes >= 1024)
+            return (bytes / 1024).toFixed(1) + " KB";
+        return Math.round(bytes) + " B";
+    }
+    function formatMs(ms) {
+        return ms === undefined ? "-" : ms.toFixed(2) + " ms";
+    }
+
+    Timer {
+        interval: 1000
+        repeat: true
+        running: root.visible
+        triggeredOnStart: true
+
+        onTriggered: root.stats = playerController.clusterStats()
+    }
+    GridLayout {
+        id: content
+
+        columns: 2
+
+        SettingsHeader {
+            Layout.columnSpan: 2
+            Layout.fillWidth: true
+            text: qsTr("Sync from master")
+        }
+        Label {
+            Layout.alignment: Qt.AlignRight
+            text: qsTr("Per frame (avg/max)")
+        }
+        Label {
+            text: root.formatBytes(root.sync.bytes_per_frame_avg) + " / " + root.formatBytes(root.sync.bytes_per_frame_max)
+        }
+        Label {
+            Layout.alignment: Qt.AlignRight
+            text: qsTr("Sent per frame (compressed)")
+        }
+        Label {
+            text: root.formatBytes(root.sync.sent_bytes_per_frame_avg)
+        }
+        Label {
+            Layout.alignment: Qt.AlignRight
+            text: qsTr("Per second")
+        }
+        Label {
+            text: root.formatBytes(root.sync.bytes_per_second) + "/s"
+        }
+        Label {
+            Layout.alignment: Qt.AlignRight
+            text: qsTr("Globals / layers full / layers always")
+        }
+        Label {
+            text: root.formatBytes(root.sync.globals_bytes_avg) + " / " + root.formatBytes(root.sync.layer_full_bytes_avg) + " / " + root.formatBytes(root.sync.layer_always_bytes_avg)
+        }
+        Label {
+            Layout.alignment: Qt.AlignRight
+            text: qsTr("Encode (avg/max)")
+        }
+        Label {
+            text: root.formatMs(root.sync.encode_ms_avg) + " / " + root.formatMs(root.sync.encode_ms_max)
+        }
+        Label {
+            Layout.alignment: Qt.AlignRight
+            text: qsTr("Total sent")
+        }
+        Label {
+            text: root.formatBytes(root.sync.total_bytes)
+        }
+        SettingsHeader {
+            Layout.columnSpan: 2
+            Layout.fillWidth: true
+            text: qsTr("Nodes")
+        }
+        Label {
+            Layout.columnSpan: 2
+            visible: root.nodes.length === 0
+            text: qsTr("No node reports. Nodes report over the SGCT data transfer connection,\nwhich needs a \"dataTransferPort\" in the cluster configuration.")
+        }
+        Repeater {
+            model: root.nodes
+
+            delegate: RowLayout {
+                required property var modelData
+
+                Layout.columnSpan: 2
+                spacing: Kirigami.Units.largeSpacing
+
+                Kirigami.Icon {
+                    implicitHeight: Kirigami.Units.iconSizes.small
+                    implicitWidth: Kirigami.Units.iconSizes.small
+                    source: !modelData.connected ? "network-disconnect" : (modelData.stale ? "data-warning" : "network-connect")
+                }
+                Label {
+                    Layout.preferredWidth: Kirigami.Units.gridUnit * 5
+                    text: qsTr("Node %1").arg(modelData.node >= 0 ? modelData.node : modelData.client)
+                }
+                Label {
+                    text: modelData.frame === undefined ? qsTr("No report yet") : qsTr("Lag %1 frames  Decode %2 (max %3)  Apply %4 (max %5)").arg(modelData.lag_frames).arg(root.formatMs(modelData.decode_ms_avg)).arg(root.formatMs(modelData.decode_ms_max)).arg(root.formatMs(modelData.apply_ms_avg)).arg(root.formatMs(modelData.apply_ms_max))
+                }
+            }
+        }
+        Item {
+            Layout.columnSpan: 2
+            Layout.fillHeight: true
+            width: Kirigami.Units.gridUnit
+        }
+    }
+}
@@ -619,5 +619,54 @@ SettingsBasePage {
         Item {
             Layout.fillWidth: true
         }
+
+        // ------------------------------------
+        // Frame-time profiler
+        // ------------------------------------
+        Label {
+            Layout.alignment: Qt.AlignRight
+            text: qsTr("Profiler")
+        }
+        RowLayout {
+            CheckBox {
+                id: profilerEnabledCheckBox
+
+                checked: playerController.profilerEnabled
+                text: qsTr("Measure frame times")
+
+                onToggled: {
+                    playerController.profilerEnabled = checked;
+                }
+
+                ToolTip {
+                    text: qsTr("Time the sync callbacks, layer updates and rendering on master and all nodes.")
+                }
+            }
+            CheckBox {
+                checked: playerController.profilerOverlay
+                enabled: profilerEnabledCheckBox.checked
+                text: qsTr("Show overlay on nodes")
+
+                onToggled: {
+                    playerController.profilerOverlay = checked;
+                }
+            }
+            Button {
+                enabled: profilerEnabledCheckBox.checked
+                icon.name: "document-save"
+                text: qsTr("Save Trace")
+
+                onClicked: {
+                    playerController.dumpProfilerTrace();
+                }
+
+                ToolTip {
+                    text: qsTr("Save a Chrome trace (chrome://tracing or ui.perfetto.dev) on master and all nodes, in data/log.")
+                }
+            }
+        }
+        Item {
+            Layout.fillWidth: true
+        }
     }
 }
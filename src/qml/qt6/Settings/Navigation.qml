@@ -33,6 +33,11 @@ Kirigami.Page {
             name: "Audio"
             page: "AudioSettings.qml"
         }
+        ListElement {
+            iconName: "network-server"
+            name: "Cluster"
+            page: "ClusterSettings.qml"
+        }
         ListElement {
             iconName: "kstars_hgrid"
             name: "Grid/mapping"
@@ -300,6 +300,59 @@ SettingsBasePage {
                 }
             }
         }
+        SettingsHeader {
+            Layout.columnSpan: 2
+            Layout.fillWidth: true
+            text: qsTr("Video render target")
+            level: 4
+        }
+        Label {
+            Layout.alignment: Qt.AlignRight
+            text: qsTr("Render target format:")
+        }
+        ComboBox {
+            id: videoRenderPrecisionComboBox
+
+            textRole: "mode"
+
+            model: ListModel {
+                id: videoRenderPrecisionMode
+
+                ListElement {
+                    mode: "From the video"
+                    value: 0
+                }
+                ListElement {
+                    mode: "RGBA8"
+                    value: 1
+                }
+                ListElement {
+                    mode: "RGB10_A2"
+                    value: 2
+                }
+                ListElement {
+                    mode: "RGBA16F"
+                    value: 3
+                }
+            }
+
+            Component.onCompleted: {
+                for (let i = 0; i < videoRenderPrecisionMode.count; ++i) {
+                    if (videoRenderPrecisionMode.get(i).value === PlaybackSettings.videoRenderPrecision) {
+                        currentIndex = i;
+                        break;
+                    }
+                }
+            }
+            onActivated: {
+                PlaybackSettings.videoRenderPrecision = model.get(index).value;
+                PlaybackSettings.save();
+            }
+        }
+        Label {
+            Layout.columnSpan: 2
+            text: qsTr("Applies to videos loaded after the change.")
+        }
         SettingsHeader {
             Layout.columnSpan: 2
             Layout.fillWidth: true
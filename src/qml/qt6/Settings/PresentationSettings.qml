@@ -285,6 +285,42 @@ SettingsBasePage {
             Layout.fillWidth: true
         }
 
+        Item {
+            height: 1
+            width: 1
+        }
+        CheckBox {
+            checked: PresentationSettings.writePresentationSnapshots
+            text: qsTr("Write binary snapshot next to presentations for faster loading.")
+
+            onCheckedChanged: {
+                PresentationSettings.writePresentationSnapshots = checked;
+                PresentationSettings.save();
+            }
+        }
+        Item {
+            // spacer item
+            Layout.fillWidth: true
+        }
+
+        Item {
+            height: 1
+            width: 1
+        }
+        CheckBox {
+            checked: PresentationSettings.showSlideThumbnails
+            text: qsTr("Show slide thumbnails in the slides list.")
+
+            onCheckedChanged: {
+                PresentationSettings.showSlideThumbnails = checked;
+                PresentationSettings.save();
+            }
+        }
+        Item {
+            // spacer item
+            Layout.fillWidth: true
+        }
+
         Label {
             Layout.alignment: Qt.AlignRight
             text: qsTr("Number of upcoming slides to preload:")
@@ -306,6 +342,25 @@ SettingsBasePage {
             Layout.fillWidth: true
         }
 
+        Item {
+            height: 1
+            width: 1
+        }
+        CheckBox {
+            checked: PresentationSettings.syncSlidesInScopeOnly
+            enabled: !PresentationSettings.preLoadLayers
+            text: qsTr("Only sync slides that can become visible to the nodes.")
+
+            onCheckedChanged: {
+                PresentationSettings.syncSlidesInScopeOnly = checked;
+                PresentationSettings.save();
+            }
+        }
+        Item {
+            // spacer item
+            Layout.fillWidth: true
+        }
+
         Label {
             Layout.alignment: Qt.AlignRight
             text: qsTr("Default visibility for new layer:")
@@ -102,6 +102,16 @@ Window {
         root.inspectorRevision++;
     }
 
+    // Helper: commit the easing of the segment starting at the selected keyframe
+    function commitSelectedEasing(easing, x1, y1, x2, y2) {
+        if (!root.selectedKf || !root.slideModel) return;
+        if (root.selectedKf.layerIdx < 0 || root.selectedKf.kfIdx < 0) return;
+        root.slideModel.setKeyframeEasing(
+            root.selectedKf.layerIdx, root.selectedKf.kfIdx,
+            easing, x1, y1, x2, y2);
+        root.inspectorRevision++;
+    }
+
     // layerCount: live count driven by the model so contentHeight updates correctly
     readonly property int layerCount: slideModel ? slideModel.rowCount() : 0
 
@@ -529,6 +539,62 @@ Window {
 
                     Item { Layout.fillWidth: true }
                 }
+
+                // ---- Row 4: easing towards the next keyframe ----
+                RowLayout {
+                    spacing: 10
+                    Layout.fillWidth: true
+
+                    Label { text: qsTr("Easing:"); color: "#aaa"; font.pointSize: 8 }
+                    ComboBox {
+                        id: easingCombo
+                        font.pointSize: 8
+                        implicitWidth: 140
+                        model: [qsTr("Linear"), qsTr("Ease in"), qsTr("Ease out"), qsTr("Ease in-out"),
+                                qsTr("Custom Bézier"), qsTr("Catmull-Rom")]
+                        currentIndex: { var _r = root.inspectorRevision; var d = root.selectedKfData(); return d ? d.easing : 0; }
+                        ToolTip.visible: hovered
+                        ToolTip.text: qsTr("Interpolation from this keyframe to the next one.")
+                        onActivated: {
+                            var d = root.selectedKfData(); if (!d) return;
+                            root.commitSelectedEasing(currentIndex, d.bezierX1, d.bezierY1, d.bezierX2, d.bezierY2);
+                        }
+                    }
+
+                    Repeater {
+                        model: [
+                            { label: "X1:", key: "bezierX1", from: 0,    to: 100 },
+                            { label: "Y1:", key: "bezierY1", from: -200, to: 300 },
+                            { label: "X2:", key: "bezierX2", from: 0,    to: 100 },
+                            { label: "Y2:", key: "bezierY2", from: -200, to: 300 }
+                        ]
+                        delegate: RowLayout {
+                            spacing: 4
+                            visible: easingCombo.currentIndex === 4
+
+                            Label { text: modelData.label; color: "#aaa"; font.pointSize: 8 }
+                            SpinBox {
+                                from: modelData.from; to: modelData.to; stepSize: 5
+                                editable: true
+                                value: { var _r = root.inspectorRevision; var d = root.selectedKfData(); return d ? Math.round(d[modelData.key] * 100) : 0; }
+                                implicitWidth: 80
+                                textFromValue: function(v) { return (v / 100.0).toFixed(2); }
+                                valueFromText: function(t) {
+                                    var parsed = parseFloat(t);
+                                    return isNaN(parsed) ? value : Math.round(parsed * 100);
+                                }
+                                onValueModified: {
+                                    var d = root.selectedKfData(); if (!d) return;
+                                    var b = { bezierX1: d.bezierX1, bezierY1: d.bezierY1, bezierX2: d.bezierX2, bezierY2: d.bezierY2 };
+                                    b[modelData.key] = value / 100.0;
+                                    root.commitSelectedEasing(d.easing, b.bezierX1, b.bezierY1, b.bezierX2, b.bezierY2);
+                                }
+                            }
+                        }
+                    }
+
+                    Item { Layout.fillWidth: true }
+                }
             }
         }
 
@@ -102,6 +102,23 @@ ItemDelegate {
                 subtitle: subText()
                 title: (slidesView.currentIndex === index ? slideNumText() : slideNumText() + model.name)
             }
+            Image {
+                id: slideThumbnail
+
+                // Rendered once per slide content in the background, see SlideThumbnailProvider
+                anchors.right: parent.right
+                anchors.rightMargin: 108
+                anchors.verticalCenter: parent.verticalCenter
+                asynchronous: true
+                cache: true
+                fillMode: Image.PreserveAspectFit
+                height: parent.height - 8
+                width: height * 16 / 9
+                source: PresentationSettings.showSlideThumbnails ? model.thumbnail : ""
+                sourceSize.height: 144
+                sourceSize.width: 256
+                visible: source != ""
+            }
             TextInput {
                 id: slideNameField
                 anchors.left: parent.left
@@ -0,0 +1,116 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "restclientpool.h"
+#include "httpclientmodel.h"
+#include "wwsclientmodel.h"
+
+#include <QHash>
+#include <QThread>
+#include <QUrl>
+
+RestClientPool *RestClientPool::_instance = nullptr;
+
+// Requests are mostly waiting on the network, and most shows talk to a few devices
+static constexpr int NumWorkers = 4;
+
+RestClientPool::RestClientPool() {
+    for (int i = 0; i < NumWorkers; i++) {
+        auto worker = std::make_unique<Worker>();
+        Worker *w = worker.get();
+        w->thread = new QThread();
+        w->thread->setObjectName(QStringLiteral("RestClientPool %1").arg(i));
+
+        w->http = new HttpRequestWorker();
+        w->http->moveToThread(w->thread);
+        connect(w->thread, &QThread::finished, w->http, &QObject::deleteLater);
+        connect(w->http, &HttpRequestWorker::requestFinished, this, [w](int statusCode, const QString &responseBody, const QString &error) {
+            if (w->httpCallbacks.empty())
+                return;
+            ResultCallback callback = std::move(w->httpCallbacks.front());
+            w->httpCallbacks.pop_front();
+            if (callback)
+                callback(statusCode, responseBody, error);
+        });
+
+        w->wws = new WwsRequestWorker();
+        w->wws->moveToThread(w->thread);
+        connect(w->thread, &QThread::finished, w->wws, &QObject::deleteLater);
+        connect(w->wws, &WwsRequestWorker::requestFinished, this, [w](int statusCode, const QString &responseBody, const QString &error) {
+            if (w->wwsCallbacks.empty())
+                return;
+            ResultCallback callback = std::move(w->wwsCallbacks.front());
+            w->wwsCallbacks.pop_front();
+            if (callback)
+                callback(statusCode, responseBody, error);
+        });
+
+        w->thread->start();
+        m_workers.push_back(std::move(worker));
+    }
+}
+
+RestClientPool::~RestClientPool() {
+    for (auto &w : m_workers) {
+        w->thread->quit();
+        w->thread->wait();
+        delete w->thread;
+    }
+}
+
+RestClientPool &RestClientPool::instance() {
+    if (!_instance) {
+        _instance = new RestClientPool();
+    }
+    return *_instance;
+}
+
+void RestClientPool::destroy() {
+    if (_instance) {
+        delete _instance;
+        _instance = nullptr;
+    }
+}
+
+void RestClientPool::sendHttpRequest(const QString &url, int method, const QString &parameters, bool ignoreStatus, ResultCallback callback) {
+    // Callback queues are only touched on the pool thread
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, url, method, parameters, ignoreStatus, callback]() {
+            sendHttpRequest(url, method, parameters, ignoreStatus, callback);
+        }, Qt::QueuedConnection);
+        return;
+    }
+    Worker &w = workerFor(url);
+    w.httpCallbacks.push_back(std::move(callback));
+    QMetaObject::invokeMethod(w.http, "doRequest", Qt::QueuedConnection,
+        Q_ARG(QString, url),
+        Q_ARG(int, method),
+        Q_ARG(QString, parameters),
+        Q_ARG(bool, ignoreStatus));
+}
+
+void RestClientPool::sendWebSocketRequest(const QString &url, const QString &parameters, bool ignoreStatus, ResultCallback callback) {
+    if (QThread::currentThread() != thread()) {
+        QMetaObject::invokeMethod(this, [this, url, parameters, ignoreStatus, callback]() {
+            sendWebSocketRequest(url, parameters, ignoreStatus, callback);
+        }, Qt::QueuedConnection);
+        return;
+    }
+    Worker &w = workerFor(url);
+    w.wwsCallbacks.push_back(std::move(callback));
+    QMetaObject::invokeMethod(w.wws, "doRequest", Qt::QueuedConnection,
+        Q_ARG(QString, url),
+        Q_ARG(QString, parameters),
+        Q_ARG(bool, ignoreStatus));
+}
+
+RestClientPool::Worker &RestClientPool::workerFor(const QString &url) {
+    // Pick worker by endpoint, so connections to it are reused
+    QUrl endpoint(url.contains(QStringLiteral("://")) ? url : QStringLiteral("http://") + url);
+    QString key = endpoint.host() + QLatin1Char(':') + QString::number(endpoint.port());
+    return *m_workers[qHash(key) % m_workers.size()];
+}
@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef RESTCLIENTPOOL_H
+#define RESTCLIENTPOOL_H
+
+#include <QObject>
+#include <QString>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class HttpRequestWorker;
+class WwsRequestWorker;
+class QThread;
+
+// Process-wide pool of HTTP and WebSocket request workers, shared by REST layers and
+// the REST command editors. Requests to the same endpoint always go to the same worker,
+// which keeps its keep-alive connections and WebSocket sessions open between requests.
+class RestClientPool : public QObject {
+    Q_OBJECT
+
+public:
+    // Invoked on the thread owning the pool (the GUI thread)
+    using ResultCallback = std::function<void(int statusCode, const QString &responseBody, const QString &error)>;
+
+    static RestClientPool &instance();
+    static void destroy();
+
+    void sendHttpRequest(const QString &url, int method, const QString &parameters, bool ignoreStatus, ResultCallback callback);
+    void sendWebSocketRequest(const QString &url, const QString &parameters, bool ignoreStatus, ResultCallback callback);
+
+private:
+    RestClientPool();
+    ~RestClientPool();
+
+    struct Worker {
+        QThread *thread = nullptr;
+        HttpRequestWorker *http = nullptr;
+        WwsRequestWorker *wws = nullptr;
+        // Workers handle requests in order, so results are matched to callbacks first in, first out
+        std::deque<ResultCallback> httpCallbacks;
+        std::deque<ResultCallback> wwsCallbacks;
+    };
+
+    Worker &workerFor(const QString &url);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    static RestClientPool *_instance;
+};
+
+#endif // RESTCLIENTPOOL_H
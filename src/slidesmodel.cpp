@@ -9,13 +9,22 @@
 #include "layersmodel.h"
 #include "locationsettings.h"
 #include "presentationsettings.h"
+#include "presentationsnapshot.h"
+#include "slidethumbnailprovider.h"
 #include "layers/baselayer.h"
 #include <QDir>
 #include <QFileInfo>
+#include <QFileSystemWatcher>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSemaphore>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
 #include <QTimer>
+#include <algorithm>
+#include <vector>
 
 SlideVisibilityModel::SlideVisibilityModel(QList<QSharedPointer<LayersModel>>* slideList, QObject* parent)
     : QAbstractTableModel(parent), m_slideList(slideList){
@@ -378,11 +387,18 @@ SlidesModel::SlidesModel(QObject *parent)
     m_clearCopyTimer->setInterval(30000);
     m_clearCopyTimer->setSingleShot(true);
     connect(m_clearCopyTimer, &QTimer::timeout, this, &SlidesModel::clearCopyLayer);
+    m_thumbnailWatcher = new QFileSystemWatcher(this);
+    connect(m_thumbnailWatcher, &QFileSystemWatcher::fileChanged, this, &SlidesModel::onThumbnailFileChanged);
     connect(this, &SlidesModel::slideModelChanged, m_visibilityModel, &SlideVisibilityModel::resetTable);
     connect(m_masterSlide, &LayersModel::layersNeedsSaveChanged, this, &SlidesModel::setLayersNeedsSave);
+    m_loadPool = new QThreadPool(this);
+    // Path probing mostly waits on (network) file systems, so use more threads than cores
+    m_loadPool->setMaxThreadCount(std::max(8, QThread::idealThreadCount() * 2));
 }
 
 SlidesModel::~SlidesModel() {
+    cancelPendingLoad();
+    m_loadPool->waitForDone();
     clearAllForShutdown();
     m_slides.clear();
     delete m_masterSlide;
@@ -428,6 +444,16 @@ QVariant SlidesModel::data(const QModelIndex &index, int role) const {
             return QVariant(tlVis);
         return QVariant(slideItem->getLayersVisibility());
     }
+    case ThumbnailRole: {
+        // Only changes with the content of the slide, so the image is reused until then
+        bool rebuilt = false;
+        QString hash = slideItem->thumbnailHash(&rebuilt);
+        if (rebuilt)
+            watchThumbnailFiles(slideItem.data());
+        if (hash.isEmpty())
+            return QVariant(QString());
+        return QVariant(QStringLiteral("image://%1/%2").arg(SlideThumbnailProvider::Id, hash));
+    }
     }
 
     return QVariant();
@@ -443,6 +469,7 @@ QHash<int, QByteArray> SlidesModel::roleNames() const {
     roles[LockedRole] = "locked";
     roles[LockedCountRole] = "countlocked";
     roles[VisibilityRole] = "visibility";
+    roles[ThumbnailRole] = "thumbnail";
     return roles;
 }
 
@@ -464,8 +491,12 @@ void SlidesModel::setNeedsSync(bool value) {
     Q_EMIT needsSyncChanged();
 }
 
-void SlidesModel::setHasSynced() {
-    if (m_syncIteration > 0) {
+void SlidesModel::setHasSynced(bool allIterations) {
+    if (allIterations) {
+        m_syncIteration = 0;
+        m_needSync = false;
+    }
+    else if (m_syncIteration > 0) {
         m_syncIteration--;
     }
     else {
@@ -483,6 +514,33 @@ void SlidesModel::setPreLoadLayers(bool value) {
     Q_EMIT preLoadLayersChanged();
 }
 
+bool SlidesModel::SyncScope::contains(int slideIdx, const BaseLayer *layer) const {
+    // Master slide is always in scope
+    if (allSlides || slideIdx < 0)
+        return true;
+    if (slideIdx == triggeredIdx || slideIdx == previousTriggeredIdx || slideIdx == selectedIdx)
+        return true;
+    // Visible for some other reason, such as a HTTP or QR command
+    if (layer && layer->alpha() > 0.f)
+        return true;
+
+    // Upcoming slides to preload, or earlier slides with layers kept visible until they fade out
+    int slidesSince = triggeredIdx - slideIdx;
+    if (slidesSince < 0)
+        return -slidesSince <= lookAhead;
+    return layer && slidesSince <= layer->keepVisibilityForNumSlides() + 1;
+}
+
+SlidesModel::SyncScope SlidesModel::syncScope() {
+    SyncScope scope;
+    scope.allSlides = m_preloadLayers || !PresentationSettings::syncSlidesInScopeOnly();
+    scope.triggeredIdx = m_triggeredSlideIdx;
+    scope.previousTriggeredIdx = m_previousTriggeredSlideIdx;
+    scope.selectedIdx = m_selectedSlideIdx;
+    scope.lookAhead = PresentationSettings::updateUpcomingSlideCount();
+    return scope;
+}
+
 int SlidesModel::selectedSlideIdx() {
     return m_selectedSlideIdx;
 }
@@ -839,12 +897,48 @@ void SlidesModel::updateSlide(int i) {
     }
 }
 
+void SlidesModel::watchThumbnailFiles(LayersModel *lm) const {
+    const QStringList watched = m_thumbnailWatcher->files();
+    QStringList files;
+    for (int i = 0; i < lm->numberOfLayers(); i++) {
+        BaseLayer *layer = lm->layer(i);
+        if (!layer)
+            continue;
+        QString path = QString::fromStdString(layer->filepath());
+        if (!path.isEmpty() && !watched.contains(path) && !files.contains(path) && QFileInfo::exists(path))
+            files.append(path);
+    }
+    if (!files.isEmpty())
+        m_thumbnailWatcher->addPaths(files);
+}
+
+void SlidesModel::onThumbnailFileChanged(const QString &path) {
+    const std::string filePath = path.toStdString();
+    for (int i = 0; i < m_slides.size(); i++) {
+        LayersModel *lm = m_slides[i].get();
+        if (!lm)
+            continue;
+        for (int l = 0; l < lm->numberOfLayers(); l++) {
+            BaseLayer *layer = lm->layer(l);
+            if (layer && layer->filepath() == filePath) {
+                lm->invalidateThumbnailHash();
+                updateSlide(i);
+                break;
+            }
+        }
+    }
+    // A file replaced by a rename is no longer watched
+    if (QFileInfo::exists(path) && !m_thumbnailWatcher->files().contains(path))
+        m_thumbnailWatcher->addPath(path);
+}
+
 void SlidesModel::updateSelectedSlide() {
     if (m_selectedSlideIdx >= 0 && m_selectedSlideIdx < m_slides.size())
         updateSlide(m_selectedSlideIdx);
 }
 
 void SlidesModel::clearSlides() {
+    cancelPendingLoad();
     {
         std::lock_guard<std::recursive_mutex> lock(m_slidesMutex);
         //Move all locked slides above unlocked ones
@@ -1026,6 +1120,8 @@ QString SlidesModel::makePathRelativeTo(const QString &filePath, const QStringLi
 }
 
 void SlidesModel::loadFromJSONFile(const QString &path) {
+    cancelPendingLoad();
+
     QString fileToOpen = path;
     fileToOpen.replace(QStringLiteral("file:///"), QStringLiteral(""));
 
@@ -1042,21 +1138,58 @@ void SlidesModel::loadFromJSONFile(const QString &path) {
         return;
     }
 
-    QFile f(fileToOpen);
-    if (!f.open(QIODevice::ReadOnly)) {
-        qDebug() << QStringLiteral("Failed to open C-play presentation: ") << fileToOpen;
-        return;
+    // Use the binary snapshot if there is an up to date one, as it does not need
+    // the whole document to be parsed. Slides are then decoded one at a time.
+    bool hasMaster = false;
+    QJsonObject masterObj;
+    QList<int> slideVisibilities;
+    m_pendingSnapshot = std::make_unique<PresentationSnapshot>();
+    if (m_pendingSnapshot->open(jsonFileInfo)) {
+        hasMaster = m_pendingSnapshot->hasMaster();
+        masterObj = m_pendingSnapshot->master();
+        m_numPendingSlides = m_pendingSnapshot->numSlides();
+        for (int i = 0; i < m_numPendingSlides; i++) {
+            slideVisibilities.append(m_pendingSnapshot->slideVisibility(i));
+            m_pendingSlidePaths.append(m_pendingSnapshot->slideMediaPaths(i));
+        }
     }
-    QByteArray fileContent = f.readAll();
-    f.close();  
+    else {
+        m_pendingSnapshot.reset();
 
-    QJsonDocument doc = QJsonDocument::fromJson(fileContent);
-    if (doc.isNull()) {
-        qDebug() << QStringLiteral("Parsing C-play presentation failed: ") << fileToOpen;
-        return;
-    }
+        QFile f(fileToOpen);
+        if (!f.open(QIODevice::ReadOnly)) {
+            qDebug() << QStringLiteral("Failed to open C-play presentation: ") << fileToOpen;
+            return;
+        }
+        QByteArray fileContent = f.readAll();
+        f.close();  
 
-    QJsonObject obj = doc.object();
+        QJsonDocument doc = QJsonDocument::fromJson(fileContent);
+        if (doc.isNull()) {
+            qDebug() << QStringLiteral("Parsing C-play presentation failed: ") << fileToOpen;
+            return;
+        }
+
+        QJsonObject obj = doc.object();
+        if (PresentationSettings::writePresentationSnapshots()) {
+            // Written in the background, it is only needed the next time the file is opened.
+            // QFileInfo caches lazily, so the thread gets its own instead of a shared copy.
+            const QString jsonPath = jsonFileInfo.absoluteFilePath();
+            m_loadPool->start([obj, jsonPath]() {
+                PresentationSnapshot::write(obj, QFileInfo(jsonPath));
+            });
+        }
+
+        hasMaster = obj.contains(QStringLiteral("master"));
+        masterObj = obj.value(QStringLiteral("master")).toObject();
+        m_pendingSlides = obj.value(QStringLiteral("slides")).toArray();
+        m_numPendingSlides = m_pendingSlides.size();
+        for (int i = 0; i < m_numPendingSlides; i++) {
+            QJsonObject o = m_pendingSlides[i].toObject();
+            slideVisibilities.append(o.value(QStringLiteral("visibility")).toInt());
+            m_pendingSlidePaths.append(LayersModel::mediaPathsFromJSON(o));
+        }
+    }
 
     QStringList fileSearchPaths;
     fileSearchPaths.append(jsonFileInfo.absoluteDir().absolutePath());
@@ -1064,27 +1197,40 @@ void SlidesModel::loadFromJSONFile(const QString &path) {
     fileSearchPaths.append(LocationSettings::cPlayFileLocation());
     fileSearchPaths.append(LocationSettings::univiewVideoLocation());
 
-    if (obj.contains(QStringLiteral("master"))) {
-        QJsonValue value = obj.value(QStringLiteral("master"));
-        QJsonObject o = value.toObject();
-        m_masterSlide->decodeFromJSON(o, fileSearchPaths);
+    // Loading is done in stages. The master and all slides up to the first visible one
+    // are populated directly, so the UI is interactive when this returns. The remaining
+    // slides are streamed in as soon as their media paths have been resolved in the background.
+    m_pendingSearchPaths = fileSearchPaths;
+    m_nextPendingSlide = 0;
+
+    int numSlidesToLoadNow = std::min(1, m_numPendingSlides);
+    for (int i = 0; i < m_numPendingSlides; i++) {
+        if (slideVisibilities[i] > 0) {
+            numSlidesToLoadNow = i + 1;
+            break;
+        }
+    }
+
+    QStringList pathsToResolveNow = LayersModel::mediaPathsFromJSON(masterObj);
+    for (int i = 0; i < numSlidesToLoadNow; i++) {
+        pathsToResolveNow.append(m_pendingSlidePaths[i]);
+    }
+    pathsToResolveNow.removeDuplicates();
+    m_resolvedPaths = resolvePaths(pathsToResolveNow, fileSearchPaths);
+
+    if (hasMaster) {
+        m_masterSlide->decodeFromJSON(masterObj, fileSearchPaths, &m_resolvedPaths);
         m_masterSlide->setLayersName(QStringLiteral("Master"));
     }
 
     bool slideVisible = false;
-    if (obj.contains(QStringLiteral("slides"))) {
-        QJsonValue value = obj.value(QStringLiteral("slides"));
-        QJsonArray array = value.toArray();
-        for (auto v : array) {
-            QJsonObject o = v.toObject();
-            int idx = addSlide();
-            m_slides[idx]->decodeFromJSON(o, fileSearchPaths);
-            if (!slideVisible && m_slides[idx]->getLayersVisibility() > 0) {
-                slideVisible = true;
-                m_previousTriggeredSlideIdx = idx - 1;
-                m_selectedSlideIdx = idx;
-                m_triggeredSlideIdx = idx;
-            }
+    while (m_nextPendingSlide < numSlidesToLoadNow) {
+        int idx = populatePendingSlide();
+        if (!slideVisible && m_slides[idx]->getLayersVisibility() > 0) {
+            slideVisible = true;
+            m_previousTriggeredSlideIdx = idx - 1;
+            m_selectedSlideIdx = idx;
+            m_triggeredSlideIdx = idx;
         }
     }
 
@@ -1107,9 +1253,203 @@ void SlidesModel::loadFromJSONFile(const QString &path) {
     setNeedSync();
 
     Q_EMIT presentationHasLoaded();
+
+    if (m_nextPendingSlide >= m_numPendingSlides) {
+        finishPendingLoad();
+        return;
+    }
+
+    m_presentationLoading = true;
+    Q_EMIT presentationLoadingChanged();
+
+    QStringList pathsToResolveLater;
+    QSet<QString> queuedPaths;
+    for (int i = m_nextPendingSlide; i < m_pendingSlidePaths.size(); i++) {
+        for (const QString &p : m_pendingSlidePaths[i]) {
+            if (!m_resolvedPaths.contains(p) && !queuedPaths.contains(p)) {
+                queuedPaths.insert(p);
+                pathsToResolveLater.append(p);
+            }
+        }
+    }
+    resolvePathsAsync(pathsToResolveLater, fileSearchPaths);
+
+    // In case the next slide(s) did not need any new paths
+    const int generation = m_loadGeneration;
+    QTimer::singleShot(0, this, [this, generation]() {
+        if (generation == m_loadGeneration)
+            populatePendingSlides();
+    });
+}
+
+bool SlidesModel::presentationLoading() const {
+    return m_presentationLoading;
+}
+
+QHash<QString, QString> SlidesModel::resolvePaths(const QStringList &paths, const QStringList &searchPaths) {
+    // Probe all paths in parallel and wait for the results
+    std::vector<QString> results(paths.size());
+    QSemaphore done;
+    LayersModel *resolver = m_masterSlide;
+    for (int i = 0; i < paths.size(); i++) {
+        m_loadPool->start([&results, &done, &paths, &searchPaths, resolver, i]() {
+            results[i] = resolver->checkAndCorrectPath(paths[i], searchPaths);
+            done.release();
+        });
+    }
+    done.acquire(paths.size());
+
+    QHash<QString, QString> resolved;
+    for (int i = 0; i < paths.size(); i++) {
+        resolved.insert(paths[i], results[i]);
+    }
+    return resolved;
+}
+
+void SlidesModel::resolvePathsAsync(const QStringList &paths, const QStringList &searchPaths) {
+    const int generation = m_loadGeneration;
+    LayersModel *resolver = m_masterSlide;
+    for (const QString &path : paths) {
+        m_loadPool->start([this, resolver, generation, path, searchPaths]() {
+            // Skip work for a presentation that is no longer loading
+            if (generation != m_loadGeneration)
+                return;
+
+            QString resolvedPath = resolver->checkAndCorrectPath(path, searchPaths);
+            QMetaObject::invokeMethod(this, [this, generation, path, resolvedPath]() {
+                onPathResolved(generation, path, resolvedPath);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void SlidesModel::onPathResolved(int generation, QString path, QString resolvedPath) {
+    if (generation != m_loadGeneration || !m_presentationLoading)
+        return;
+
+    m_resolvedPaths.insert(path, resolvedPath);
+    populatePendingSlides();
+}
+
+bool SlidesModel::pendingSlideIsReady(int idx) const {
+    if (idx < 0 || idx >= m_pendingSlidePaths.size())
+        return false;
+
+    for (const QString &p : m_pendingSlidePaths[idx]) {
+        if (!m_resolvedPaths.contains(p))
+            return false;
+    }
+    return true;
+}
+
+int SlidesModel::populatePendingSlide() {
+    QJsonObject o = m_pendingSnapshot ? m_pendingSnapshot->slide(m_nextPendingSlide) : m_pendingSlides[m_nextPendingSlide].toObject();
+    m_nextPendingSlide++;
+    m_populatingPendingSlide = true;
+    int idx = addSlide();
+    m_slides[idx]->decodeFromJSON(o, m_pendingSearchPaths, &m_resolvedPaths);
+    m_populatingPendingSlide = false;
+
+    // Slides that arrive after the post-load hooks ran need them on their own
+    if (m_postLoadHooksRan)
+        runPostLoadHooksOnSlide(idx);
+    return idx;
+}
+
+void SlidesModel::runPostLoadHooksOnSlide(int slideIdx) {
+    const Layers& slideLayers = slide(slideIdx)->getLayers();
+    for (auto layer : slideLayers) {
+        if (!layer.first)
+            continue;
+        layer.first->updateAudioOutput();
+        if (PresentationSettings::masterVolumeControlLayersVolume()) {
+            layer.first->setVolumeScaling(m_volumeScaling);
+            float volLevelF = static_cast<float>(layer.first->volume()) * m_volumeScaling;
+            layer.first->setVolume(static_cast<int>(volLevelF), false);
+        }
+        if (layer.first->alpha() > 0.f) {
+            layer.first->start();
+        }
+    }
+}
+
+void SlidesModel::populatePendingSlides() {
+    if (!m_presentationLoading)
+        return;
+
+    // Slides are added in order, one per event loop iteration to keep the UI responsive
+    if (pendingSlideIsReady(m_nextPendingSlide)) {
+        // Streaming in slides should not mark the presentation as modified
+        bool needsSave = m_slidesNeedsSave;
+        populatePendingSlide();
+        setSlidesNeedsSave(needsSave);
+
+        if (pendingSlideIsReady(m_nextPendingSlide)) {
+            const int generation = m_loadGeneration;
+            QTimer::singleShot(0, this, [this, generation]() {
+                if (generation == m_loadGeneration)
+                    populatePendingSlides();
+            });
+        }
+    }
+
+    if (m_nextPendingSlide >= m_numPendingSlides)
+        finishPendingLoad();
+}
+
+void SlidesModel::completePendingLoad() {
+    if (!m_presentationLoading)
+        return;
+
+    QStringList remainingPaths;
+    for (int i = m_nextPendingSlide; i < m_pendingSlidePaths.size(); i++) {
+        for (const QString &p : m_pendingSlidePaths[i]) {
+            if (!m_resolvedPaths.contains(p))
+                remainingPaths.append(p);
+        }
+    }
+    remainingPaths.removeDuplicates();
+    m_resolvedPaths.insert(resolvePaths(remainingPaths, m_pendingSearchPaths));
+
+    bool needsSave = m_slidesNeedsSave;
+    while (m_nextPendingSlide < m_numPendingSlides) {
+        populatePendingSlide();
+    }
+    setSlidesNeedsSave(needsSave);
+
+    finishPendingLoad();
+}
+
+void SlidesModel::finishPendingLoad() {
+    m_pendingSlides = QJsonArray();
+    m_pendingSnapshot.reset();
+    m_numPendingSlides = 0;
+    m_pendingSlidePaths.clear();
+    m_pendingSearchPaths.clear();
+    m_resolvedPaths.clear();
+    m_nextPendingSlide = 0;
+
+    if (m_presentationLoading) {
+        m_presentationLoading = false;
+        Q_EMIT presentationLoadingChanged();
+    }
+
+    if (m_pendingLoadNeedsSync) {
+        m_pendingLoadNeedsSync = false;
+        setNeedSync();
+    }
+}
+
+void SlidesModel::cancelPendingLoad() {
+    m_loadGeneration++;
+    m_postLoadHooksRan = false;
+    finishPendingLoad();
 }
 
 void SlidesModel::saveAsJSONFile(const QString &path) {
+    // Make sure all slides are in the model before saving
+    completePendingLoad();
+
     QJsonDocument doc;
     QJsonObject obj = doc.object();
 
@@ -1147,6 +1487,9 @@ void SlidesModel::saveAsJSONFile(const QString &path) {
     jsonFile.close();
 
     QFileInfo fileInfo(jsonFile);
+    if (PresentationSettings::writePresentationSnapshots())
+        PresentationSnapshot::write(obj, fileInfo);
+
     setSlidesName(fileInfo.baseName());
     setSlidesPath(fileToSave);
     updateRecentLoadedPresentations(fileToSave);
@@ -1155,6 +1498,8 @@ void SlidesModel::saveAsJSONFile(const QString &path) {
 }
 
 void SlidesModel::runStartAfterPresentationLoad() {
+    m_postLoadHooksRan = true;
+
     // Let's start all layers that have a visibility
     for (int i = -1; i < numberOfSlides(); i++) {
         const Layers& slideLayers = slide(i)->getLayers();
@@ -1254,7 +1599,35 @@ void SlidesModel::runRenderOnLayersThatShouldUpdate(bool updateRendering) {
     }
 }
 
+bool SlidesModel::hasLayersToUpdate() {
+    if (pauseLayerUpdate())
+        return false;
+    for (int i = -1; i < numberOfSlides(); i++) {
+        LayersModel *lm = slide(i);
+        if (lm && lm->hasLayersToUpdate(preLoadLayers()))
+            return true;
+    }
+    return false;
+}
+
+uint64_t SlidesModel::layersChangeCount() {
+    uint64_t count = 0;
+    for (int i = -1; i < numberOfSlides(); i++) {
+        LayersModel *lm = slide(i);
+        if (lm)
+            count += lm->layersChangeCount();
+    }
+    return count;
+}
+
 void SlidesModel::setNeedSync() {
+    // Each streamed in slide would otherwise restart the sync iterations,
+    // giving continuous full syncs for as long as a big presentation loads
+    if (m_populatingPendingSlide) {
+        m_pendingLoadNeedsSync = true;
+        return;
+    }
+
     m_needSync = true;
     m_syncIteration = PresentationSettings::networkSyncIterations();
 }
@@ -13,10 +13,17 @@
 #include <QAbstractTableModel>
 #include <QtQml/qqmlregistration.h>
 #include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <atomic>
+#include <memory>
 #include <mutex>
 
 class BaseLayer;
 class LayersModel;
+class PresentationSnapshot;
+class QFileSystemWatcher;
+class QThreadPool;
 class QTimer;
 
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
@@ -88,7 +95,8 @@ public:
         LayerMaxStatusRole,
         LockedRole,
         LockedCountRole,
-        VisibilityRole
+        VisibilityRole,
+        ThumbnailRole
     };
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -104,7 +112,7 @@ public:
 
     bool needsSync();
     void setNeedsSync(bool value);
-    void setHasSynced();
+    void setHasSynced(bool allIterations = false);
 
     Q_PROPERTY(bool preLoadLayers
         READ preLoadLayers
@@ -114,6 +122,18 @@ public:
     bool preLoadLayers();
     void setPreLoadLayers(bool value);
 
+    // Slides whose layers can become visible, the only ones synced to the nodes
+    struct SyncScope {
+        bool allSlides = true;
+        int triggeredIdx = -1;
+        int previousTriggeredIdx = -1;
+        int selectedIdx = -1;
+        int lookAhead = 0;
+
+        bool contains(int slideIdx, const BaseLayer *layer) const;
+    };
+    SyncScope syncScope();
+
     Q_PROPERTY(int selectedSlideIdx
         READ selectedSlideIdx
         WRITE setSelectedSlideIdx
@@ -218,6 +238,13 @@ public:
     Q_INVOKABLE void loadFromJSONFile(const QString &path);
     Q_INVOKABLE void saveAsJSONFile(const QString &path);
 
+    // True while slides of the last loaded presentation are still streaming in
+    Q_PROPERTY(bool presentationLoading
+        READ presentationLoading
+        NOTIFY presentationLoadingChanged)
+
+    bool presentationLoading() const;
+
     Q_INVOKABLE void runStartAfterPresentationLoad();
     Q_INVOKABLE void runUpdateAudioOutputOnLayers();
     Q_INVOKABLE void runUpdateVolumeOnLayers(int volume);
@@ -241,6 +268,9 @@ public:
     Q_INVOKABLE void clearRecentPresentations();
 
     void runRenderOnLayersThatShouldUpdate(bool updateRendering);
+    // Used by the preview scheduler to only redraw while layers change
+    bool hasLayersToUpdate();
+    uint64_t layersChangeCount();
 
     Q_INVOKABLE void startTimeline(int slideIdx);
     Q_INVOKABLE void startTimelineFrom(int slideIdx, int startMs);
@@ -274,6 +304,21 @@ private:
     void setNeedSync();
     void updateRecentLoadedPresentations(QString path);
     void onSlideVisibilityChanged(int slideIdx);
+    // Files of the layers in thumbnails, so a changed file gives a new thumbnail
+    void watchThumbnailFiles(LayersModel *lm) const;
+    void onThumbnailFileChanged(const QString &path);
+
+    // Staged presentation loading
+    QHash<QString, QString> resolvePaths(const QStringList &paths, const QStringList &searchPaths);
+    void resolvePathsAsync(const QStringList &paths, const QStringList &searchPaths);
+    void onPathResolved(int generation, QString path, QString resolvedPath);
+    void populatePendingSlides();
+    bool pendingSlideIsReady(int idx) const;
+    int populatePendingSlide();
+    void runPostLoadHooksOnSlide(int slideIdx);
+    void completePendingLoad();
+    void finishPendingLoad();
+    void cancelPendingLoad();
 
 Q_SIGNALS:
     void slideModelChanged();
@@ -293,6 +338,7 @@ Q_SIGNALS:
     void pauseLayerUpdateChanged();
     void preLoadLayersChanged();
     void recentPresentationsChanged();
+    void presentationLoadingChanged();
 
 private:
     QList<QSharedPointer<LayersModel>> m_slides;
@@ -316,6 +362,23 @@ private:
     QString m_slidesName;
     QString m_slidesPath;
     QTimer* m_clearCopyTimer;
+    QFileSystemWatcher* m_thumbnailWatcher;
+
+    QThreadPool* m_loadPool;
+    std::atomic_int m_loadGeneration = 0;
+    bool m_presentationLoading = false;
+    QJsonArray m_pendingSlides;
+    std::unique_ptr<PresentationSnapshot> m_pendingSnapshot;
+    int m_numPendingSlides = 0;
+    QList<QStringList> m_pendingSlidePaths;
+    int m_nextPendingSlide = 0;
+    QStringList m_pendingSearchPaths;
+    QHash<QString, QString> m_resolvedPaths;
+    // Streamed in slides are synced once, when loading finishes
+    bool m_populatingPendingSlide = false;
+    bool m_pendingLoadNeedsSync = false;
+    // runStartAfterPresentationLoad() has run for the presentation being loaded
+    bool m_postLoadHooksRan = false;
 };
 
 #endif // SLIDESMODEL_H
@@ -9,7 +9,6 @@
 #include "slidesmodel.h"
 
 #include <QOpenGLContext>
-#include <QTimer>
 #include <QtCore/QRunnable>
 #include <QtQuick/QQuickWindow>
 #include <QtQuick/QQuickRenderControl>
@@ -112,6 +111,9 @@ void SlidesQtItem::handleWindowChanged(QQuickWindow* win) {
 }
 
 void SlidesQtItem::cleanup() {
+    PreviewScheduler::removeItemLater(m_scheduler.data(), this);
+    m_scheduler = nullptr;
+
     if (m_renderer) {
         delete m_renderer;
         m_renderer = nullptr;
@@ -127,4 +129,26 @@ void SlidesQtItem::initializeWithControlWindow(QQuickWindow* win, SlidesModel* s
         connect(m_parentWindow, &QQuickWindow::beforeRendering, m_renderer, &SlidesQtItemRenderer::init, Qt::DirectConnection);
         connect(m_parentWindow, &QQuickWindow::beforeRenderPassRecording, m_renderer, &SlidesQtItemRenderer::update, Qt::DirectConnection);
     }
+
+    // The layers are only updated with the window frames, so keep the window
+    // going while slide layers are loading or playing
+    m_slidesModel = sm;
+    if (!m_scheduler) {
+        m_scheduler = PreviewScheduler::forWindow(m_parentWindow);
+        if (m_scheduler) {
+            m_scheduler->addItem(this, PreviewScheduler::Live, [this]() {
+                return layersNeedUpdate();
+            });
+        }
+    }
+}
+
+bool SlidesQtItem::layersNeedUpdate() {
+    if (!m_slidesModel)
+        return false;
+
+    uint64_t changeCount = m_slidesModel->layersChangeCount();
+    bool changed = changeCount != m_seenChangeCount;
+    m_seenChangeCount = changeCount;
+    return changed || m_slidesModel->hasLayersToUpdate();
 }
@@ -10,7 +10,8 @@
 
 #include <QOpenGLFunctions>
 #include <QtQuick/QQuickItem>
-#include <QTimer>
+#include <QPointer>
+#include "previewscheduler.h"
 
 class QQuickRenderControl;
 class QQuickWindow;
@@ -51,9 +52,13 @@ Q_SIGNALS:
 private:
     Q_INVOKABLE void handleWindowChanged(QQuickWindow *win);
     void releaseResources() override;
+    bool layersNeedUpdate();
 
     QQuickWindow* m_parentWindow = nullptr;
     SlidesQtItemRenderer *m_renderer = nullptr;
+    SlidesModel* m_slidesModel = nullptr;
+    QPointer<PreviewScheduler> m_scheduler;
+    uint64_t m_seenChangeCount = 0;
 };
 
 #endif // SLIDESQTITEM_H
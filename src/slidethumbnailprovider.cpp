@@ -0,0 +1,314 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "slidethumbnailprovider.h"
+#include "layersmodel.h"
+#ifdef PDF_SUPPORT
+#include <layers/pdflayer.h>
+#include <cpp/poppler-page.h>
+#include <cpp/poppler-page-renderer.h>
+#endif
+#include <layers/textlayer.h>
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QPainter>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+#include <memory>
+
+// Bump when render() changes, so stale thumbnails on disk are not used
+static constexpr int ThumbnailVersion = 1;
+// Descriptions of slides no longer shown are dropped after this many new ones
+static constexpr int MaxRegisteredSlides = 2048;
+
+const QString SlideThumbnailProvider::Id = QStringLiteral("slidethumbnail");
+QMutex SlideThumbnailProvider::s_slidesMutex;
+QHash<QString, SlideThumbnailProvider::Slide> SlideThumbnailProvider::s_slides;
+QList<QString> SlideThumbnailProvider::s_slidesOrder;
+
+static QDataStream &operator<<(QDataStream &out, const SlideThumbnailProvider::Layer &l) {
+    out << l.type << l.title << l.filePath << l.fileSize << l.fileModified << l.stereoMode << l.roiEnabled << l.roi << l.page
+        << l.text << l.fontName << l.fontSize << l.alignment << l.color << l.textureSize;
+    return out;
+}
+
+class SlideThumbnailResponse : public QQuickImageResponse, public QRunnable {
+public:
+    SlideThumbnailResponse(const QString &hash, const QSize &requestedSize)
+        : m_hash(hash), m_requestedSize(requestedSize) {
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const override {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    void run() override {
+        const QString cacheFile = SlideThumbnailProvider::cacheFilePath(m_hash);
+        if (!m_image.load(cacheFile)) {
+            SlideThumbnailProvider::Slide slide;
+            if (SlideThumbnailProvider::slideForHash(m_hash, slide)) {
+                m_image = SlideThumbnailProvider::render(slide, QSize(SlideThumbnailProvider::ThumbnailWidth, SlideThumbnailProvider::ThumbnailHeight));
+                QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+                QSaveFile file(cacheFile);
+                if (file.open(QIODevice::WriteOnly) && m_image.save(&file, "PNG")) {
+                    file.commit();
+                }
+            }
+        }
+        if (!m_image.isNull() && m_requestedSize.isValid() && m_requestedSize != m_image.size()) {
+            m_image = m_image.scaled(m_requestedSize, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+        Q_EMIT finished();
+    }
+
+private:
+    QString m_hash;
+    QSize m_requestedSize;
+    QImage m_image;
+};
+
+SlideThumbnailProvider::SlideThumbnailProvider() {
+    m_pool.setMaxThreadCount(2);
+}
+
+SlideThumbnailProvider::~SlideThumbnailProvider() {
+    m_pool.waitForDone();
+}
+
+QString SlideThumbnailProvider::cacheFilePath(const QString &hash) {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/slidethumbnails/") + hash + QStringLiteral(".png");
+}
+
+bool SlideThumbnailProvider::slideForHash(const QString &hash, Slide &slide) {
+    QMutexLocker lock(&s_slidesMutex);
+    auto it = s_slides.constFind(hash);
+    if (it == s_slides.constEnd())
+        return false;
+    slide = it.value();
+    return true;
+}
+
+bool SlideThumbnailProvider::isRegistered(const QString &hash) {
+    QMutexLocker lock(&s_slidesMutex);
+    return s_slides.contains(hash);
+}
+
+QString SlideThumbnailProvider::registerSlide(LayersModel *lm) {
+    if (!lm)
+        return QString();
+
+    Slide slide;
+    for (int i = 0; i < lm->numberOfLayers(); i++) {
+        BaseLayer *layer = lm->layer(i);
+        if (!layer)
+            continue;
+        // Layers without picture do not change the thumbnail
+        if (layer->type() == BaseLayer::AUDIO || layer->type() == BaseLayer::CONTROL || layer->type() == BaseLayer::REST)
+            continue;
+
+        Layer l;
+        l.type = static_cast<int>(layer->type());
+        l.title = QString::fromStdString(layer->title());
+        l.filePath = QString::fromStdString(layer->filepath());
+        if (!l.filePath.isEmpty()) {
+            QFileInfo fileInfo(l.filePath);
+            if (fileInfo.exists()) {
+                l.fileSize = fileInfo.size();
+                l.fileModified = fileInfo.lastModified();
+            }
+        }
+        l.stereoMode = layer->stereoMode();
+        l.roiEnabled = layer->roiEnabled();
+        if (l.roiEnabled) {
+            const glm::vec4 &roi = layer->roi();
+            l.roi = QRectF(roi.x, roi.y, roi.z, roi.w);
+        }
+#ifdef PDF_SUPPORT
+        if (layer->type() == BaseLayer::PDF) {
+            l.page = static_cast<PdfLayer *>(layer)->page();
+        }
+#endif
+#ifdef TEXT_LAYER
+        if (layer->type() == BaseLayer::TEXT) {
+            TextLayer *textLayer = static_cast<TextLayer *>(layer);
+            l.text = QString::fromStdString(textLayer->text());
+            l.fontName = QString::fromStdString(textLayer->fontName());
+            l.fontSize = textLayer->fontSize();
+            l.alignment = QString::fromStdString(textLayer->alignmentStr());
+            l.color = QColor(QString::fromStdString(textLayer->colorHex()));
+            l.textureSize = QSize(textLayer->width(), textLayer->height());
+        }
+#endif
+        slide.append(l);
+    }
+    if (slide.isEmpty())
+        return QString();
+
+    QByteArray bytes;
+    {
+        QDataStream stream(&bytes, QIODevice::WriteOnly);
+        stream << ThumbnailVersion << static_cast<qint32>(slide.size());
+        for (const Layer &l : slide)
+            stream << l;
+    }
+    const QString hash = QString::fromLatin1(QCryptographicHash::hash(bytes, QCryptographicHash::Sha1).toHex());
+
+    QMutexLocker lock(&s_slidesMutex);
+    if (!s_slides.contains(hash)) {
+        s_slides.insert(hash, slide);
+        s_slidesOrder.append(hash);
+        while (s_slidesOrder.size() > MaxRegisteredSlides) {
+            s_slides.remove(s_slidesOrder.takeFirst());
+        }
+    }
+    return hash;
+}
+
+QQuickImageResponse *SlideThumbnailProvider::requestImageResponse(const QString &id, const QSize &requestedSize) {
+    auto *response = new SlideThumbnailResponse(id, requestedSize);
+    m_pool.start(response);
+    return response;
+}
+
+// Part of the source image shown by the layer: left or top eye and region of interest
+static QRect sourceRect(const SlideThumbnailProvider::Layer &l, const QSize &imageSize) {
+    QRectF r(0, 0, 1, 1);
+    if (l.stereoMode == BaseLayer::SBS_3D)
+        r.setWidth(0.5);
+    else if (l.stereoMode == BaseLayer::TB_3D || l.stereoMode == BaseLayer::TBF_3D)
+        r.setHeight(0.5);
+    if (l.roiEnabled) {
+        r = QRectF(r.x() + l.roi.x() * r.width(), r.y() + l.roi.y() * r.height(),
+                   l.roi.width() * r.width(), l.roi.height() * r.height());
+    }
+    return QRectF(r.x() * imageSize.width(), r.y() * imageSize.height(),
+                  r.width() * imageSize.width(), r.height() * imageSize.height()).toAlignedRect();
+}
+
+static QRect fitRect(const QSize &content, const QSize &canvas) {
+    QSize fitted = content.scaled(canvas, Qt::KeepAspectRatio);
+    return QRect(QPoint((canvas.width() - fitted.width()) / 2, (canvas.height() - fitted.height()) / 2), fitted);
+}
+
+static QImage loadImage(const SlideThumbnailProvider::Layer &l, const QSize &canvas) {
+    QImageReader reader(l.filePath);
+    reader.setAutoTransform(true);
+    QSize size = reader.size();
+    if (size.isValid()) {
+        // Decode at about twice the thumbnail size, before cropping the eye/roi
+        QSize target = size.scaled(canvas * 2, Qt::KeepAspectRatioByExpanding);
+        if (target.width() < size.width())
+            reader.setScaledSize(target);
+    }
+    return reader.read();
+}
+
+#ifdef PDF_SUPPORT
+static QImage loadPdfPage(const SlideThumbnailProvider::Layer &l) {
+    std::unique_ptr<poppler::document> doc(poppler::document::load_from_file(l.filePath.toStdString()));
+    if (!doc || doc->is_locked())
+        return QImage();
+    int page = std::clamp(l.page, 1, std::max(1, doc->pages()));
+    std::unique_ptr<poppler::page> p(doc->create_page(page - 1));
+    if (!p)
+        return QImage();
+    poppler::page_renderer renderer;
+    renderer.set_render_hint(poppler::page_renderer::antialiasing, true);
+    renderer.set_render_hint(poppler::page_renderer::text_antialiasing, true);
+    renderer.set_image_format(poppler::image::format_argb32);
+    poppler::image img = renderer.render_page(p.get(), 36.0, 36.0);
+    if (!img.is_valid())
+        return QImage();
+    return QImage(reinterpret_cast<const uchar *>(img.const_data()), img.width(), img.height(), img.bytes_per_row(), QImage::Format_ARGB32).copy();
+}
+#endif
+
+#ifdef TEXT_LAYER
+static void drawText(QPainter &painter, const SlideThumbnailProvider::Layer &l, const QSize &canvas) {
+    QSize textureSize = l.textureSize.isValid() ? l.textureSize : QSize(1280, 720);
+    QRect target = fitRect(textureSize, canvas);
+    const qreal scale = qreal(target.width()) / qreal(textureSize.width());
+
+    QFont font(l.fontName);
+    font.setPixelSize(std::max(1, qRound(l.fontSize * scale)));
+    painter.setFont(font);
+    painter.setPen(l.color);
+
+    Qt::Alignment alignment = Qt::AlignTop | Qt::AlignHCenter;
+    if (l.alignment == QStringLiteral("left")) {
+        alignment = Qt::AlignTop | Qt::AlignLeft;
+        // Same margin as the text layer
+        target.adjust(target.width() / 7, 0, 0, 0);
+    }
+    else if (l.alignment == QStringLiteral("right")) {
+        alignment = Qt::AlignTop | Qt::AlignRight;
+    }
+    painter.drawText(target, alignment, l.text);
+}
+#endif
+
+static void drawPlaceholder(QPainter &painter, const SlideThumbnailProvider::Layer &l, const QSize &canvas) {
+    QRect target = fitRect(QSize(16, 9), canvas).adjusted(8, 8, -8, -8);
+    painter.fillRect(target, QColor(48, 48, 48));
+    painter.setPen(QColor(200, 200, 200));
+    QFont font = painter.font();
+    font.setPixelSize(std::max(8, canvas.height() / 10));
+    painter.setFont(font);
+    QString label = QString::fromStdString(BaseLayer::typeDescription(static_cast<BaseLayer::LayerType>(l.type)));
+    if (!l.title.isEmpty())
+        label += QStringLiteral("\n") + l.title;
+    painter.drawText(target, Qt::AlignCenter | Qt::TextWordWrap, label);
+}
+
+QImage SlideThumbnailProvider::render(const Slide &slide, const QSize &size) {
+    QImage canvas(size, QImage::Format_ARGB32_Premultiplied);
+    canvas.fill(Qt::black);
+
+    QPainter painter(&canvas);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+
+    // First layer is on top, so draw from the back
+    for (qsizetype i = slide.size() - 1; i >= 0; i--) {
+        const Layer &l = slide[i];
+        QImage image;
+        switch (l.type) {
+        case BaseLayer::IMAGE:
+            image = loadImage(l, size);
+            break;
+#ifdef PDF_SUPPORT
+        case BaseLayer::PDF:
+            image = loadPdfPage(l);
+            break;
+#endif
+#ifdef TEXT_LAYER
+        case BaseLayer::TEXT:
+            drawText(painter, l, size);
+            continue;
+#endif
+        default:
+            break;
+        }
+
+        if (image.isNull()) {
+            drawPlaceholder(painter, l, size);
+            continue;
+        }
+        QRect source = sourceRect(l, image.size());
+        painter.drawImage(fitRect(source.size(), size), image, source);
+    }
+    painter.end();
+    return canvas;
+}
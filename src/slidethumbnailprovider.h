@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef SLIDETHUMBNAILPROVIDER_H
+#define SLIDETHUMBNAILPROVIDER_H
+
+#include <QColor>
+#include <QDateTime>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QQuickAsyncImageProvider>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+class LayersModel;
+
+// Thumbnails of the slides, served as image://slidethumbnail/<hash>.
+//
+// The hash covers the layer set of a slide and the properties that change how
+// it looks, so the image source of a slide only changes when its content does.
+// Thumbnails are drawn once on a worker thread from the layer sources (no layer
+// is loaded or rendered), and cached on disk by hash. The QML pixmap cache keeps
+// the uploaded textures, and the scene graph packs these small images into its
+// shared texture atlas, so scrolling the slide list does no work at all.
+class SlideThumbnailProvider : public QQuickAsyncImageProvider {
+public:
+    // Properties of a layer that are drawn in the thumbnail
+    struct Layer {
+        int type = 0;
+        QString title;
+        QString filePath;
+        // So a replaced file at the same path gets a new thumbnail
+        qint64 fileSize = 0;
+        QDateTime fileModified;
+        int stereoMode = 0;
+        bool roiEnabled = false;
+        QRectF roi = QRectF(0, 0, 1, 1);
+        int page = 0;
+        QString text;
+        QString fontName;
+        int fontSize = 0;
+        QString alignment;
+        QColor color = Qt::white;
+        QSize textureSize;
+    };
+    using Slide = QList<Layer>;
+
+    static const QString Id;
+    static constexpr int ThumbnailWidth = 256;
+    static constexpr int ThumbnailHeight = 144;
+
+    SlideThumbnailProvider();
+    ~SlideThumbnailProvider() override;
+
+    // Content hash of the slide, empty when it has no layers. The description is
+    // kept for the provider, which never touches the models from its threads.
+    static QString registerSlide(LayersModel *lm);
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    static QImage render(const Slide &slide, const QSize &size);
+    static QString cacheFilePath(const QString &hash);
+    static bool slideForHash(const QString &hash, Slide &slide);
+    static bool isRegistered(const QString &hash);
+
+private:
+    QThreadPool m_pool;
+
+    static QMutex s_slidesMutex;
+    static QHash<QString, Slide> s_slides;
+    static QList<QString> s_slidesOrder;
+};
+
+#endif // SLIDETHUMBNAILPROVIDER_H
@@ -99,58 +99,26 @@ int TracksModel::countTracks() const {
     }
 }
 
-std::string TracksModel::getListAsFormattedString(std::string removePrefix, int charsPerItem) const {
+std::vector<std::string> TracksModel::getShortTitles() const {
+    std::vector<std::string> titles;
     if (m_tracks == nullptr)
-        return "";
-
-    std::string fullItemList = "";
-    for (int i = 0; i < m_tracks->size(); i++) {
-        std::string title = "";
+        return titles;
 
+    for (const Track &track : *m_tracks) {
         QString shortText;
-        if (!m_tracks->at(i).lang().empty()) {
-            shortText = QString::fromStdString(m_tracks->at(i).lang());
+        if (!track.lang().empty()) {
+            shortText = QString::fromStdString(track.lang());
         }
-        else if (!m_tracks->at(i).title().empty()) {
-            std::filesystem::path titlePath = std::filesystem::path(m_tracks->at(i).title());
+        else if (!track.title().empty()) {
+            std::filesystem::path titlePath = std::filesystem::path(track.title());
             if (titlePath.has_extension()) {
                 shortText = QString::fromStdString(titlePath.stem().string());
             }
             else {
-                shortText = QString::fromStdString(m_tracks->at(i).title());
-            }
-        }
-        title += shortText.toStdString();
-
-        if (!removePrefix.empty()) {
-            int mc = 0;
-            const int prefixLen = static_cast<int>(removePrefix.length());
-            const int titleLen = static_cast<int>(title.length());
-            const int maxLen = std::min(prefixLen, titleLen);
-            for (int c = 0; c < maxLen; c++) {
-                if (removePrefix[c] == title[c])
-                    mc++;
-                else
-                    break;
-            }
-            if (mc > 0) {
-                title.erase(0, mc);
+                shortText = QString::fromStdString(track.title());
             }
         }
-        std::replace(title.begin(), title.end(), '_', ' ');
-
-        size_t countChars = title.size();
-        if (countChars < static_cast<size_t>(charsPerItem)) {
-            title.insert(title.end(), charsPerItem - countChars, ' ');
-        } else if (charsPerItem > 4 && countChars >= static_cast<size_t>(charsPerItem)) {
-            title.erase(title.end() - (countChars - charsPerItem + 4), title.end());
-            title.insert(title.end(), 3, '.');
-            title.insert(title.end(), 1, ' ');
-        }
-        std::string itemText = title;
-        fullItemList += itemText;
-        if (i < m_tracks->size() - 1)
-            fullItemList += "\n";
+        titles.push_back(shortText.toStdString());
     }
-    return fullItemList;
+    return titles;
 }
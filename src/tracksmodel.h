@@ -11,6 +11,7 @@
 
 #include <QAbstractListModel>
 #include <QObject>
+#include <string>
 #include <vector>
 #include <QtQml/qqmlregistration.h>
 
@@ -33,7 +34,8 @@ public:
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     virtual QHash<int, QByteArray> roleNames() const override;
-    std::string getListAsFormattedString(std::string removePrefix = "", int charsPerItem = 40) const;
+    // Language, or title without extension, of each track
+    std::vector<std::string> getShortTitles() const;
 
     Q_INVOKABLE void setTracks(std::vector<Track>* tracks);
     Q_INVOKABLE int countTracks() const;
@@ -6,15 +6,18 @@
  */
 
 #include <utils/domegrid.h>
+#include <utils/meshlod.h>
 
 #include <sgct/log.h>
 #include <sgct/opengl.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
 
-DomeGrid::DomeGrid(float r, float FOV, unsigned int azimuthSteps, unsigned int elevationSteps)
-    : _elevationSteps(elevationSteps)
-    , _azimuthSteps(azimuthSteps)
-{
+namespace {
     struct VertexData {
         float s = 0.f;
         float t = 0.f;  // Texcoord0 -> size=8
@@ -25,22 +28,36 @@ DomeGrid::DomeGrid(float r, float FOV, unsigned int azimuthSteps, unsigned int e
         float y = 0.f;
         float z = 0.f;  // size=12 ; total size=32 = power of two
     };
+}
 
-    if (_azimuthSteps < 4) {
-        sgct::Log::Warning("Azimuth steps must be higher than 4");
-    }
-    if (_elevationSteps < 4)  {
-        sgct::Log::Warning("Elevation steps must be higher than 4");
+struct DomeGrid::Geometry {
+    std::vector<VertexData> verts;
+    std::vector<unsigned int> indices;
+    // Offset and count in indices for each level of detail
+    std::vector<std::pair<unsigned int, unsigned int>> levels;
+};
+
+std::shared_ptr<const DomeGrid::Geometry> DomeGrid::geometry(float r, float FOV, int azimuthSteps, int elevationSteps) {
+    static std::mutex cacheMutex;
+    static std::map<std::tuple<float, float, int, int>, std::weak_ptr<const Geometry>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    const auto key = std::make_tuple(r, FOV, azimuthSteps, elevationSteps);
+    if (auto existing = cache[key].lock()) {
+        return existing;
     }
+    std::erase_if(cache, [](const auto &entry) { return entry.second.expired(); });
 
-    // Create VAO
-    const float lift = (180.f - FOV) / 2.f;
+    auto geometry = std::make_shared<Geometry>();
+    std::vector<VertexData> &verts = geometry->verts;
+    std::vector<unsigned int> &indices = geometry->indices;
 
-    std::vector<VertexData> verts;
-    std::vector<unsigned int> indices;
+    // Rings from the lift (e = 0) up to the last ring below the cap
+    // (e = elevationSteps - 1), azimuthSteps vertices each, then the cap vertex.
+    const float lift = (180.f - FOV) / 2.f;
 
-    for (int a = 0; a < _azimuthSteps; a++) {
-        const float azimuth = glm::radians((a * 360.f) / _azimuthSteps);
+    for (int a = 0; a < azimuthSteps; a++) {
+        const float azimuth = glm::radians((a * 360.f) / azimuthSteps);
 
         const float elevation = glm::radians(lift);
         const float x = cos(elevation) * sin(azimuth);
@@ -52,48 +69,83 @@ DomeGrid::DomeGrid(float r, float FOV, unsigned int azimuthSteps, unsigned int e
         verts.push_back({ s, t,  x, y, z,  x * r, y * r, z * r });
     }
 
-    int numVerts = 0;
-    for (int e = 1; e <= _elevationSteps - 1; e++) {
-        const float de = static_cast<float>(e) / static_cast<float>(_elevationSteps);
+    for (int e = 1; e <= elevationSteps - 1; e++) {
+        const float de = static_cast<float>(e) / static_cast<float>(elevationSteps);
         const float elevation = glm::radians(lift + de * (90.f - lift));
 
         const float y = sin(elevation);
 
-        for (int a = 0; a < _azimuthSteps; a++) {
-            const float azimuth = glm::radians((a * 360.f) / _azimuthSteps);
+        for (int a = 0; a < azimuthSteps; a++) {
+            const float azimuth = glm::radians((a * 360.f) / azimuthSteps);
 
             const float x = cos(elevation) * sin(azimuth);
             const float z = -cos(elevation) * cos(azimuth);
 
-            float s = (static_cast<float>(_elevationSteps - e) /
-                       static_cast<float>(_elevationSteps))* sin(azimuth);
-            float t = (static_cast<float>(_elevationSteps - e) /
-                       static_cast<float>(_elevationSteps)) * -cos(azimuth);
+            float s = (static_cast<float>(elevationSteps - e) /
+                       static_cast<float>(elevationSteps))* sin(azimuth);
+            float t = (static_cast<float>(elevationSteps - e) /
+                       static_cast<float>(elevationSteps)) * -cos(azimuth);
             s = s * 0.5f + 0.5f;
             t = t * 0.5f + 0.5f;
 
             verts.push_back({ s, t,  x, y, z,  x * r, y * r, z * r });
+        }
+    }
+
+    verts.push_back({ 0.5f, 0.5f,  0.f, 1.f, 0.f,  0.f, r, 0.f });
+
+    const unsigned int cap = static_cast<unsigned int>(elevationSteps * azimuthSteps);
+    auto vertex = [azimuthSteps](int e, int a) {
+        return static_cast<unsigned int>(e * azimuthSteps + (a % azimuthSteps));
+    };
+
+    // Every level uses every step:th ring and azimuth of the full grid, so all
+    // levels share the vertices. Same winding as the former strips and fan.
+    for (int step = 1; azimuthSteps % step == 0 && elevationSteps % step == 0; step *= 2) {
+        if (step > 1 && (azimuthSteps / step < 16 || elevationSteps / step < 8)) {
+            break;
+        }
 
-            indices.push_back(numVerts);
-            indices.push_back(_azimuthSteps + numVerts);
-            ++numVerts;
+        const unsigned int offset = static_cast<unsigned int>(indices.size());
+        for (int e = 0; e + step < elevationSteps; e += step) {
+            for (int a = 0; a < azimuthSteps; a += step) {
+                indices.push_back(vertex(e, a));
+                indices.push_back(vertex(e + step, a));
+                indices.push_back(vertex(e, a + step));
+
+                indices.push_back(vertex(e, a + step));
+                indices.push_back(vertex(e + step, a));
+                indices.push_back(vertex(e + step, a + step));
+            }
         }
 
-        indices.push_back(numVerts - _azimuthSteps);
-        indices.push_back(numVerts);
+        const int last = elevationSteps - step;
+        for (int a = 0; a < azimuthSteps; a += step) {
+            indices.push_back(cap);
+            indices.push_back(vertex(last, a + step));
+            indices.push_back(vertex(last, a));
+        }
+
+        geometry->levels.emplace_back(offset, static_cast<unsigned int>(indices.size()) - offset);
     }
 
-    const int e = _elevationSteps;
-    const float de = static_cast<float>(e) / static_cast<float>(_elevationSteps);
-    const float elevation = glm::radians(lift + de * (90.f - lift));
-    const float y = sin(elevation);
-    verts.push_back({ 0.5f, 0.5f,  0.f, 1.f, 0.f,  0.f, y * r, 0.f });
+    cache[key] = geometry;
+    return geometry;
+}
 
-    indices.push_back(numVerts + _azimuthSteps);
-    for (int a = 1; a <= _azimuthSteps; a++) {
-        indices.push_back(numVerts + _azimuthSteps - a);
+DomeGrid::DomeGrid(float r, float FOV, unsigned int azimuthSteps, unsigned int elevationSteps)
+    : _elevationSteps(elevationSteps)
+    , _azimuthSteps(azimuthSteps)
+    , _radius(r)
+{
+    if (_azimuthSteps < 4) {
+        sgct::Log::Warning("Azimuth steps must be higher than 4");
+    }
+    if (_elevationSteps < 4)  {
+        sgct::Log::Warning("Elevation steps must be higher than 4");
     }
-    indices.push_back(numVerts + _azimuthSteps - 1);
+
+    _geometry = geometry(r, FOV, _azimuthSteps, _elevationSteps);
 
     glGenVertexArrays(1, &_vao);
     glBindVertexArray(_vao);
@@ -101,7 +153,7 @@ DomeGrid::DomeGrid(float r, float FOV, unsigned int azimuthSteps, unsigned int e
     glGenBuffers(1, &_vbo);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
     const GLsizei size = sizeof(VertexData);
-    glBufferData(GL_ARRAY_BUFFER, verts.size() * size, verts.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, _geometry->verts.size() * size, _geometry->verts.data(), GL_STATIC_DRAW);
 
     // texcoords
     glEnableVertexAttribArray(0);
@@ -117,8 +169,8 @@ DomeGrid::DomeGrid(float r, float FOV, unsigned int azimuthSteps, unsigned int e
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
     glBufferData(
         GL_ELEMENT_ARRAY_BUFFER,
-        indices.size() * sizeof(unsigned int),
-        indices.data(),
+        _geometry->indices.size() * sizeof(unsigned int),
+        _geometry->indices.data(),
         GL_STATIC_DRAW
     );
 
@@ -131,28 +183,28 @@ DomeGrid::~DomeGrid() {
     glDeleteVertexArrays(1, &_vao);
 }
 
-void DomeGrid::draw() {
-    glBindVertexArray(_vao);
-
-    for (int i = 0; i < _elevationSteps - 1; i++) {
-        const unsigned int size = (2 * _azimuthSteps + 2);
-        const unsigned int offset = i * size;
-        glDrawElements(
-            GL_TRIANGLE_STRIP,
-            size,
-            GL_UNSIGNED_INT,
-            reinterpret_cast<void*>(offset * sizeof(unsigned int))
-        );
+void DomeGrid::draw(unsigned int level, int instances) {
+    if (_geometry->levels.empty()) {
+        return;
     }
+    const auto &[offset, count] = _geometry->levels[std::min<size_t>(level, _geometry->levels.size() - 1)];
+    const void *indices = reinterpret_cast<void*>(offset * sizeof(unsigned int));
 
-    // one extra for the cap vertex and one extra for duplication of last index
-    const unsigned int size = _azimuthSteps + 2;
-    const unsigned int offset = (2 * _azimuthSteps + 2) * (_elevationSteps - 1);
-    glDrawElements(
-        GL_TRIANGLE_FAN,
-        size,
-        GL_UNSIGNED_INT,
-        reinterpret_cast<void*>(offset * sizeof(unsigned int))
-    );
+    glBindVertexArray(_vao);
+    if (instances > 1) {
+        glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_INT, indices, instances);
+    }
+    else {
+        glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, indices);
+    }
     glBindVertexArray(0);
 }
+
+unsigned int DomeGrid::levels() const {
+    return static_cast<unsigned int>(_geometry->levels.size());
+}
+
+unsigned int DomeGrid::levelFor(float distance, float projectionScale, float viewportHeight) const {
+    const float segmentAngle = glm::two_pi<float>() / static_cast<float>(std::max(_azimuthSteps, 1));
+    return meshLodLevel(_radius, segmentAngle, distance, projectionScale, viewportHeight, levels());
+}
@@ -8,8 +8,13 @@
 #ifndef __DOMEGRID__H__
 #define __DOMEGRID__H__
 
+#include <memory>
+
 /**
  * Helper class to render a dome grid.
+ * Each level of detail is drawn with a single indexed triangle list. The
+ * geometry is shared between all grids with the same parameters, so the
+ * cluster renderer and the preview only upload their own GPU copies.
  */
 class DomeGrid {
 public:
@@ -23,11 +28,29 @@ public:
      */
     ~DomeGrid();
 
-    void draw();
+    /**
+     * Level 0 is the full grid, each following level halves the steps.
+     * More than one instance is drawn with glDrawElementsInstanced.
+     */
+    void draw(unsigned int level = 0, int instances = 1);
+
+    unsigned int levels() const;
+
+    /**
+     * Coarsest level that still looks smooth from distance (camera to dome
+     * centre), with projectionScale = projection[1][1].
+     */
+    unsigned int levelFor(float distance, float projectionScale, float viewportHeight) const;
 
 private:
+    struct Geometry;
+    static std::shared_ptr<const Geometry> geometry(float r, float FOV, int azimuthSteps, int elevationSteps);
+
     const int _elevationSteps;
     const int _azimuthSteps;
+    const float _radius;
+
+    std::shared_ptr<const Geometry> _geometry;
 
     unsigned int _vao = 0;
     unsigned int _vbo = 0;
@@ -0,0 +1,306 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <utils/frameprofiler.h>
+#include <layers/baselayer.h>
+
+#include <sgct/opengl.h>
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <fstream>
+
+namespace {
+    // Key of phases that do not belong to a layer
+    constexpr uint32_t NoLayer = UINT32_MAX;
+    // Trace thread of the GPU events
+    constexpr uint32_t GpuThread = 1000;
+
+    std::string jsonEscape(std::string_view s) {
+        std::string out;
+        out.reserve(s.size());
+        for (char c : s) {
+            switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                    out += std::format("\\u{:04x}", static_cast<int>(c));
+                else
+                    out += c;
+            }
+        }
+        return out;
+    }
+}
+
+std::atomic_bool FrameProfiler::s_enabled = false;
+
+void FrameProfiler::Histogram::add(double ms) {
+    size_t b = 0;
+    while (b < BucketBoundsMs.size() && ms > BucketBoundsMs[b])
+        b++;
+    buckets[b]++;
+    count++;
+    sumMs += ms;
+    maxMs = std::max(maxMs, ms);
+    avgMs = (count == 1) ? ms : avgMs + (ms - avgMs) * 0.05;
+}
+
+double FrameProfiler::Histogram::percentileMs(double p) const {
+    if (count == 0)
+        return 0.0;
+    uint64_t target = static_cast<uint64_t>(std::ceil(p * static_cast<double>(count)));
+    uint64_t sum = 0;
+    for (size_t b = 0; b < BucketBoundsMs.size(); b++) {
+        sum += buckets[b];
+        if (sum >= target)
+            return BucketBoundsMs[b];
+    }
+    return maxMs;
+}
+
+FrameProfiler &FrameProfiler::instance() {
+    static FrameProfiler profiler;
+    return profiler;
+}
+
+void FrameProfiler::setEnabled(bool enabled) {
+    if (enabled == FrameProfiler::enabled())
+        return;
+
+    if (enabled) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.clear();
+        m_events.clear();
+        m_nextEvent = 0;
+        m_frameStartUs = -1;
+    }
+    s_enabled = enabled;
+}
+
+void FrameProfiler::initializeGL() {
+    m_glThread = std::this_thread::get_id();
+}
+
+void FrameProfiler::cleanupGL() {
+    if (std::this_thread::get_id() != m_glThread)
+        return;
+
+    for (const PendingQuery &p : m_pendingQueries)
+        m_freeQueries.push_back(p.query);
+    m_pendingQueries.clear();
+    if (!m_freeQueries.empty())
+        glDeleteQueries(static_cast<GLsizei>(m_freeQueries.size()), m_freeQueries.data());
+    m_freeQueries.clear();
+    m_glThread = std::thread::id();
+}
+
+void FrameProfiler::newFrame() {
+    // Queries issued before a disable are still read, to recycle them
+    if (!m_pendingQueries.empty() && std::this_thread::get_id() == m_glThread)
+        readQueries();
+
+    if (!enabled())
+        return;
+
+    int64_t now = nowUs();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_frameStartUs >= 0) {
+        Key key("frame", NoLayer);
+        Stat &stat = m_stats[key];
+        if (stat.label.empty())
+            stat.label = "frame";
+        stat.cpu.add(static_cast<double>(now - m_frameStartUs) / 1000.0);
+        addEvent({key, m_frameStartUs, now - m_frameStartUs, threadIndex(std::this_thread::get_id()), false});
+    }
+    m_frameStartUs = now;
+}
+
+void FrameProfiler::begin(Scope &scope, const char *name, const BaseLayer *layer, bool gpu) {
+    scope.m_active = true;
+    scope.m_name = name;
+    scope.m_layerId = layer ? layer->identifier() : NoLayer;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Stat &stat = m_stats[Key(name, scope.m_layerId)];
+        if (stat.label.empty()) {
+            if (layer)
+                stat.label = std::format("{} {} #{} {}", name, BaseLayer::typeDescription(layer->type()), layer->identifier(), layer->title());
+            else
+                stat.label = name;
+        }
+    }
+
+    // Elapsed time queries can not nest, inner GPU scopes are CPU only
+    if (gpu && !m_gpuScopeActive && std::this_thread::get_id() == m_glThread) {
+        if (m_freeQueries.empty()) {
+            unsigned int query = 0;
+            glGenQueries(1, &query);
+            m_freeQueries.push_back(query);
+        }
+        scope.m_query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+        glBeginQuery(GL_TIME_ELAPSED, scope.m_query);
+        m_gpuScopeActive = true;
+    }
+
+    scope.m_startUs = nowUs();
+}
+
+void FrameProfiler::end(Scope &scope) {
+    int64_t duration = nowUs() - scope.m_startUs;
+    Key key(scope.m_name, scope.m_layerId);
+    if (scope.m_sink)
+        scope.m_sink(static_cast<double>(duration) / 1000.0);
+
+    if (scope.m_query != 0) {
+        glEndQuery(GL_TIME_ELAPSED);
+        m_pendingQueries.push_back({scope.m_query, key, scope.m_startUs});
+        m_gpuScopeActive = false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_stats.find(key);
+    if (it != m_stats.end())
+        it->second.cpu.add(static_cast<double>(duration) / 1000.0);
+    addEvent({key, scope.m_startUs, duration, threadIndex(std::this_thread::get_id()), false});
+}
+
+void FrameProfiler::readQueries() {
+    size_t done = 0;
+    for (; done < m_pendingQueries.size(); done++) {
+        const PendingQuery &p = m_pendingQueries[done];
+        // Queries finish in order, stop at the first one still running
+        GLint available = 0;
+        glGetQueryObjectiv(p.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(p.query, GL_QUERY_RESULT, &elapsedNs);
+        m_freeQueries.push_back(p.query);
+
+        if (!enabled())
+            continue;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_stats.find(p.key);
+        if (it == m_stats.end())
+            continue;
+        it->second.gpu.add(static_cast<double>(elapsedNs) / 1.0e6);
+        // Placed at the CPU submission, the GPU runs it somewhat later
+        addEvent({p.key, p.startUs, static_cast<int64_t>(elapsedNs / 1000), GpuThread, true});
+    }
+    m_pendingQueries.erase(m_pendingQueries.begin(), m_pendingQueries.begin() + static_cast<std::ptrdiff_t>(done));
+}
+
+int64_t FrameProfiler::nowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+}
+
+uint32_t FrameProfiler::threadIndex(std::thread::id id) {
+    auto it = std::find(m_threads.begin(), m_threads.end(), id);
+    if (it != m_threads.end())
+        return static_cast<uint32_t>(std::distance(m_threads.begin(), it));
+    m_threads.push_back(id);
+    return static_cast<uint32_t>(m_threads.size() - 1);
+}
+
+void FrameProfiler::addEvent(const TraceEvent &event) {
+    if (m_events.size() < MaxTraceEvents) {
+        m_events.push_back(event);
+    }
+    else {
+        m_events[m_nextEvent] = event;
+        m_nextEvent = (m_nextEvent + 1) % MaxTraceEvents;
+    }
+}
+
+std::string FrameProfiler::overlayText(size_t maxLayers) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<const Stat *> phases;
+    std::vector<const Stat *> layers;
+    for (const auto &[key, stat] : m_stats) {
+        if (stat.cpu.count == 0)
+            continue;
+        if (key.second == NoLayer)
+            phases.push_back(&stat);
+        else
+            layers.push_back(&stat);
+    }
+    std::sort(layers.begin(), layers.end(), [](const Stat *a, const Stat *b) {
+        return a->cpu.avgMs > b->cpu.avgMs;
+    });
+    if (layers.size() > maxLayers)
+        layers.resize(maxLayers);
+
+    auto line = [](const Stat &s) {
+        std::string label = s.label.substr(0, 40);
+        std::string gpu = s.gpu.count > 0 ? std::format("{:7.2f}", s.gpu.avgMs) : std::string("      -");
+        return std::format("{:<40} {:7.2f} {:7.2f} {:7.2f} {}\n", label, s.cpu.avgMs, s.cpu.percentileMs(0.95), s.cpu.maxMs, gpu);
+    };
+
+    std::string text = std::format("{:<40} {:>7} {:>7} {:>7} {:>7}\n", "ms", "cpu avg", "p95", "max", "gpu avg");
+    for (const Stat *s : phases)
+        text += line(*s);
+    if (!layers.empty())
+        text += "\n";
+    for (const Stat *s : layers)
+        text += line(*s);
+    return text;
+}
+
+bool FrameProfiler::writeChromeTrace(const std::string &path) {
+    // Copy the events, so the scopes are not blocked while the file is written
+    std::vector<TraceEvent> events;
+    std::map<Key, std::string> labels;
+    size_t numThreads = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Oldest first, the buffer wraps around when full
+        size_t start = (m_events.size() < MaxTraceEvents) ? 0 : m_nextEvent;
+        events.reserve(m_events.size());
+        for (size_t i = 0; i < m_events.size(); i++)
+            events.push_back(m_events[(start + i) % m_events.size()]);
+        for (const auto &[key, stat] : m_stats)
+            labels.emplace(key, stat.label);
+        numThreads = m_threads.size();
+    }
+
+    std::ofstream out(path, std::ofstream::out | std::ofstream::trunc);
+    if (!out.is_open())
+        return false;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    auto separator = [&out, &first]() {
+        if (!first)
+            out << ",\n";
+        first = false;
+    };
+
+    for (size_t t = 0; t < numThreads; t++) {
+        separator();
+        out << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"CPU {}\"}}}}", t, t);
+    }
+    separator();
+    out << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"GPU\"}}}}", GpuThread);
+
+    for (const TraceEvent &e : events) {
+        auto it = labels.find(e.key);
+        std::string name = (it != labels.end()) ? jsonEscape(it->second) : jsonEscape(e.key.first);
+        separator();
+        out << std::format("{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{},\"dur\":{},\"pid\":0,\"tid\":{}}}",
+                           name, e.gpu ? "gpu" : "cpu", e.startUs, e.durationUs, e.thread);
+    }
+    out << "]}\n";
+    return out.good();
+}
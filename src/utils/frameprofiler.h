@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class BaseLayer;
+
+/**
+ * Frame-time profiler for the sync callbacks, the layers and the renderer.
+ *
+ * Code is instrumented with FrameProfiler::Scope objects, which record CPU
+ * time and, for scopes marked as GPU scopes on the OpenGL thread of a node, a
+ * GL_TIME_ELAPSED query. Query results are read back a few frames later, so
+ * the pipeline never stalls. Scopes aggregate into a histogram per phase, or
+ * per phase and layer, and are kept as events for a Chrome trace
+ * (chrome://tracing or ui.perfetto.dev).
+ *
+ * When disabled, a scope only reads one atomic flag.
+ */
+class FrameProfiler {
+public:
+    // Bucket upper bounds in ms, last bucket is everything above
+    static constexpr std::array<double, 11> BucketBoundsMs = {0.05, 0.1, 0.25, 0.5, 1, 2, 4, 8, 16, 33, 66};
+    // Trace events kept, older are overwritten
+    static constexpr size_t MaxTraceEvents = 1 << 18;
+
+    struct Histogram {
+        std::array<uint32_t, BucketBoundsMs.size() + 1> buckets = {};
+        uint64_t count = 0;
+        double sumMs = 0.0;
+        double maxMs = 0.0;
+        double avgMs = 0.0; // Moving average, follows recent frames
+
+        void add(double ms);
+        // Upper bound of the bucket holding the p-th percentile (0-1)
+        double percentileMs(double p) const;
+    };
+
+    struct Stat {
+        std::string label;
+        Histogram cpu;
+        Histogram gpu;
+    };
+
+    class Scope {
+    public:
+        // Gets the CPU time of the scope, also when the profiler is off
+        using Sink = void (*)(double ms);
+
+        explicit Scope(const char *name, bool gpu = false) {
+            if (FrameProfiler::enabled())
+                FrameProfiler::instance().begin(*this, name, nullptr, gpu);
+        }
+        Scope(const char *name, const BaseLayer *layer, bool gpu = false) {
+            if (FrameProfiler::enabled())
+                FrameProfiler::instance().begin(*this, name, layer, gpu);
+        }
+        Scope(const char *name, Sink sink) : m_sink(sink) {
+            if (FrameProfiler::enabled())
+                FrameProfiler::instance().begin(*this, name, nullptr, false);
+            else if (m_sink)
+                m_startUs = FrameProfiler::instance().nowUs();
+        }
+        ~Scope() {
+            if (m_active)
+                FrameProfiler::instance().end(*this);
+            else if (m_sink)
+                m_sink(static_cast<double>(FrameProfiler::instance().nowUs() - m_startUs) / 1000.0);
+        }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        friend class FrameProfiler;
+        bool m_active = false;
+        const char *m_name = nullptr;
+        uint32_t m_layerId = 0;
+        unsigned int m_query = 0;
+        int64_t m_startUs = 0;
+        Sink m_sink = nullptr;
+    };
+
+    static FrameProfiler &instance();
+
+    static bool enabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    // Clears the collected data when turned on
+    void setEnabled(bool enabled);
+
+    // GPU scopes are only timed on this thread, which must have a current context
+    void initializeGL();
+    void cleanupGL();
+
+    // Frame boundary: times the frame and reads back finished GPU queries
+    void newFrame();
+
+    // Phases first, then layers sorted by CPU time, as monospace text lines
+    std::string overlayText(size_t maxLayers = 12);
+    bool writeChromeTrace(const std::string &path);
+
+private:
+    FrameProfiler() = default;
+
+    using Key = std::pair<std::string_view, uint32_t>;
+
+    struct TraceEvent {
+        Key key;
+        int64_t startUs = 0;
+        int64_t durationUs = 0;
+        uint32_t thread = 0;
+        bool gpu = false;
+    };
+
+    struct PendingQuery {
+        unsigned int query = 0;
+        Key key;
+        int64_t startUs = 0;
+    };
+
+    void begin(Scope &scope, const char *name, const BaseLayer *layer, bool gpu);
+    void end(Scope &scope);
+    int64_t nowUs() const;
+    uint32_t threadIndex(std::thread::id id);
+    void addEvent(const TraceEvent &event);
+    void readQueries();
+
+    static std::atomic_bool s_enabled;
+
+    std::mutex m_mutex;
+    std::chrono::steady_clock::time_point m_epoch = std::chrono::steady_clock::now();
+    std::map<Key, Stat> m_stats;
+    std::vector<TraceEvent> m_events;
+    size_t m_nextEvent = 0;
+    std::vector<std::thread::id> m_threads;
+    int64_t m_frameStartUs = -1;
+
+    // Only touched on the GL thread
+    std::thread::id m_glThread;
+    bool m_gpuScopeActive = false;
+    std::vector<unsigned int> m_freeQueries;
+    std::vector<PendingQuery> m_pendingQueries;
+};
+
+#endif // FRAMEPROFILER_H
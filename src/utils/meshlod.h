@@ -0,0 +1,43 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef __MESHLOD__H__
+#define __MESHLOD__H__
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Level of detail for a spherical grid, where each level halves the number of
+ * segments. Returns the coarsest of levels whose segments stay within
+ * maxPixels on screen.
+ *
+ * radius:          radius of the mesh
+ * segmentAngle:    angle (radians) of one segment at level 0
+ * distance:        distance from the camera to the centre of the mesh
+ * projectionScale: projection[1][1], i.e. 1 / tan(fovY / 2)
+ * viewportHeight:  height of the viewport in pixels
+ */
+inline unsigned int meshLodLevel(float radius, float segmentAngle, float distance,
+                                 float projectionScale, float viewportHeight,
+                                 unsigned int levels, float maxPixels = 16.f) {
+    if (levels <= 1 || radius <= 0.f || viewportHeight <= 0.f)
+        return 0;
+
+    // Closest part of the mesh seen from the camera, inside or outside
+    const float nearest = std::max(std::abs(radius - distance), 0.05f * radius);
+    float pixels = (radius * segmentAngle / nearest) * projectionScale * 0.5f * viewportHeight;
+
+    unsigned int level = 0;
+    while (level + 1 < levels && pixels * 2.f <= maxPixels) {
+        pixels *= 2.f;
+        level++;
+    }
+    return level;
+}
+
+#endif // __MESHLOD__H__
@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "pathresolver.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QThread>
+
+// Stay well below the default inotify watch limit. Results that would need
+// more directories watched are simply not cached.
+static const int MaxWatchedDirectories = 4096;
+
+std::mutex PathResolver::s_instanceMutex;
+PathResolver* PathResolver::_instance = nullptr;
+
+static QString nearestExistingDir(const QString &path) {
+    QString dir = path;
+    while (!dir.isEmpty() && !QFileInfo::exists(dir)) {
+        QString parent = QFileInfo(dir).absolutePath();
+        if (parent == dir)
+            return QStringLiteral("");
+        dir = parent;
+    }
+    return dir;
+}
+
+PathResolver::PathResolver() {
+    m_watcher = new QFileSystemWatcher();
+    if (QCoreApplication::instance() && QCoreApplication::instance()->thread() != QThread::currentThread())
+        m_watcher->moveToThread(QCoreApplication::instance()->thread());
+
+    QObject::connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_watcher, [this](const QString &dir) {
+        onDirectoryChanged(dir);
+    });
+}
+
+PathResolver::~PathResolver() {
+    delete m_watcher;
+    m_watcher = nullptr;
+}
+
+void PathResolver::destroy() {
+    PathResolver* resolver = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s_instanceMutex);
+        resolver = _instance;
+        _instance = nullptr;
+    }
+    delete resolver;
+}
+
+PathResolver& PathResolver::instance() {
+    // Called from the slide load pool threads as well
+    std::lock_guard<std::mutex> lock(s_instanceMutex);
+    if (!_instance) {
+        _instance = new PathResolver();
+    }
+    return *_instance;
+}
+
+QString PathResolver::resolve(const QString &filePath, const QStringList &searchPaths) {
+    const QString key = filePath + QChar(u'\n') + searchPaths.join(QChar(u'\n'));
+
+    quint64 generation = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto cached = m_cache.constFind(key);
+        if (cached != m_cache.constEnd())
+            return cached.value();
+        generation = m_generation;
+    }
+
+    QStringList dependencies;
+    QString resolvedPath = probe(filePath, searchPaths, dependencies);
+    dependencies.removeDuplicates();
+
+    QStringList dirsToWatch;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Something changed while probing, the result might already be outdated
+        if (generation != m_generation)
+            return resolvedPath;
+
+        for (const QString &dir : dependencies) {
+            if (dir.isEmpty())
+                return resolvedPath;
+            if (!m_watchedDirs.contains(dir))
+                dirsToWatch.append(dir);
+        }
+
+        if (m_watchedDirs.size() + dirsToWatch.size() > MaxWatchedDirectories)
+            return resolvedPath;
+
+        for (const QString &dir : dirsToWatch) {
+            m_watchedDirs.insert(dir);
+        }
+        m_cache.insert(key, resolvedPath);
+    }
+
+    if (!dirsToWatch.isEmpty()) {
+        QMetaObject::invokeMethod(m_watcher, [this, dirsToWatch]() {
+            m_watcher->addPaths(dirsToWatch);
+        });
+    }
+
+    return resolvedPath;
+}
+
+void PathResolver::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.clear();
+    m_generation++;
+}
+
+QString PathResolver::probe(const QString &filePath, const QStringList &searchPaths, QStringList &dependencies) {
+    QStringList candidates;
+    candidates.append(filePath);
+    if (QFileInfo(filePath).isRelative()) { // Go through search list in order
+        for (int i = 0; i < searchPaths.size(); i++) {
+            candidates.append(QDir::cleanPath(searchPaths[i] + QDir::separator() + filePath));
+        }
+
+        // Maybe from network share?
+        QString sharefilePath = filePath;
+        sharefilePath.replace(QStringLiteral("file://"), QStringLiteral("\\\\"));
+        candidates.append(sharefilePath);
+    }
+
+    // Every candidate tried decides the result, so watch the closest existing
+    // directory of each, to notice when it (or a missing sub folder) appears.
+    for (const QString &candidate : candidates) {
+        QFileInfo candidateInfo(candidate);
+        dependencies.append(nearestExistingDir(candidateInfo.absolutePath()));
+        if (candidateInfo.exists())
+            return candidate;
+    }
+    return QStringLiteral("");
+}
+
+void PathResolver::onDirectoryChanged(const QString &dir) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.clear();
+    m_generation++;
+
+    // Removed directories are dropped from the watcher automatically
+    if (!QFileInfo::exists(dir))
+        m_watchedDirs.remove(dir);
+}
@@ -0,0 +1,54 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef PATHRESOLVER_H
+#define PATHRESOLVER_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <mutex>
+
+class QFileSystemWatcher;
+
+// Process-wide cache for resolving media paths against a list of search paths.
+//
+// Results (including "not found") are cached per (file path, search paths) pair.
+// The directories whose content decided each result are watched, and the whole
+// cache is invalidated as soon as anything changes in one of them.
+//
+// instance() and resolve() are thread-safe. The directory watcher lives on the application thread.
+class PathResolver {
+public:
+    PathResolver();
+    ~PathResolver();
+    static void destroy();
+    static PathResolver& instance();
+
+    // Returns filePath if it exists. A relative filePath is otherwise looked up in
+    // searchPaths in order, and lastly as a network share path.
+    // Returns an empty string if nothing was found.
+    QString resolve(const QString &filePath, const QStringList &searchPaths);
+
+    void clear();
+
+private:
+    static QString probe(const QString &filePath, const QStringList &searchPaths, QStringList &dependencies);
+    void onDirectoryChanged(const QString &dir);
+
+    std::mutex m_mutex;
+    QHash<QString, QString> m_cache;
+    QSet<QString> m_watchedDirs;
+    quint64 m_generation = 0;
+    QFileSystemWatcher* m_watcher = nullptr;
+
+    static std::mutex s_instanceMutex;
+    static PathResolver* _instance;
+};
+
+#endif // PATHRESOLVER_H
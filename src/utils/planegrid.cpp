@@ -56,8 +56,11 @@ PlaneGrid::~PlaneGrid() {
     glDeleteVertexArrays(1, &_vao);
 }
 
-void PlaneGrid::draw() {
+void PlaneGrid::draw(int instances) {
     glBindVertexArray(_vao);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    if (instances > 1)
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instances);
+    else
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glBindVertexArray(0);
 }
@@ -19,7 +19,7 @@ public:
     PlaneGrid(float width, float height);
     ~PlaneGrid();
 
-    void draw();
+    void draw(int instances = 1);
 
 private:
     unsigned int _vao = 0;
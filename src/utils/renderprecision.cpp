@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <utils/renderprecision.h>
+#include <sgct/opengl.h>
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+std::string lower(const std::string &s) {
+    std::string out = s;
+    std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return out;
+}
+
+bool contains(const std::string &s, const char *part) {
+    return s.find(part) != std::string::npos;
+}
+
+} // namespace
+
+namespace RenderPrecision {
+
+int bitDepth(const std::string &pixelFormat) {
+    std::string f = lower(pixelFormat);
+    if (f.empty())
+        return 8;
+    if (contains(f, "f16") || contains(f, "f32") || contains(f, "float"))
+        return 32;
+
+    // Endianness does not change the depth
+    if (f.size() > 2 && (f.ends_with("le") || f.ends_with("be")))
+        f.resize(f.size() - 2);
+
+    // Semi-planar formats name the subsampling first: p010, p016, p210, y210
+    if (f.size() == 4 && (f[0] == 'p' || f[0] == 'y') && std::all_of(f.begin() + 1, f.end(), [](unsigned char c) { return std::isdigit(c) != 0; }))
+        return std::stoi(f.substr(2));
+    // nv12, nv16, nv21, nv24 are 8 bit, the digits are the subsampling
+    if (f.starts_with("nv"))
+        return f == "nv20" ? 10 : 8;
+
+    size_t digits = f.size();
+    while (digits > 0 && std::isdigit(static_cast<unsigned char>(f[digits - 1])))
+        digits--;
+    if (digits == f.size())
+        return 8;
+
+    int trailing = std::stoi(f.substr(digits));
+    switch (trailing) {
+    case 9:
+    case 10:
+    case 12:
+    case 14:
+    case 16:
+        return trailing;
+    case 30: // x2rgb10 style packing, xv30
+        return 10;
+    case 36: // xv36
+        return 12;
+    case 48: // rgb48, bgr48
+    case 64: // rgba64, bgra64
+        return 16;
+    default: // rgb24, rgb565, yuv420p etc.
+        return 8;
+    }
+}
+
+bool hasAlpha(const std::string &pixelFormat) {
+    const std::string f = lower(pixelFormat);
+    for (const char *part : {"yuva", "rgba", "bgra", "argb", "abgr", "gbrap", "ya8", "ya16", "ayuv", "vuya"}) {
+        if (contains(f, part))
+            return true;
+    }
+    return false;
+}
+
+unsigned int videoInternalFormat(int mode, const std::string &pixelFormat, const std::string &transfer) {
+    switch (mode) {
+    case ForceRGBA8:
+        return GL_RGBA8;
+    case ForceRGB10A2:
+        return GL_RGB10_A2;
+    case ForceRGBA16F:
+        return GL_RGBA16F;
+    default:
+        break;
+    }
+
+    // Nothing known yet, keep the format that is always sufficient
+    if (pixelFormat.empty())
+        return GL_RGBA16F;
+
+    const std::string trc = lower(transfer);
+    const bool hdr = trc == "pq" || trc == "hlg" || trc == "linear" || trc.starts_with("v-log") || trc.starts_with("s-log");
+    const int depth = bitDepth(pixelFormat);
+    if (hdr || depth > 10)
+        return GL_RGBA16F;
+    if (depth > 8)
+        return hasAlpha(pixelFormat) ? GL_RGBA16F : GL_RGB10_A2; // RGB10_A2 has only 2 bits of alpha
+    return GL_RGBA8;
+}
+
+unsigned int pixelType(unsigned int internalFormat) {
+    switch (internalFormat) {
+    case GL_RGBA16F:
+        return GL_FLOAT;
+    case GL_RGB10_A2:
+        return GL_UNSIGNED_INT_2_10_10_10_REV;
+    default:
+        return GL_UNSIGNED_BYTE;
+    }
+}
+
+const char *name(unsigned int internalFormat) {
+    switch (internalFormat) {
+    case GL_RGBA8:
+        return "RGBA8";
+    case GL_RGB10_A2:
+        return "RGB10_A2";
+    case GL_RGBA16F:
+        return "RGBA16F";
+    default:
+        return "unknown";
+    }
+}
+
+} // namespace RenderPrecision
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef RENDERPRECISION_H
+#define RENDERPRECISION_H
+
+#include <string>
+
+// Internal format of the render targets that video is decoded into.
+//
+// RGBA16F costs 8 bytes per pixel, twice RGBA8 and RGB10_A2. That is only
+// needed for HDR, float or more than 10 bit content, or 10 bit content with
+// alpha. Everything else renders into the smaller formats without loss.
+namespace RenderPrecision {
+
+// Values of the VideoRenderPrecision playback setting
+enum Mode {
+    Auto = 0,
+    ForceRGBA8 = 1,
+    ForceRGB10A2 = 2,
+    ForceRGBA16F = 3
+};
+
+// Bits per component of an FFmpeg/mpv pixel format name, e.g. 10 for
+// "yuv420p10le" or "p010". 32 for float formats and 8 if unknown.
+int bitDepth(const std::string &pixelFormat);
+bool hasAlpha(const std::string &pixelFormat);
+
+// Internal format for video with the given pixel format and transfer
+// characteristics (mpv "gamma" names like "pq" or "hlg", empty if unknown)
+unsigned int videoInternalFormat(int mode, const std::string &pixelFormat, const std::string &transfer);
+
+// Pixel type to allocate a texture of the internal format with
+unsigned int pixelType(unsigned int internalFormat);
+
+const char *name(unsigned int internalFormat);
+
+} // namespace RenderPrecision
+
+#endif // RENDERPRECISION_H
@@ -6,21 +6,18 @@
  */
 
 #include <utils/spheregrid.h>
+#include <utils/meshlod.h>
 
 #include <sgct/opengl.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/constants.hpp>
 #include <algorithm>
+#include <map>
+#include <mutex>
+#include <utility>
 #include <vector>
 
-SphereGrid::SphereGrid(float radius, unsigned int segments) {
-    const size_t vsegs = std::max<size_t>(segments, 2);
-    const size_t hsegs = vsegs * 2;
-    const size_t nVertices = 1 + (vsegs - 1) * (hsegs + 1) + 1; // top + middle + bottom
-    _nFaces = static_cast<unsigned int>(
-        hsegs + (vsegs - 2) * hsegs * 2 + hsegs
-    ); // top + middle + bottom
-
+namespace {
     struct VertexData {
         float s = 0.f;
         float t = 0.f;  // Texcoord0 -> size=8
@@ -31,8 +28,33 @@ SphereGrid::SphereGrid(float radius, unsigned int segments) {
         float y = 0.f;
         float z = 0.f;  // size=12 ; total size=32 = power of two
     };
+}
+
+struct SphereGrid::Geometry {
+    std::vector<VertexData> verts;
+    std::vector<unsigned int> indices;
+    // Offset and count in indices for each level of detail
+    std::vector<std::pair<unsigned int, unsigned int>> levels;
+};
+
+std::shared_ptr<const SphereGrid::Geometry> SphereGrid::geometry(float radius, unsigned int segments) {
+    static std::mutex cacheMutex;
+    static std::map<std::pair<float, unsigned int>, std::weak_ptr<const Geometry>> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    const auto key = std::make_pair(radius, segments);
+    if (auto existing = cache[key].lock()) {
+        return existing;
+    }
+    std::erase_if(cache, [](const auto &entry) { return entry.second.expired(); });
 
-    std::vector<VertexData> verts(nVertices);
+    const size_t vsegs = std::max<size_t>(segments, 2);
+    const size_t hsegs = vsegs * 2;
+    const size_t nVertices = 1 + (vsegs - 1) * (hsegs + 1) + 1; // top + middle + bottom
+
+    auto geometry = std::make_shared<Geometry>();
+    std::vector<VertexData> &verts = geometry->verts;
+    verts.resize(nVertices);
 
     // First vertex: top pole (+y is "up" in object local coords)
     verts[0] = { 0.5f, 1.f, 0.f, 1.f, 0.f, 0.f, radius, 0.f };
@@ -64,34 +86,59 @@ SphereGrid::SphereGrid(float radius, unsigned int segments) {
         }
     }
 
-    std::vector<unsigned int> indices(static_cast<size_t>(_nFaces) * 3, 0);
-    // The index array: triplets of integers, one for each triangle
-    // Top cap
-    for (size_t i = 0; i < hsegs; i++) {
-        indices[3 * i] = static_cast<unsigned int>(0);
-        indices[3 * i + 2] = static_cast<unsigned int>(1 + i);
-        indices[3 * i + 1] = static_cast<unsigned int>(2 + i);
-    }
-    // Middle part (possibly empty if vsegs=2)
-    for (size_t j = 0; j < vsegs - 2; j++) {
-        for (size_t i = 0; i < hsegs; i++) {
-            const size_t base = 3 * (hsegs + 2 * (j * hsegs + i));
-            const size_t i0 = 1 + j * (hsegs + 1) + i;
-            indices[base] = static_cast<unsigned int>(i0);
-            indices[base + 1] = static_cast<unsigned int>(i0 + 1);
-            indices[base + 2] = static_cast<unsigned int>(i0 + hsegs + 1);
-            indices[base + 3] = static_cast<unsigned int>(i0 + hsegs + 1);
-            indices[base + 4] = static_cast<unsigned int>(i0 + 1);
-            indices[base + 5] = static_cast<unsigned int>(i0 + hsegs + 2);
+    // Vertex i of the ring at latitude l (1 to vsegs-1)
+    auto vertex = [hsegs](size_t l, size_t i) {
+        return static_cast<unsigned int>(1 + (l - 1) * (hsegs + 1) + i);
+    };
+    const unsigned int top = 0;
+    const unsigned int bottom = static_cast<unsigned int>(nVertices - 1);
+
+    // Every level uses every step:th ring and segment of the full grid, so all
+    // levels share the vertices. The index array: triplets of integers, one
+    // for each triangle.
+    std::vector<unsigned int> &indices = geometry->indices;
+    for (size_t step = 1; vsegs % step == 0; step *= 2) {
+        if (step > 1 && vsegs / step < 8) {
+            break;
         }
+
+        const unsigned int offset = static_cast<unsigned int>(indices.size());
+        // Top cap
+        for (size_t i = 0; i < hsegs; i += step) {
+            indices.push_back(top);
+            indices.push_back(vertex(step, i + step));
+            indices.push_back(vertex(step, i));
+        }
+        // Middle part (possibly empty if vsegs=2)
+        for (size_t l = step; l + step < vsegs; l += step) {
+            for (size_t i = 0; i < hsegs; i += step) {
+                indices.push_back(vertex(l, i));
+                indices.push_back(vertex(l, i + step));
+                indices.push_back(vertex(l + step, i));
+                indices.push_back(vertex(l + step, i));
+                indices.push_back(vertex(l, i + step));
+                indices.push_back(vertex(l + step, i + step));
+            }
+        }
+        // Bottom cap
+        for (size_t i = hsegs; i > 0; i -= step) {
+            indices.push_back(bottom);
+            indices.push_back(vertex(vsegs - step, i - step));
+            indices.push_back(vertex(vsegs - step, i));
+        }
+
+        geometry->levels.emplace_back(offset, static_cast<unsigned int>(indices.size()) - offset);
     }
-    // Bottom cap
-    for (size_t i = 0; i < static_cast<size_t>(hsegs); i++) {
-        const size_t base = 3 * (hsegs + 2 * (vsegs - 2) * hsegs);
-        indices[base + 3 * i] = static_cast<unsigned int>(nVertices - 1);
-        indices[base + 3 * i + 2] = static_cast<unsigned int>(nVertices - 2 - i);
-        indices[base + 3 * i + 1] = static_cast<unsigned int>(nVertices - 3 - i);
-    }
+
+    cache[key] = geometry;
+    return geometry;
+}
+
+SphereGrid::SphereGrid(float radius, unsigned int segments)
+    : _radius(radius)
+    , _segments(std::max(segments, 2u))
+{
+    _geometry = geometry(radius, segments);
 
     constexpr GLsizei size = sizeof(VertexData);
 
@@ -100,7 +147,7 @@ SphereGrid::SphereGrid(float radius, unsigned int segments) {
 
     glGenBuffers(1, &_vbo);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-    glBufferData(GL_ARRAY_BUFFER, nVertices * size, verts.data(), GL_STATIC_DRAW);
+    glBufferData(GL_ARRAY_BUFFER, _geometry->verts.size() * size, _geometry->verts.data(), GL_STATIC_DRAW);
 
     // texcoords
     glEnableVertexAttribArray(0);
@@ -118,8 +165,8 @@ SphereGrid::SphereGrid(float radius, unsigned int segments) {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ibo);
     glBufferData(
         GL_ELEMENT_ARRAY_BUFFER,
-        static_cast<GLsizeiptr>(_nFaces) * 3 * sizeof(unsigned int),
-        indices.data(),
+        static_cast<GLsizeiptr>(_geometry->indices.size() * sizeof(unsigned int)),
+        _geometry->indices.data(),
         GL_STATIC_DRAW
     );
 
@@ -132,8 +179,25 @@ SphereGrid::~SphereGrid() {
     glDeleteBuffers(1, &_ibo);
 }
 
-void SphereGrid::draw() {
+void SphereGrid::draw(unsigned int level) {
+    const auto &[offset, count] = _geometry->levels[std::min<size_t>(level, _geometry->levels.size() - 1)];
+
     glBindVertexArray(_vao);
-    glDrawElements(GL_TRIANGLES, _nFaces * 3, GL_UNSIGNED_INT, nullptr);
+    glDrawElements(
+        GL_TRIANGLES,
+        count,
+        GL_UNSIGNED_INT,
+        reinterpret_cast<void*>(offset * sizeof(unsigned int))
+    );
     glBindVertexArray(0);
 }
+
+unsigned int SphereGrid::levels() const {
+    return static_cast<unsigned int>(_geometry->levels.size());
+}
+
+unsigned int SphereGrid::levelFor(float distance, float projectionScale, float viewportHeight) const {
+    // Segments are 360 / (2 * segments) degrees both around and along
+    const float segmentAngle = glm::pi<float>() / static_cast<float>(_segments);
+    return meshLodLevel(_radius, segmentAngle, distance, projectionScale, viewportHeight, levels());
+}
@@ -8,15 +8,37 @@
 #ifndef __SPHEREGRID__H__
 #define __SPHEREGRID__H__
 
+#include <memory>
+
+/**
+ * Helper class to render a sphere grid, with one indexed draw per level of
+ * detail. Geometry is shared like DomeGrid.
+ */
 class SphereGrid {
 public:
     SphereGrid(float radius, unsigned int segments);
     ~SphereGrid();
 
-    void draw();
+    /**
+     * Level 0 is the full grid, each following level halves the segments.
+     */
+    void draw(unsigned int level = 0);
+
+    unsigned int levels() const;
+
+    /**
+     * Coarsest level that still looks smooth from distance (camera to sphere
+     * centre), with projectionScale = projection[1][1].
+     */
+    unsigned int levelFor(float distance, float projectionScale, float viewportHeight) const;
 
 private:
-    unsigned int _nFaces = 0;
+    struct Geometry;
+    static std::shared_ptr<const Geometry> geometry(float radius, unsigned int segments);
+
+    float _radius = 0.f;
+    unsigned int _segments = 0;
+    std::shared_ptr<const Geometry> _geometry;
 
     unsigned int _vao = 0;
     unsigned int _vbo = 0;
@@ -0,0 +1,123 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <utils/syncpayload.h>
+#include <sgct/log.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#ifdef ZSTD_SUPPORT
+#include <zstd.h>
+#endif
+
+namespace {
+
+enum Codec : uint8_t {
+    Raw = 0,
+    Zstd = 1
+};
+// Header bits besides the codec. Set on every frame from a master built with zstd.
+constexpr uint8_t MasterHasZstd = 0x80;
+constexpr uint8_t CodecMask = 0x0f;
+
+// Fastest level, the frame is compressed on the master render thread
+constexpr int ZstdLevel = 1;
+// Upper bound of a decompressed frame, guards against corrupt headers
+constexpr uint32_t MaxFrameBytes = 256 * 1024 * 1024;
+
+} // namespace
+
+namespace SyncPayload {
+
+bool compressionAvailable() {
+#ifdef ZSTD_SUPPORT
+    return true;
+#else
+    return false;
+#endif
+}
+
+void begin(std::vector<std::byte> &data) {
+    data.push_back(static_cast<std::byte>(Codec::Raw));
+}
+
+void pack(std::vector<std::byte> &data) {
+#ifdef ZSTD_SUPPORT
+    // The payload follows the reserved header byte
+    const size_t payloadSize = data.size() - 1;
+    if (payloadSize >= CompressThreshold && payloadSize <= MaxFrameBytes) {
+        const uint32_t rawSize = static_cast<uint32_t>(payloadSize);
+        const size_t headerSize = 1 + sizeof(rawSize);
+        std::vector<std::byte> packed(headerSize + ZSTD_compressBound(payloadSize));
+        size_t packedSize = ZSTD_compress(packed.data() + headerSize, packed.size() - headerSize, data.data() + 1, payloadSize, ZstdLevel);
+        // Keep the raw frame if compression failed or did not help
+        if (!ZSTD_isError(packedSize) && headerSize + packedSize < data.size()) {
+            packed[0] = static_cast<std::byte>(Codec::Zstd | MasterHasZstd);
+            std::memcpy(packed.data() + 1, &rawSize, sizeof(rawSize));
+            packed.resize(headerSize + packedSize);
+            data = std::move(packed);
+            return;
+        }
+    }
+    data[0] = static_cast<std::byte>(Codec::Raw | MasterHasZstd);
+#else
+    data[0] = static_cast<std::byte>(Codec::Raw);
+#endif
+}
+
+bool compatible(const std::vector<std::byte> &frame) {
+#ifdef ZSTD_SUPPORT
+    (void)frame;
+    return true;
+#else
+    return frame.empty() || (static_cast<uint8_t>(frame[0]) & MasterHasZstd) == 0;
+#endif
+}
+
+const std::vector<std::byte> *unpack(const std::vector<std::byte> &frame, unsigned int &pos, std::vector<std::byte> &storage) {
+    if (frame.empty()) {
+        sgct::Log::Error("Sync frame is empty");
+        return nullptr;
+    }
+
+    const uint8_t codec = static_cast<uint8_t>(frame[0]) & CodecMask;
+    if (codec == Codec::Raw) {
+        pos = 1;
+        return &frame;
+    }
+
+#ifdef ZSTD_SUPPORT
+    if (codec == Codec::Zstd) {
+        uint32_t rawSize = 0;
+        const size_t headerSize = 1 + sizeof(rawSize);
+        if (frame.size() < headerSize) {
+            sgct::Log::Error("Sync frame header is truncated");
+            return nullptr;
+        }
+        std::memcpy(&rawSize, frame.data() + 1, sizeof(rawSize));
+        if (rawSize > MaxFrameBytes) {
+            sgct::Log::Error("Sync frame size " + std::to_string(rawSize) + " is too large");
+            return nullptr;
+        }
+        storage.resize(rawSize);
+        size_t size = ZSTD_decompress(storage.data(), storage.size(), frame.data() + headerSize, frame.size() - headerSize);
+        if (ZSTD_isError(size) || size != rawSize) {
+            sgct::Log::Error(std::string("Sync frame decompression failed: ") + (ZSTD_isError(size) ? ZSTD_getErrorName(size) : "size mismatch"));
+            return nullptr;
+        }
+        pos = 0;
+        return &storage;
+    }
+#else
+    (void)storage;
+#endif
+
+    sgct::Log::Error("Sync frame has unsupported codec " + std::to_string(codec) + ", master and node builds differ");
+    return nullptr;
+}
+
+} // namespace SyncPayload
@@ -0,0 +1,45 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef SYNCPAYLOAD_H
+#define SYNCPAYLOAD_H
+
+#include <cstddef>
+#include <vector>
+
+// Framing of the sync buffer sent from master to nodes each frame.
+//
+// Every frame starts with a one byte header, holding the codec and whether the master
+// is built with BUILD_CPLAY_WITH_ZSTD. Frames of at least CompressThreshold bytes are
+// then zstd compressed, smaller frames are sent as is, as compression would cost more
+// than it saves. Nodes built without zstd see the flag on the first frame and stop.
+namespace SyncPayload {
+
+// Smallest frame worth compressing
+constexpr size_t CompressThreshold = 16 * 1024;
+// Full layer syncs larger than this are split across frames, one chunk each
+constexpr size_t ChunkBytes = 64 * 1024;
+
+bool compressionAvailable();
+
+// Reserves the frame header at the start of an empty frame
+void begin(std::vector<std::byte> &data);
+
+// Fills in the frame header reserved by begin(), and compresses the frame when above the threshold
+void pack(std::vector<std::byte> &data);
+
+// False when the master sending frame uses a codec this build can not decode
+bool compatible(const std::vector<std::byte> &frame);
+
+// Reads the frame header. Returns the buffer to deserialize from, which is
+// either frame with pos after the header, or storage holding the decompressed
+// frame with pos at 0. Returns nullptr if the frame can not be read.
+const std::vector<std::byte> *unpack(const std::vector<std::byte> &frame, unsigned int &pos, std::vector<std::byte> &storage);
+
+} // namespace SyncPayload
+
+#endif // SYNCPAYLOAD_H
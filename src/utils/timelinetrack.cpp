@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "timelinetrack.h"
+#include <glm/gtc/quaternion.hpp>
+#include <cmath>
+
+glm::vec4 timelineEasingControlPoints(TimelineEasing easing, const glm::vec4 &bezier) {
+    switch (easing) {
+    case TimelineEasing::EaseIn:
+        return glm::vec4(0.42f, 0.f, 1.f, 1.f);
+    case TimelineEasing::EaseOut:
+        return glm::vec4(0.f, 0.f, 0.58f, 1.f);
+    case TimelineEasing::EaseInOut:
+        return glm::vec4(0.42f, 0.f, 0.58f, 1.f);
+    case TimelineEasing::CubicBezier:
+        // X must stay within [0,1] for the curve to be a function of time
+        return glm::vec4(std::clamp(bezier.x, 0.f, 1.f), bezier.y, std::clamp(bezier.z, 0.f, 1.f), bezier.w);
+    default:
+        return glm::vec4(0.f, 0.f, 1.f, 1.f);
+    }
+}
+
+float timelineCubicBezier(const glm::vec4 &controlPoints, float t) {
+    if (t <= 0.f)
+        return 0.f;
+    if (t >= 1.f)
+        return 1.f;
+
+    // B(s) = 3(1-s)^2 s P1 + 3(1-s) s^2 P2 + s^3, with P0 = (0,0) and P3 = (1,1)
+    auto curve = [](float p1, float p2, float s) {
+        float u = 1.f - s;
+        return 3.f * u * u * s * p1 + 3.f * u * s * s * p2 + s * s * s;
+    };
+    auto slope = [](float p1, float p2, float s) {
+        float u = 1.f - s;
+        return 3.f * u * u * p1 + 6.f * u * s * (p2 - p1) + 3.f * s * s * (1.f - p2);
+    };
+
+    // Solve x(s) = t. Newton converges in a few steps for usual curves,
+    // bisection takes over when the slope is too flat.
+    const float x1 = controlPoints.x;
+    const float x2 = controlPoints.z;
+    float s = t;
+    for (int i = 0; i < 8; i++) {
+        float error = curve(x1, x2, s) - t;
+        if (std::abs(error) < 1e-5f)
+            return curve(controlPoints.y, controlPoints.w, s);
+        float d = slope(x1, x2, s);
+        if (std::abs(d) < 1e-6f)
+            break;
+        s -= error / d;
+    }
+
+    float lo = 0.f;
+    float hi = 1.f;
+    s = t;
+    for (int i = 0; i < 32; i++) {
+        float x = curve(x1, x2, s);
+        if (std::abs(x - t) < 1e-5f)
+            break;
+        if (x < t)
+            lo = s;
+        else
+            hi = s;
+        s = 0.5f * (lo + hi);
+    }
+    return curve(controlPoints.y, controlPoints.w, s);
+}
+
+static glm::quat eulerToQuat(const glm::vec3 &degrees) {
+    return glm::angleAxis(glm::radians(degrees.z), glm::vec3(0.f, 0.f, 1.f))
+         * glm::angleAxis(glm::radians(degrees.x), glm::vec3(1.f, 0.f, 0.f))
+         * glm::angleAxis(glm::radians(degrees.y), glm::vec3(0.f, 1.f, 0.f));
+}
+
+static float unwrapDegrees(float angle, float reference) {
+    return angle + 360.f * std::round((reference - angle) / 360.f);
+}
+
+// Euler angles (Z, X then Y) of q closest to reference, so consecutive frames
+// and the keyframes themselves do not jump between equivalent representations.
+static glm::vec3 quatToEuler(const glm::quat &q, const glm::vec3 &reference) {
+    glm::mat3 m = glm::mat3_cast(q);
+    float x = std::asin(std::clamp(m[1][2], -1.f, 1.f));
+    float y = 0.f;
+    float z = 0.f;
+    if (std::cos(x) > 1e-6f) {
+        y = std::atan2(-m[0][2], m[2][2]);
+        z = std::atan2(-m[1][0], m[1][1]);
+    }
+    else {
+        z = std::atan2(m[0][1], m[0][0]);
+    }
+
+    glm::vec3 a(glm::degrees(x), glm::degrees(y), glm::degrees(z));
+    glm::vec3 b(180.f - a.x, a.y + 180.f, a.z + 180.f);
+    for (int i = 0; i < 3; i++) {
+        a[i] = unwrapDegrees(a[i], reference[i]);
+        b[i] = unwrapDegrees(b[i], reference[i]);
+    }
+    glm::vec3 da = a - reference;
+    glm::vec3 db = b - reference;
+    return glm::dot(da, da) <= glm::dot(db, db) ? a : b;
+}
+
+glm::vec3 TimelineTrack::evaluateRotate(int timeMs) const {
+    const auto &keys = rotate.keys();
+    if (keys.empty())
+        return glm::vec3(0.f);
+
+    size_t i = 0;
+    float t = 0.f;
+    if (!rotate.locate(timeMs, i, t))
+        return keys[i].value;
+
+    const auto &a = keys[i];
+    const auto &b = keys[i + 1];
+    glm::vec3 delta = b.value - a.value;
+    // Slerp takes the short way round, keep intended spins in Euler space
+    bool spin = std::abs(delta.x) > 180.f || std::abs(delta.y) > 180.f || std::abs(delta.z) > 180.f;
+    if (a.easing == TimelineEasing::CatmullRom || spin)
+        return rotate.evaluate(timeMs);
+
+    t = TimelineChannel<glm::vec3>::eased(a, t);
+    glm::quat q = glm::slerp(eulerToQuat(a.value), eulerToQuat(b.value), t);
+    return quatToEuler(q, a.value + t * delta);
+}
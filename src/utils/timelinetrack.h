@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText:
+ * 2026 Erik Sunden <eriksunden85@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef TIMELINETRACK_H
+#define TIMELINETRACK_H
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Easing of the segment that starts at a keyframe
+enum class TimelineEasing : uint8_t {
+    Linear = 0,
+    EaseIn,
+    EaseOut,
+    EaseInOut,
+    CubicBezier, // Custom control points, same as CSS cubic-bezier(x1, y1, x2, y2)
+    CatmullRom   // Spline through the neighbouring keyframes
+};
+
+// Control points (x1, y1, x2, y2) of the presets, or bezier for CubicBezier
+glm::vec4 timelineEasingControlPoints(TimelineEasing easing, const glm::vec4 &bezier);
+// Eased progress [0,1] of a cubic Bézier timing curve at t [0,1]
+float timelineCubicBezier(const glm::vec4 &controlPoints, float t);
+
+template <typename T>
+T timelineCatmullRom(const T &p0, const T &p1, const T &p2, const T &p3, float t) {
+    float t2 = t * t;
+    float t3 = t2 * t;
+    return 0.5f * ((2.f * p1)
+                   + (p2 - p0) * t
+                   + (2.f * p0 - 5.f * p1 + 4.f * p2 - p3) * t2
+                   + (3.f * p1 - p0 - 3.f * p2 + p3) * t3);
+}
+
+/**
+ * One animated channel of a layer timeline: keyframes sorted by time in a
+ * contiguous array. The segment used by the last lookup is cached, so playing
+ * forwards or backwards finds the next segment in amortized O(1). Seeking
+ * falls back to a binary search.
+ */
+template <typename T>
+class TimelineChannel {
+public:
+    struct Key {
+        int timeMs = 0;
+        T value = T();
+        // Easing towards the next key. Presets are stored as CubicBezier.
+        TimelineEasing easing = TimelineEasing::Linear;
+        glm::vec4 bezier = glm::vec4(0.f, 0.f, 1.f, 1.f);
+    };
+
+    void clear() {
+        m_keys.clear();
+        m_cursor = 0;
+    }
+
+    // Keys must be appended in time order (equal times keep their order)
+    void append(int timeMs, const T &value,
+                TimelineEasing easing = TimelineEasing::Linear,
+                const glm::vec4 &bezier = glm::vec4(0.f, 0.f, 1.f, 1.f)) {
+        Key key;
+        key.timeMs = timeMs;
+        key.value = value;
+        key.easing = easing;
+        if (easing != TimelineEasing::Linear && easing != TimelineEasing::CatmullRom) {
+            key.easing = TimelineEasing::CubicBezier;
+            key.bezier = timelineEasingControlPoints(easing, bezier);
+        }
+        m_keys.push_back(key);
+    }
+
+    bool empty() const {
+        return m_keys.empty();
+    }
+
+    const std::vector<Key> &keys() const {
+        return m_keys;
+    }
+
+    // Finds the segment [keys[index], keys[index+1]] at timeMs and the linear
+    // progress t within it. Returns false outside the keys, with index set to
+    // the first or last key.
+    bool locate(int timeMs, size_t &index, float &t) const {
+        if (m_keys.empty() || timeMs <= m_keys.front().timeMs) {
+            index = 0;
+            return false;
+        }
+        if (timeMs >= m_keys.back().timeMs) {
+            index = m_keys.size() - 1;
+            return false;
+        }
+        index = segmentAt(timeMs);
+        const Key &a = m_keys[index];
+        const Key &b = m_keys[index + 1];
+        t = static_cast<float>(timeMs - a.timeMs) / static_cast<float>(b.timeMs - a.timeMs);
+        return true;
+    }
+
+    static float eased(const Key &from, float t) {
+        if (from.easing == TimelineEasing::CubicBezier)
+            return timelineCubicBezier(from.bezier, t);
+        return t;
+    }
+
+    T evaluate(int timeMs) const {
+        if (m_keys.empty())
+            return T();
+
+        size_t i = 0;
+        float t = 0.f;
+        if (!locate(timeMs, i, t))
+            return m_keys[i].value;
+
+        const Key &a = m_keys[i];
+        const Key &b = m_keys[i + 1];
+        if (a.easing == TimelineEasing::CatmullRom) {
+            const T &p0 = m_keys[i > 0 ? i - 1 : i].value;
+            const T &p3 = m_keys[i + 2 < m_keys.size() ? i + 2 : i + 1].value;
+            return timelineCatmullRom(p0, a.value, b.value, p3, t);
+        }
+        t = eased(a, t);
+        return a.value + t * (b.value - a.value);
+    }
+
+private:
+    // Index i of the segment with keys[i].timeMs < timeMs <= keys[i+1].timeMs.
+    // Only called with front().timeMs < timeMs < back().timeMs.
+    size_t segmentAt(int timeMs) const {
+        size_t last = m_keys.size() - 1;
+        auto contains = [this, timeMs](size_t i) {
+            return m_keys[i].timeMs < timeMs && timeMs <= m_keys[i + 1].timeMs;
+        };
+        if (m_cursor < last) {
+            if (contains(m_cursor))
+                return m_cursor;
+            // Neighbouring segments, i.e. the next or previous tick during playback
+            if (m_cursor + 1 < last && contains(m_cursor + 1))
+                return ++m_cursor;
+            if (m_cursor > 0 && contains(m_cursor - 1))
+                return --m_cursor;
+        }
+        auto it = std::lower_bound(m_keys.begin(), m_keys.end(), timeMs, [](const Key &k, int t) {
+            return k.timeMs < t;
+        });
+        m_cursor = static_cast<size_t>(std::distance(m_keys.begin(), it)) - 1;
+        return m_cursor;
+    }
+
+    std::vector<Key> m_keys;
+    mutable size_t m_cursor = 0;
+};
+
+/**
+ * Compiled timeline of a single layer, built from its keyframes whenever they
+ * are edited. Rotation and translation only contain the keyframes that have
+ * those channels enabled.
+ */
+class TimelineTrack {
+public:
+    TimelineChannel<float> alpha;
+    TimelineChannel<glm::vec3> rotate;
+    TimelineChannel<glm::vec3> translate;
+
+    void clear() {
+        alpha.clear();
+        rotate.clear();
+        translate.clear();
+    }
+
+    bool empty() const {
+        return alpha.empty() && rotate.empty() && translate.empty();
+    }
+
+    // Rotation in degrees (X/Y/Z, applied as Z, X then Y like the renderer).
+    // Segments are interpolated with quaternion slerp, except Catmull-Rom
+    // segments and spins of more than half a turn on an axis.
+    glm::vec3 evaluateRotate(int timeMs) const;
+};
+
+/**
+ * Maps the cluster clock to a timeline position while a timeline plays.
+ * Set on the master when playback starts or stops and synced with the layer,
+ * so nodes can evaluate the track every frame against the synced clock.
+ */
+struct TimelinePlayback {
+    int64_t anchorClockMs = 0;
+    int anchorPosMs = 0;
+    int rate = 1; // 1 forward, -1 reverse
+    int minPosMs = 0;
+    int maxPosMs = 0;
+    float alphaScale = 1.f;
+
+    // Clock sampled on the master, and synced to nodes every frame
+    static int64_t clockMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int positionAt(int64_t clock) const {
+        int64_t elapsed = std::max<int64_t>(0, clock - anchorClockMs);
+        int64_t pos = anchorPosMs + rate * elapsed;
+        return static_cast<int>(std::clamp<int64_t>(pos, minPosMs, maxPosMs));
+    }
+
+    bool operator==(const TimelinePlayback &other) const = default;
+};
+
+#endif // TIMELINETRACK_H
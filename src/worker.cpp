@@ -12,12 +12,68 @@
 
 #include <KFileMetaData/ExtractorCollection>
 #include <KFileMetaData/SimpleExtractionResult>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QMimeDatabase>
+#include <QSaveFile>
+#include <QStandardPaths>
 #include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 #include <QUrl>
+#include <algorithm>
+
+// Files per pool task, so a large playlist is split over all pool threads
+static constexpr int ExtractBatchSize = 16;
+// Oldest entries (by last use) are dropped from the index above this
+static constexpr int MaxIndexEntries = 20000;
+static constexpr quint32 IndexMagic = 0x43504d49; // "CPMI"
+static constexpr quint32 IndexVersion = 1;
+
+// Loading the extractor plugins is expensive, so each pool thread keeps its
+// own collection for as long as the pool lives.
+static KFileMetaData::ExtractorCollection &extractorCollection() {
+    thread_local KFileMetaData::ExtractorCollection collection;
+    return collection;
+}
+
+static bool extractMetaData(const QString &filePath, KFileMetaData::PropertyMultiMap &properties) {
+    QString mimeType = Application::mimeType(QUrl::fromLocalFile(filePath));
+    QList<KFileMetaData::Extractor *> extractors = extractorCollection().fetchExtractors(mimeType);
+    if (extractors.isEmpty() || !extractors.first()) {
+        return false;
+    }
+    KFileMetaData::SimpleExtractionResult result(filePath, mimeType, KFileMetaData::ExtractionResult::ExtractMetaData);
+    extractors.first()->extract(&result);
+    properties = result.properties();
+    return true;
+}
 
 Worker *Worker::sm_worker = nullptr;
 
+Worker::Worker() {
+    m_pool = new QThreadPool(this);
+    m_pool->setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+    // Keep the threads (and their extractor collections) alive between playlists
+    m_pool->setExpiryTimeout(-1);
+
+    m_saveTimer = new QTimer(this);
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(2000);
+    connect(m_saveTimer, &QTimer::timeout, this, &Worker::saveIndex);
+
+    m_indexPath = QStandardPaths::writableLocation(QStandardPaths::CacheLocation)
+                      .append(QStringLiteral("/metadata.index"));
+}
+
+Worker::~Worker() {
+    m_pool->waitForDone();
+    saveIndex();
+}
+
 Worker *Worker::instance() {
     if (!sm_worker) {
         sm_worker = new Worker();
@@ -37,17 +93,177 @@ void Worker::getMetaData(int index, const QString &path) {
     if (url.scheme() != QStringLiteral("file")) {
         return;
     }
-    QString mimeType = Application::mimeType(url);
-    KFileMetaData::ExtractorCollection exCol;
-    QList<KFileMetaData::Extractor *> extractors = exCol.fetchExtractors(mimeType);
-    KFileMetaData::SimpleExtractionResult result(url.toLocalFile(), mimeType, KFileMetaData::ExtractionResult::ExtractMetaData);
-    if (extractors.isEmpty() || !extractors.first()) {
+
+    Request request;
+    request.index = index;
+    request.filePath = url.toLocalFile();
+    QFileInfo fileInfo(request.filePath);
+    if (!fileInfo.exists()) {
+        return;
+    }
+    request.size = fileInfo.size();
+    request.modified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    loadIndex();
+
+    bool found = false;
+    bool extracted = false;
+    KFileMetaData::PropertyMultiMap properties;
+    {
+        QMutexLocker locker(&m_indexMutex);
+        auto it = m_index.find(request.filePath);
+        if (it != m_index.end() && it->size == request.size && it->modified == request.modified) {
+            // lastUsed decides which entries are dropped when the index is full
+            it->lastUsed = QDateTime::currentSecsSinceEpoch();
+            m_indexDirty = true;
+            found = true;
+            extracted = it->extracted;
+            properties = it->properties;
+        }
+    }
+
+    if (found) {
+        if (extracted) {
+            Q_EMIT metaDataReady(index, properties);
+        }
+        scheduleSave();
+        return;
+    }
+
+    // Collect the requests of this event loop pass, e.g. a whole playlist
+    // being opened, and extract them together.
+    m_pending.append(request);
+    if (!m_extractScheduled) {
+        m_extractScheduled = true;
+        QMetaObject::invokeMethod(this, &Worker::extractPending, Qt::QueuedConnection);
+    }
+}
+
+void Worker::extractPending() {
+    m_extractScheduled = false;
+    QList<Request> pending;
+    pending.swap(m_pending);
+
+    for (qsizetype i = 0; i < pending.size(); i += ExtractBatchSize) {
+        QList<Request> batch = pending.mid(i, ExtractBatchSize);
+        m_pool->start([this, batch]() {
+            for (const Request &request : batch) {
+                IndexEntry entry;
+                entry.size = request.size;
+                entry.modified = request.modified;
+                entry.lastUsed = QDateTime::currentSecsSinceEpoch();
+                entry.extracted = extractMetaData(request.filePath, entry.properties);
+
+                if (entry.extracted) {
+                    Q_EMIT metaDataReady(request.index, entry.properties);
+                }
+
+                QMutexLocker locker(&m_indexMutex);
+                m_index.insert(request.filePath, entry);
+                m_indexDirty = true;
+            }
+            QMetaObject::invokeMethod(this, &Worker::scheduleSave, Qt::QueuedConnection);
+        });
+    }
+}
+
+void Worker::scheduleSave() {
+    m_saveTimer->start();
+}
+
+void Worker::loadIndex() {
+    if (m_indexLoaded) {
         return;
     }
-    KFileMetaData::Extractor *ex = extractors.first();
-    ex->extract(&result);
+    m_indexLoaded = true;
 
-    auto properties = result.properties();
+    QFile file(m_indexPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != IndexMagic || version != IndexVersion) {
+        return;
+    }
+    in.setVersion(QDataStream::Qt_6_0);
+
+    qint32 count = 0;
+    in >> count;
+    // The index is saved with at most MaxIndexEntries, anything else is corrupt
+    if (in.status() != QDataStream::Ok || count < 0 || count > MaxIndexEntries) {
+        qWarning() << "Ignoring corrupt metadata index" << m_indexPath;
+        return;
+    }
+    QHash<QString, IndexEntry> index;
+    index.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+        QString filePath;
+        IndexEntry entry;
+        qint32 numProperties = 0;
+        in >> filePath >> entry.size >> entry.modified >> entry.lastUsed >> entry.extracted >> numProperties;
+        for (qint32 p = 0; p < numProperties && in.status() == QDataStream::Ok; p++) {
+            qint32 property = 0;
+            QVariant value;
+            in >> property >> value;
+            entry.properties.insert(static_cast<KFileMetaData::Property::Property>(property), value);
+        }
+        index.insert(filePath, entry);
+    }
 
-    Q_EMIT metaDataReady(index, properties);
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << "Ignoring corrupt metadata index" << m_indexPath;
+        return;
+    }
+
+    QMutexLocker locker(&m_indexMutex);
+    m_index = std::move(index);
+}
+
+void Worker::saveIndex() {
+    QHash<QString, IndexEntry> index;
+    {
+        QMutexLocker locker(&m_indexMutex);
+        if (!m_indexDirty) {
+            return;
+        }
+        m_indexDirty = false;
+        index = m_index;
+    }
+
+    QList<QHash<QString, IndexEntry>::const_iterator> entries;
+    entries.reserve(index.size());
+    for (auto it = index.cbegin(); it != index.cend(); ++it) {
+        entries.append(it);
+    }
+    if (entries.size() > MaxIndexEntries) {
+        std::nth_element(entries.begin(), entries.begin() + MaxIndexEntries, entries.end(), [](const auto &a, const auto &b) {
+            return a->lastUsed > b->lastUsed;
+        });
+        entries.resize(MaxIndexEntries);
+    }
+
+    QDir().mkpath(QFileInfo(m_indexPath).absolutePath());
+    QSaveFile file(m_indexPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Could not write metadata index" << m_indexPath;
+        return;
+    }
+
+    QDataStream out(&file);
+    out << IndexMagic << IndexVersion;
+    out.setVersion(QDataStream::Qt_6_0);
+    out << static_cast<qint32>(entries.size());
+    for (const auto &it : entries) {
+        const IndexEntry &entry = it.value();
+        out << it.key() << entry.size << entry.modified << entry.lastUsed << entry.extracted
+            << static_cast<qint32>(entry.properties.size());
+        for (auto p = entry.properties.cbegin(); p != entry.properties.cend(); ++p) {
+            out << static_cast<qint32>(p.key()) << p.value();
+        }
+    }
+    file.commit();
 }
@@ -10,24 +10,62 @@
 #define WORKER_H
 
 #include <KFileMetaData/Properties>
+#include <QHash>
+#include <QMutex>
 #include <QObject>
 
+class QThreadPool;
+class QTimer;
+
 class Worker : public QObject {
     Q_OBJECT
 public:
-    Worker() = default;
-    ~Worker() = default;
+    Worker();
+    ~Worker();
 
     static Worker *instance();
     static void destroy();
 
+    // Served from the metadata index when the file is unchanged (same size and
+    // modification time), otherwise extracted in batches on a thread pool.
     Q_INVOKABLE void getMetaData(int index, const QString &path);
 
 Q_SIGNALS:
     void metaDataReady(int index, KFileMetaData::PropertyMultiMap metadata);
 
 private:
+    struct IndexEntry {
+        qint64 size = 0;
+        qint64 modified = 0;
+        qint64 lastUsed = 0;
+        bool extracted = false;
+        KFileMetaData::PropertyMultiMap properties;
+    };
+
+    struct Request {
+        int index = -1;
+        QString filePath;
+        qint64 size = 0;
+        qint64 modified = 0;
+    };
+
+    void extractPending();
+    void loadIndex();
+    void saveIndex();
+    void scheduleSave();
+
     static Worker *sm_worker;
+
+    QThreadPool *m_pool = nullptr;
+    QTimer *m_saveTimer = nullptr;
+    QList<Request> m_pending;
+    bool m_extractScheduled = false;
+
+    QString m_indexPath;
+    QMutex m_indexMutex;
+    QHash<QString, IndexEntry> m_index;
+    bool m_indexLoaded = false;
+    bool m_indexDirty = false;
 };
 
 #endif // WORKER_H
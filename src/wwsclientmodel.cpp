@@ -6,6 +6,7 @@
  */
 
 #include "wwsclientmodel.h"
+#include "restclientpool.h"
 
 #include <QAbstractSocket>
 #include <QEventLoop>
@@ -13,12 +14,14 @@
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QPointer>
 #include <QRandomGenerator>
 #include <QCryptographicHash>
 #include <QTimer>
 #include <QUrl>
 #include <QWebSocket>
 #include <QWebSocketHandshakeOptions>
+#include <functional>
 
 namespace {
 
@@ -223,35 +226,14 @@ QStringList obsOptionsFromResponse(int optionType, const QJsonObject &responseDa
     return options;
 }
 
-} // namespace
-
-WwsRequestWorker::WwsRequestWorker(QObject *parent)
-    : QObject(parent) {
-}
-
-void WwsRequestWorker::doRequest(const QString &url, const QString &parameters, bool ignoreStatus) {
-    if (url.isEmpty()) {
-        Q_EMIT requestFinished(0, QString(), QStringLiteral("Empty URL"));
-        return;
-    }
-
-    QUrl webSocketUrl(normalizedWebSocketUrl(url));
-    if (!webSocketUrl.isValid() || (webSocketUrl.scheme() != QStringLiteral("ws") && webSocketUrl.scheme() != QStringLiteral("wss"))) {
-        Q_EMIT requestFinished(0, QString(), QStringLiteral("Invalid WebSocket URL. Use ws:// or wss://."));
-        return;
-    }
-
-    WebSocketCommand command = parseCommand(parameters);
-    const bool obsCandidate = command.rawObsMessage || command.obsRequest || !command.password.isEmpty() || webSocketUrl.port() == 4455;
-
+// One connection per request, used for raw OBS messages which take over the whole protocol
+void singleShotRequest(const QUrl &webSocketUrl, const WebSocketCommand &command, bool obsCandidate, bool ignoreStatus,
+                       int &statusCode, QString &responseBody, QString &error) {
     QWebSocket socket;
     QEventLoop eventLoop;
     QTimer timeoutTimer;
     timeoutTimer.setSingleShot(true);
 
-    int statusCode = 0;
-    QString responseBody;
-    QString error;
     bool finished = false;
     bool opened = false;
     bool obsMode = false;
@@ -393,10 +375,261 @@ void WwsRequestWorker::doRequest(const QString &url, const QString &parameters,
         socket.open(webSocketUrl);
     }
     eventLoop.exec();
+}
+
+} // namespace
+
+WwsRequestWorker::WwsRequestWorker(QObject *parent)
+    : QObject(parent) {
+}
+
+// A WebSocket connection kept open between requests. OBS sessions are identified
+// (and authenticated) once, after which requests are sent right away.
+struct WwsRequestWorker::Session {
+    QWebSocket socket;
+    bool obsMode = false;
+    bool identified = false;
+    std::function<void(const QString &)> messageHandler;
+};
+
+WwsRequestWorker::~WwsRequestWorker() {
+    qDeleteAll(m_sessions);
+}
+
+void WwsRequestWorker::doRequest(const QString &url, const QString &parameters, bool ignoreStatus) {
+    // Waiting for a response runs a local event loop, which may deliver the next queued
+    // request. Handle requests one at a time and in order, so results match their requests.
+    m_pendingRequests.append({url, parameters, ignoreStatus});
+    if (m_processingRequests) {
+        return;
+    }
+    m_processingRequests = true;
+    while (!m_pendingRequests.isEmpty()) {
+        PendingRequest request = m_pendingRequests.takeFirst();
+        processRequest(request.url, request.parameters, request.ignoreStatus);
+    }
+    m_processingRequests = false;
+}
+
+void WwsRequestWorker::processRequest(const QString &url, const QString &parameters, bool ignoreStatus) {
+    if (url.isEmpty()) {
+        Q_EMIT requestFinished(0, QString(), QStringLiteral("Empty URL"));
+        return;
+    }
+
+    QUrl webSocketUrl(normalizedWebSocketUrl(url));
+    if (!webSocketUrl.isValid() || (webSocketUrl.scheme() != QStringLiteral("ws") && webSocketUrl.scheme() != QStringLiteral("wss"))) {
+        Q_EMIT requestFinished(0, QString(), QStringLiteral("Invalid WebSocket URL. Use ws:// or wss://."));
+        return;
+    }
+
+    WebSocketCommand command = parseCommand(parameters);
+    const bool obsCandidate = command.rawObsMessage || command.obsRequest || !command.password.isEmpty() || webSocketUrl.port() == 4455;
+
+    int statusCode = 0;
+    QString responseBody;
+    QString error;
+
+    if (command.rawObsMessage) {
+        singleShotRequest(webSocketUrl, command, obsCandidate, ignoreStatus, statusCode, responseBody, error);
+        Q_EMIT requestFinished(statusCode, responseBody, error);
+        return;
+    }
+
+    Session *session = openSession(webSocketUrl, obsCandidate, command.password, command.eventSubscriptions, error);
+    if (!session) {
+        Q_EMIT requestFinished(0, QString(), error);
+        return;
+    }
+
+    QString message;
+    QString obsRequestId;
+    if (session->obsMode) {
+        if (!command.obsRequest) {
+            Q_EMIT requestFinished(200, QString(), QString());
+            return;
+        }
+        if (command.requestType.isEmpty()) {
+            Q_EMIT requestFinished(0, QString(), QStringLiteral("OBS requestType parameter is empty."));
+            return;
+        }
+        obsRequestId = requestId();
+        QJsonObject request;
+        request.insert(QStringLiteral("requestId"), obsRequestId);
+        request.insert(QStringLiteral("requestType"), command.requestType);
+        request.insert(QStringLiteral("requestData"), command.requestData);
+        message = compactJson(obsMessage(ObsOpRequest, request));
+    }
+    else {
+        message = command.genericMessage;
+        if (message.isEmpty()) {
+            Q_EMIT requestFinished(200, QString(), QString());
+            return;
+        }
+    }
+
+    if (ignoreStatus) {
+        session->socket.sendTextMessage(message);
+        Q_EMIT requestFinished(200, QString(), QString());
+        return;
+    }
+
+    QEventLoop eventLoop;
+    QTimer timeoutTimer;
+    timeoutTimer.setSingleShot(true);
+    bool finished = false;
+
+    auto finish = [&](int code, const QString &response, const QString &errorMessage) {
+        if (finished) {
+            return;
+        }
+        finished = true;
+        statusCode = code;
+        responseBody = response;
+        error = errorMessage;
+        eventLoop.quit();
+    };
+
+    session->messageHandler = [&](const QString &response) {
+        if (!session->obsMode) {
+            finish(200, response, QString());
+            return;
+        }
+        QJsonObject msg = QJsonDocument::fromJson(response.toUtf8()).object();
+        const QJsonObject data = msg.value(QStringLiteral("d")).toObject();
+        // Skip events and responses to other requests
+        if (msg.value(QStringLiteral("op")).toInt(-1) != ObsOpRequestResponse
+            || data.value(QStringLiteral("requestId")).toString() != obsRequestId) {
+            return;
+        }
+        QJsonObject requestStatus = data.value(QStringLiteral("requestStatus")).toObject();
+        if (!requestStatus.value(QStringLiteral("result")).toBool()) {
+            finish(0, response, requestStatus.value(QStringLiteral("comment")).toString(QStringLiteral("OBS request failed")));
+            return;
+        }
+        finish(200, response, QString());
+    };
+    QObject::connect(&timeoutTimer, &QTimer::timeout, &eventLoop, [&]() {
+        finish(0, QString(), QStringLiteral("WebSocket request timed out"));
+    });
+    QObject::connect(&session->socket, &QWebSocket::disconnected, &eventLoop, [&]() {
+        finish(0, QString(), QStringLiteral("WebSocket disconnected before receiving a response"));
+    });
+
+    timeoutTimer.start(5000);
+    session->socket.sendTextMessage(message);
+    eventLoop.exec();
+    session->messageHandler = nullptr;
 
     Q_EMIT requestFinished(statusCode, responseBody, error);
 }
 
+WwsRequestWorker::Session *WwsRequestWorker::openSession(const QUrl &url, bool obsCandidate, const QString &password, int eventSubscriptions, QString &error) {
+    const QString key = url.toString() + QLatin1Char('\n') + password + QLatin1Char('\n') + QString::number(eventSubscriptions);
+    Session *session = m_sessions.value(key, nullptr);
+    if (session) {
+        if (session->socket.state() == QAbstractSocket::ConnectedState) {
+            return session;
+        }
+        // Dropped by the server since last time, connect again
+        m_sessions.remove(key);
+        delete session;
+    }
+
+    session = new Session();
+    QObject::connect(&session->socket, &QWebSocket::textMessageReceived, this, [session](const QString &message) {
+        if (session->messageHandler) {
+            session->messageHandler(message);
+        }
+    });
+    QObject::connect(&session->socket, &QWebSocket::binaryMessageReceived, this, [session](const QByteArray &message) {
+        if (session->messageHandler) {
+            session->messageHandler(QString::fromUtf8(message));
+        }
+    });
+
+    QEventLoop eventLoop;
+    QTimer timeoutTimer;
+    timeoutTimer.setSingleShot(true);
+    bool finished = false;
+    bool opened = false;
+
+    auto finish = [&](const QString &errorMessage) {
+        if (finished) {
+            return;
+        }
+        finished = true;
+        error = errorMessage;
+        eventLoop.quit();
+    };
+
+    session->messageHandler = [&](const QString &message) {
+        QJsonObject msg = QJsonDocument::fromJson(message.toUtf8()).object();
+        const int op = msg.value(QStringLiteral("op")).toInt(-1);
+        const QJsonObject data = msg.value(QStringLiteral("d")).toObject();
+        if (op == ObsOpHello) {
+            QJsonObject identify;
+            identify.insert(QStringLiteral("rpcVersion"), data.value(QStringLiteral("rpcVersion")).toInt(1));
+            identify.insert(QStringLiteral("eventSubscriptions"), eventSubscriptions);
+
+            QJsonObject authentication = data.value(QStringLiteral("authentication")).toObject();
+            if (!authentication.isEmpty()) {
+                if (password.isEmpty()) {
+                    finish(QStringLiteral("OBS WebSocket authentication required. Add a password parameter."));
+                    return;
+                }
+                identify.insert(QStringLiteral("authentication"), obsAuthentication(
+                    authentication.value(QStringLiteral("salt")).toString(),
+                    authentication.value(QStringLiteral("challenge")).toString(),
+                    password));
+            }
+
+            session->socket.sendTextMessage(compactJson(obsMessage(ObsOpIdentify, identify)));
+        }
+        else if (op == ObsOpIdentified) {
+            session->identified = true;
+            finish(QString());
+        }
+    };
+    QObject::connect(&timeoutTimer, &QTimer::timeout, &eventLoop, [&]() {
+        finish(QStringLiteral("WebSocket connection timed out"));
+    });
+    QObject::connect(&session->socket, &QWebSocket::connected, &eventLoop, [&]() {
+        opened = true;
+        session->obsMode = session->socket.subprotocol() == QStringLiteral("obswebsocket.json");
+        if (!session->obsMode) {
+            finish(QString());
+        }
+    });
+    QObject::connect(&session->socket, &QWebSocket::errorOccurred, &eventLoop, [&](QAbstractSocket::SocketError) {
+        finish(session->socket.errorString());
+    });
+    QObject::connect(&session->socket, &QWebSocket::disconnected, &eventLoop, [&]() {
+        finish(opened && obsCandidate && !session->obsMode
+            ? QStringLiteral("WebSocket disconnected before OBS protocol negotiation. OBS requires the obswebsocket.json subprotocol.")
+            : QStringLiteral("WebSocket disconnected while connecting"));
+    });
+
+    timeoutTimer.start(5000);
+    if (obsCandidate) {
+        QWebSocketHandshakeOptions handshakeOptions;
+        handshakeOptions.setSubprotocols({QStringLiteral("obswebsocket.json")});
+        session->socket.open(url, handshakeOptions);
+    } else {
+        session->socket.open(url);
+    }
+    eventLoop.exec();
+    session->messageHandler = nullptr;
+
+    if (!error.isEmpty()) {
+        delete session;
+        return nullptr;
+    }
+
+    m_sessions.insert(key, session);
+    return session;
+}
+
 void WwsRequestWorker::fetchObsOptions(const QString &url, int optionType) {
     if (url.isEmpty()) {
         Q_EMIT obsOptionsFinished(optionType, QStringList(), QStringLiteral("Empty URL"));
@@ -507,9 +740,7 @@ WwsClientModel::WwsClientModel(QObject *parent)
     m_worker->moveToThread(&m_workerThread);
 
     connect(&m_workerThread, &QThread::finished, m_worker, &QObject::deleteLater);
-    connect(this, &WwsClientModel::startRequest, m_worker, &WwsRequestWorker::doRequest);
     connect(this, &WwsClientModel::startObsOptionsRequest, m_worker, &WwsRequestWorker::fetchObsOptions);
-    connect(m_worker, &WwsRequestWorker::requestFinished, this, &WwsClientModel::onRequestFinished);
     connect(m_worker, &WwsRequestWorker::obsOptionsFinished, this, &WwsClientModel::onObsOptionsFinished);
 
     m_workerThread.start();
@@ -523,7 +754,12 @@ WwsClientModel::~WwsClientModel() {
 void WwsClientModel::sendRequest(const QString &url, const QString &parameters, bool ignoreStatus) {
     m_requestInProgress = true;
     Q_EMIT requestInProgressChanged();
-    Q_EMIT startRequest(url, parameters, ignoreStatus);
+    QPointer<WwsClientModel> model(this);
+    RestClientPool::instance().sendWebSocketRequest(url, parameters, ignoreStatus,
+        [model](int statusCode, const QString &responseBody, const QString &error) {
+            if (model)
+                model->onRequestFinished(statusCode, responseBody, error);
+        });
 }
 
 void WwsClientModel::updateObsOptions(const QString &url, int optionType) {
@@ -8,9 +8,12 @@
 #ifndef WWSCLIENTMODEL_H
 #define WWSCLIENTMODEL_H
 
+#include <QHash>
+#include <QList>
 #include <QObject>
 #include <QStringList>
 #include <QThread>
+#include <QUrl>
 #include <QtQml/qqmlregistration.h>
 
 class WwsRequestWorker : public QObject {
@@ -18,6 +21,7 @@ class WwsRequestWorker : public QObject {
 
 public:
     explicit WwsRequestWorker(QObject *parent = nullptr);
+    ~WwsRequestWorker();
 
 public Q_SLOTS:
     void doRequest(const QString &url, const QString &parameters, bool ignoreStatus);
@@ -26,6 +30,22 @@ public Q_SLOTS:
 Q_SIGNALS:
     void requestFinished(int statusCode, const QString &responseBody, const QString &error);
     void obsOptionsFinished(int optionType, const QStringList &options, const QString &error);
+
+private:
+    struct Session;
+    struct PendingRequest {
+        QString url;
+        QString parameters;
+        bool ignoreStatus;
+    };
+
+    void processRequest(const QString &url, const QString &parameters, bool ignoreStatus);
+    // Connected (and for OBS identified) session per URL and credentials, kept between requests
+    Session *openSession(const QUrl &url, bool obsCandidate, const QString &password, int eventSubscriptions, QString &error);
+
+    QHash<QString, Session *> m_sessions;
+    QList<PendingRequest> m_pendingRequests;
+    bool m_processingRequests = false;
 };
 
 class WwsClientModel : public QObject {
@@ -68,7 +88,6 @@ Q_SIGNALS:
     void requestInProgressChanged();
     void obsOptionsChanged();
     void obsOptionsInProgressChanged();
-    void startRequest(const QString &url, const QString &parameters, bool ignoreStatus);
     void startObsOptionsRequest(const QString &url, int optionType);
 
 private Q_SLOTS:
@@ -85,6 +104,7 @@ private:
     bool m_obsOptionsInProgress = false;
     int m_obsOptionsType = -1;
 
+    // Only used to fetch OBS options, requests go through RestClientPool
     QThread m_workerThread;
     WwsRequestWorker *m_worker = nullptr;
 };